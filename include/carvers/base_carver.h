@@ -15,7 +15,40 @@ public:
     BaseCarver() = default;
     virtual ~BaseCarver() = default;
     
+    /**
+     * @brief Carve files by searching for the carver's own signatures
+     *
+     * Finds every getFileSignatures() and getFileFooters() pattern and
+     * hands the offsets to carveFilesAt().
+     */
+    std::vector<RecoveredFile> carveFiles(
+        const Byte* data, 
+        Size size, 
+        Offset base_offset
+    ) override;
+    
+    /**
+     * @brief Carve files at already located signatures and footers
+     *
+     * Derived carvers must implement this; the FileCarver default would
+     * recurse through carveFiles().
+     */
+    std::vector<RecoveredFile> carveFilesAt(
+        const Byte* data,
+        Size size,
+        Offset base_offset,
+        const SignatureHits& hits
+    ) override = 0;
+    
 protected:
+    /**
+     * @brief Find where the carver's signatures start and its footers end
+     * @param data Data to search in
+     * @param size Size of the data
+     * @return Offsets in ascending order, each once
+     */
+    SignatureHits findSignatures(const Byte* data, Size size) const;
+    
     /**
      * @brief Find all occurrences of a pattern in data
      * @param data Data to search in
@@ -19,10 +19,11 @@ public:
     std::vector<std::vector<Byte>> getFileSignatures() const override;
     std::vector<std::vector<Byte>> getFileFooters() const override;
     
-    std::vector<RecoveredFile> carveFiles(
-        const Byte* data, 
-        Size size, 
-        Offset base_offset
+    std::vector<RecoveredFile> carveFilesAt(
+        const Byte* data,
+        Size size,
+        Offset base_offset,
+        const SignatureHits& hits
     ) override;
     
     double validateFile(const RecoveredFile& file, const Byte* data) override;
@@ -34,9 +35,11 @@ private:
      * @param data Data to search in
      * @param size Size of the data
      * @param start_offset Offset where JPEG starts
+     * @param footer_ends Where end markers in data end, ascending
      * @return Size of the JPEG file, or 0 if not found
      */
-    Size findJpegEnd(const Byte* data, Size size, Offset start_offset) const;
+    Size findJpegEnd(const Byte* data, Size size, Offset start_offset,
+                     const std::vector<Offset>& footer_ends) const;
     
     /**
      * @brief Validate JPEG file structure
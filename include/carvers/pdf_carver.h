@@ -19,10 +19,11 @@ public:
     std::vector<std::vector<Byte>> getFileSignatures() const override;
     std::vector<std::vector<Byte>> getFileFooters() const override;
     
-    std::vector<RecoveredFile> carveFiles(
-        const Byte* data, 
-        Size size, 
-        Offset base_offset
+    std::vector<RecoveredFile> carveFilesAt(
+        const Byte* data,
+        Size size,
+        Offset base_offset,
+        const SignatureHits& hits
     ) override;
     
     double validateFile(const RecoveredFile& file, const Byte* data) override;
@@ -34,9 +35,10 @@ private:
      * @param data Data to search in
      * @param size Size of the data
      * @param start_offset Offset where PDF starts
+     * @param hits Signature and footer offsets in data
      * @return Size of the PDF file, or 0 if not found
      */
-    Size findPdfEnd(const Byte* data, Size size, Offset start_offset) const;
+    Size findPdfEnd(const Byte* data, Size size, Offset start_offset, const SignatureHits& hits) const;
     
     /**
      * @brief Validate PDF file structure
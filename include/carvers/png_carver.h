@@ -19,10 +19,11 @@ public:
     std::vector<std::vector<Byte>> getFileSignatures() const override;
     std::vector<std::vector<Byte>> getFileFooters() const override;
     
-    std::vector<RecoveredFile> carveFiles(
-        const Byte* data, 
-        Size size, 
-        Offset base_offset
+    std::vector<RecoveredFile> carveFilesAt(
+        const Byte* data,
+        Size size,
+        Offset base_offset,
+        const SignatureHits& hits
     ) override;
     
     double validateFile(const RecoveredFile& file, const Byte* data) override;
@@ -34,9 +35,11 @@ private:
      * @param data Data to search in
      * @param size Size of the data
      * @param start_offset Offset where PNG starts
+     * @param footer_ends Where IEND chunk types in data end, ascending
      * @return Size of the PNG file, or 0 if not found
      */
-    Size findPngEnd(const Byte* data, Size size, Offset start_offset) const;
+    Size findPngEnd(const Byte* data, Size size, Offset start_offset,
+                    const std::vector<Offset>& footer_ends) const;
     
     /**
      * @brief Validate PNG file structure
@@ -63,12 +66,13 @@ private:
     bool hasValidChunks(const Byte* data, Size size) const;
     
     /**
-     * @brief Check if PNG data contains a valid IEND chunk
-     * @param data PNG file data
-     * @param size Size of the data
-     * @return true if a valid IEND chunk is found
+     * @brief Check if a PNG contains an IEND chunk after its signature
+     * @param footer_ends Where IEND chunk types in the data end, ascending
+     * @param start_offset Offset where the PNG starts in the data
+     * @param size Size of the PNG
+     * @return true if an IEND chunk is found
      */
-    bool hasValidIendChunk(const Byte* data, Size size) const;
+    bool hasValidIendChunk(const std::vector<Offset>& footer_ends, Offset start_offset, Size size) const;
     
     /**
      * @brief Calculate CRC32 for PNG chunk validation
@@ -13,7 +13,8 @@ public:
     std::vector<std::string> getSupportedTypes() const override;
     std::vector<std::vector<Byte>> getFileSignatures() const override;
     std::vector<std::vector<Byte>> getFileFooters() const override;
-    std::vector<RecoveredFile> carveFiles(const Byte* data, Size size, Offset base_offset) override;
+    std::vector<RecoveredFile> carveFilesAt(const Byte* data, Size size, Offset base_offset,
+                                            const SignatureHits& hits) override;
     double validateFile(const RecoveredFile& file, const Byte* data) override;
     Size getMaxFileSize() const override;
 
@@ -70,15 +71,19 @@ private:
 
     bool validate_zip_structure(const uint8_t* data, size_t size) const;
     size_t find_end_of_central_directory(const uint8_t* data, size_t size) const;
+    size_t find_end_of_central_directory(const uint8_t* data, size_t offset, size_t size,
+                                         const std::vector<Offset>& footer_ends) const;
     bool validate_local_file_header(const ZipLocalFileHeader* header) const;
     bool validate_central_dir_header(const ZipCentralDirHeader* header) const;
     bool validate_end_of_central_dir(const ZipEndOfCentralDir* header) const;
     
-    size_t calculate_zip_size(const uint8_t* data, size_t max_size) const;
+    size_t calculate_zip_size(const uint8_t* base, size_t base_size, size_t offset,
+                              const SignatureHits& hits) const;
     std::string extract_zip_metadata(const uint8_t* data, size_t size) const;
     uint32_t count_zip_entries(const uint8_t* data, size_t size) const;
     
     double calculateConfidence(const Byte* data, Size size) const;
+    double calculateConfidence(const Byte* data, Size size, bool has_eocd) const;
 };
 
 } // namespace FileRecovery
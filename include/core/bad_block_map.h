@@ -0,0 +1,87 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "utils/types.h"
+
+namespace FileRecovery {
+
+/**
+ * @brief Thread-safe set of unreadable device ranges
+ *
+ * Ranges are kept merged and sorted so lookups are logarithmic. The map
+ * can be saved to and loaded from a small text file ("offset length"
+ * per line) so a later run over the same device does not retry regions
+ * that are already known to be bad.
+ */
+class BadBlockMap {
+public:
+    BadBlockMap() = default;
+
+    BadBlockMap(const BadBlockMap&) = delete;
+    BadBlockMap& operator=(const BadBlockMap&) = delete;
+
+    /**
+     * @brief Record an unreadable range, merging it with overlapping or adjacent ones
+     */
+    void add(Offset offset, Size size);
+
+    /**
+     * @brief Check whether any part of a range is known to be bad
+     */
+    bool overlaps(Offset offset, Size size) const;
+
+    /**
+     * @brief Find the bad range containing an offset
+     * @param offset Offset to look up
+     * @param end Receives the end of the bad range if found
+     * @return true if offset lies inside a bad range
+     */
+    bool findContaining(Offset offset, Offset& end) const;
+
+    /**
+     * @brief Get the start of the first bad range beginning after offset
+     * @return Start offset, or limit if there is none before limit
+     */
+    Offset nextBadStart(Offset offset, Offset limit) const;
+
+    /**
+     * @brief Get all bad ranges as (offset, size) pairs
+     */
+    std::vector<std::pair<Offset, Size>> getRanges() const;
+
+    /**
+     * @brief Total number of bytes marked bad
+     */
+    Size getTotalBytes() const;
+
+    /**
+     * @brief Check whether ranges were added since the last load/save
+     */
+    bool isDirty() const;
+
+    /**
+     * @brief Load ranges from a map file, replacing the current contents
+     * @param path Map file path
+     * @param device_size Size of the device the map must describe
+     * @return true if the file was read and matches the device
+     */
+    bool load(const std::string& path, Size device_size);
+
+    /**
+     * @brief Write the map atomically (temporary file + rename)
+     * @param path Map file path
+     * @param device_size Device size recorded in the header
+     * @return true if the file was written
+     */
+    bool save(const std::string& path, Size device_size);
+
+private:
+    mutable std::mutex mutex_;
+    std::map<Offset, Offset> ranges_;   // start -> end (exclusive)
+    bool dirty_ = false;
+};
+
+} // namespace FileRecovery
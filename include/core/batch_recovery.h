@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "utils/types.h"
+#include "core/scan_scheduler.h"
+
+namespace FileRecovery {
+
+class RecoveryEngine;
+
+/**
+ * @brief One image of a batch and where its files go
+ */
+struct BatchJob {
+    std::string device_path;
+    std::string output_directory;
+};
+
+/**
+ * @brief Outcome of one image of a batch
+ */
+struct BatchResult {
+    BatchJob job;
+    bool started;               ///< false if the batch was stopped before the image's turn
+    RecoveryStatus status;
+    size_t files_recovered;
+    size_t files_saved;
+    Size bytes_scanned;
+    Size bytes_extracted;
+    double seconds;
+
+    BatchResult()
+        : started(false), status(RecoveryStatus::FAILED), files_recovered(0), files_saved(0),
+          bytes_scanned(0), bytes_extracted(0), seconds(0.0) {}
+};
+
+/**
+ * @brief Scans many images at once on one set of workers
+ *
+ * Every image gets its own RecoveryEngine, but all engines run on the
+ * same scan and extraction pools through fair queues, so each image
+ * gets an equal share of the workers however many chunks it queues.
+ * Their readers share one I/O scheduler that hands out read slots in
+ * arrival order. Up to max_active images are scanned at the same time;
+ * the next one starts when one finishes.
+ */
+class BatchRecovery {
+public:
+    using ProgressCallback = std::function<void(const BatchResult& finished, size_t done, size_t total)>;
+
+    /**
+     * @brief Constructor
+     * @param base_config Settings for every image; device and output are taken from the jobs
+     * @param jobs Images to scan
+     * @param max_active Images scanned at once, 0 for one per scan worker
+     */
+    BatchRecovery(const ScanConfig& base_config, std::vector<BatchJob> jobs, size_t max_active = 0);
+
+    /**
+     * @brief Destructor - stops and waits for a run in progress
+     */
+    ~BatchRecovery();
+
+    BatchRecovery(const BatchRecovery&) = delete;
+    BatchRecovery& operator=(const BatchRecovery&) = delete;
+
+    /**
+     * @brief Read a manifest of images
+     *
+     * One image per line: the device path and the output directory,
+     * separated by a tab, or by whitespace if the line has no tab.
+     * Empty lines and lines starting with '#' are skipped.
+     *
+     * @param path Manifest file path
+     * @param jobs Receives the images in manifest order
+     * @return false if the file cannot be read or a line is malformed
+     */
+    static bool loadManifest(const std::string& path, std::vector<BatchJob>& jobs);
+
+    /**
+     * @brief Scan every image
+     * @return SUCCESS if every image succeeded, PARTIAL_SUCCESS if some did, FAILED otherwise
+     */
+    RecoveryStatus run();
+
+    /**
+     * @brief Stop the running images and skip the ones not started yet
+     *
+     * Safe from any thread, but it takes a lock, so not from a signal handler.
+     */
+    void stop();
+
+    /**
+     * @brief Report each image as it finishes; called from the image's thread
+     */
+    void setProgressCallback(ProgressCallback callback) { progress_callback_ = std::move(callback); }
+
+    /**
+     * @brief Get the result of every image, in manifest order
+     */
+    const std::vector<BatchResult>& getResults() const { return results_; }
+
+    /**
+     * @brief Write one tab-separated line per image and a total line
+     * @param path Summary file path
+     * @return true if the file was written
+     */
+    bool writeSummary(const std::string& path) const;
+
+    /**
+     * @brief Get the printable name of a status
+     */
+    static const char* statusName(RecoveryStatus status);
+
+private:
+    ScanConfig base_config_;
+    std::vector<BatchJob> jobs_;
+    size_t max_active_;
+    SharedScheduler shared_;
+    std::vector<BatchResult> results_;
+    double elapsed_seconds_;
+    ProgressCallback progress_callback_;
+
+    std::mutex mutex_;
+    std::vector<RecoveryEngine*> active_engines_;   // Guarded by mutex_
+    std::atomic<bool> should_stop_;
+
+    /**
+     * @brief Scan one image and fill in its result
+     */
+    void runJob(size_t index);
+};
+
+} // namespace FileRecovery
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "utils/types.h"
+
+namespace FileRecovery {
+
+/**
+ * @brief Snapshot of block cache counters
+ */
+struct BlockCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    Size bytes_cached;
+
+    BlockCacheStats() : hits(0), misses(0), evictions(0), bytes_cached(0) {}
+
+    /**
+     * @brief Fraction of block lookups served from memory
+     */
+    double hitRatio() const {
+        uint64_t total = hits + misses;
+        return total > 0 ? static_cast<double>(hits) / total : 0.0;
+    }
+
+    /**
+     * @brief One-line summary for the log
+     */
+    std::string describe(Size block_size) const;
+};
+
+/**
+ * @brief Sharded LRU cache of fixed-size device blocks
+ *
+ * Blocks are identified by their index (offset / block size). Each block
+ * index maps to one of several shards, each with its own lock and LRU
+ * list, so concurrent readers touching different blocks rarely contend.
+ * The memory budget is split evenly across the shards.
+ */
+class BlockCache {
+public:
+    /**
+     * @brief Constructor
+     * @param block_size Size of a cached block in bytes
+     * @param capacity Total memory budget in bytes
+     * @param num_shards Number of independently locked shards
+     */
+    BlockCache(Size block_size, Size capacity, size_t num_shards = 16);
+
+    BlockCache(const BlockCache&) = delete;
+    BlockCache& operator=(const BlockCache&) = delete;
+
+    /**
+     * @brief Copy part of a cached block and mark it most recently used
+     * @param block Block index
+     * @param offset Offset within the block
+     * @param size Number of bytes to copy
+     * @param buffer Destination buffer
+     * @return true on a hit; counts a hit or a miss
+     */
+    bool lookup(uint64_t block, Size offset, Size size, Byte* buffer);
+
+    /**
+     * @brief Check whether a block is cached without touching LRU order or counters
+     */
+    bool contains(uint64_t block) const;
+
+    /**
+     * @brief Insert (or replace) a block, evicting least recently used blocks
+     * @param block Block index
+     * @param data Block contents
+     * @param size Number of valid bytes (at most the block size)
+     */
+    void insert(uint64_t block, const Byte* data, Size size);
+
+    /**
+     * @brief Count blocks that were loaded without an individual lookup
+     */
+    void recordMisses(uint64_t count) { misses_ += count; }
+
+    /**
+     * @brief Drop every cached block (counters are kept)
+     */
+    void clear();
+
+    /**
+     * @brief Get the cached block size
+     */
+    Size getBlockSize() const { return block_size_; }
+
+    /**
+     * @brief Get the total memory budget
+     */
+    Size getCapacity() const { return capacity_; }
+
+    /**
+     * @brief Get a snapshot of the counters
+     */
+    BlockCacheStats getStats() const;
+
+private:
+    struct Entry {
+        uint64_t block;
+        std::vector<Byte> data;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<Entry> lru;   // front = most recently used
+        std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+        Size bytes = 0;
+    };
+
+    Size block_size_;
+    Size capacity_;
+    Size shard_capacity_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    std::atomic<uint64_t> hits_;
+    std::atomic<uint64_t> misses_;
+    std::atomic<uint64_t> evictions_;
+
+    Shard& shardFor(uint64_t block) const { return *shards_[block % shards_.size()]; }
+};
+
+} // namespace FileRecovery
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "utils/types.h"
+#include "interfaces/file_carver.h"
+#include "utils/pattern_matcher.h"
+
+namespace FileRecovery {
+
+/**
+ * @brief One carver in a scan plan with the patterns it is run for
+ *
+ * Signatures and footers are read from the carver once when the plan is
+ * built, so the scan does not ask the carver for them on every chunk.
+ */
+struct CarverStage {
+    FileCarver* carver;
+    std::string name;
+    std::vector<std::vector<Byte>> signatures;
+    std::vector<std::vector<Byte>> footers;
+
+    CarverStage() : carver(nullptr) {}
+};
+
+/**
+ * @brief The carvers a scan runs, chosen for the requested file types
+ *
+ * The signatures and footers of all stages are compiled into one
+ * matcher, so a chunk is searched once and each carver only looks at
+ * its hits.
+ */
+class ScanPlan {
+public:
+    ScanPlan() = default;
+    ScanPlan(ScanPlan&&) = default;
+    ScanPlan& operator=(ScanPlan&&) = default;
+    ScanPlan(const ScanPlan&) = delete;
+    ScanPlan& operator=(const ScanPlan&) = delete;
+
+    /**
+     * @brief Add a carver the plan owns
+     * @param name Registry name of the carver
+     * @param carver Carver instance
+     */
+    void addCarver(const std::string& name, std::unique_ptr<FileCarver> carver);
+
+    /**
+     * @brief Add a carver owned by the caller, which must outlive the plan
+     * @param name Name used in log messages
+     * @param carver Carver instance
+     */
+    void addCarver(const std::string& name, FileCarver& carver);
+
+    /**
+     * @brief Get the stages in the order they run on each chunk
+     */
+    const std::vector<CarverStage>& getStages() const { return stages_; }
+
+    /**
+     * @brief Find the signatures and footers of every stage in one pass
+     * @param data Data to search in
+     * @param size Size of the data
+     * @param hits Resized to the stage count; hits[i] receives where
+     *             stage i's signatures start and its footers end
+     */
+    void findSignatures(const Byte* data, Size size, std::vector<SignatureHits>& hits) const;
+
+    /**
+     * @brief Find the signatures of every stage at aligned device offsets only
+     *
+     * Footers may end anywhere, so they are still searched for at every
+     * byte, but only when some stage has a header in the data.
+     *
+     * @param data Data to search in
+     * @param size Size of the data
+     * @param base_offset Device offset of data, which the alignment applies to
+     * @param alignment Distance between the device offsets checked
+     * @param hits As for findSignatures()
+     */
+    void findAlignedSignatures(const Byte* data, Size size, Offset base_offset, Size alignment,
+                               std::vector<SignatureHits>& hits) const;
+
+    /**
+     * @brief Find the footers of every stage, without looking for signatures
+     * @param data Data to search in
+     * @param size Size of the data
+     * @param hits As for findSignatures(), with every headers list empty
+     */
+    void findFooters(const Byte* data, Size size, std::vector<SignatureHits>& hits) const;
+
+    /**
+     * @brief Check whether the plan runs no carver at all
+     */
+    bool empty() const { return stages_.empty(); }
+
+    /**
+     * @brief One-line summary of the carvers and pattern counts
+     */
+    std::string describe() const;
+
+private:
+    // Stage and length of a footer pattern; footer k has tag stage count + k
+    struct FooterTag {
+        size_t stage;
+        Size length;
+    };
+
+    std::vector<std::unique_ptr<FileCarver>> owned_;
+    std::vector<CarverStage> stages_;
+    std::vector<FooterTag> footer_tags_;
+    MultiPatternMatcher matcher_;           // Signatures tagged with the stage index, then footers
+    MultiPatternMatcher footer_matcher_;    // Footers only, tagged as in matcher_
+
+    void buildMatchers();
+    void collectFooters(const std::vector<std::vector<Offset>>& tag_hits,
+                        std::vector<SignatureHits>& hits) const;
+};
+
+/**
+ * @brief Factories for every known carver, keyed by the types they support
+ *
+ * The built-in carvers are registered when the registry is first used.
+ * Further carvers are registered with registerCarver() and are picked up
+ * by every engine built afterwards; the engine itself only ever asks the
+ * registry for a plan.
+ */
+class CarverRegistry {
+public:
+    using Factory = std::function<std::unique_ptr<FileCarver>()>;
+
+    /**
+     * @brief Get the process-wide registry
+     */
+    static CarverRegistry& instance();
+
+    /**
+     * @brief Register a carver
+     *
+     * The factory is called once to read the carver's supported types.
+     *
+     * @param name Unique carver name
+     * @param factory Creates a new carver instance
+     * @return false if the name is taken or the factory yields no carver
+     */
+    bool registerCarver(const std::string& name, Factory factory);
+
+    /**
+     * @brief Get every type some registered carver supports, upper case
+     */
+    std::vector<std::string> getSupportedTypes() const;
+
+    /**
+     * @brief Build the plan for a set of file types
+     *
+     * Types are matched case-insensitively against the carvers'
+     * getSupportedTypes(). A carver supporting several requested types
+     * appears once.
+     *
+     * @param types Requested types, empty for every registered carver
+     * @param unknown_types If not null, receives the requested types no carver supports
+     * @return Plan with a fresh instance of each selected carver
+     */
+    ScanPlan createPlan(const std::vector<std::string>& types,
+                        std::vector<std::string>* unknown_types = nullptr) const;
+
+    /**
+     * @brief Check whether a carver supports any of the requested types
+     * @param carver Carver to check
+     * @param types Requested types, empty to accept every carver
+     */
+    static bool matchesTypes(const FileCarver& carver, const std::vector<std::string>& types);
+
+private:
+    struct Entry {
+        std::string name;
+        Factory factory;
+        std::vector<std::string> types;     // Upper case
+    };
+
+    mutable std::mutex mutex_;
+    std::vector<Entry> entries_;            // Registration order, which is the carving order
+
+    CarverRegistry();
+};
+
+} // namespace FileRecovery
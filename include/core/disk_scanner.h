@@ -3,16 +3,55 @@
 #include <string>
 #include <memory>
 #include <fstream>
+#include <atomic>
 #include <mutex>
+#include <functional>
 #include "utils/types.h"
+#include "core/io_backend.h"
+#include "core/block_cache.h"
+#include "core/bad_block_map.h"
+#include "core/segmented_image.h"
+#include "utils/aligned_buffer_pool.h"
 
 namespace FileRecovery {
 
+/**
+ * @brief Counters for degraded-media reads
+ */
+struct DegradedReadStats {
+    Size bad_bytes;          ///< Bytes in sectors that failed to read (zero-filled)
+    Size skipped_bytes;      ///< Bytes skipped past clustered errors (zero-filled)
+    Size known_bad_bytes;    ///< Bytes served as zeros from the bad-block map without reading
+    uint64_t retry_reads;    ///< Reads issued while splitting failed requests
+
+    DegradedReadStats() : bad_bytes(0), skipped_bytes(0), known_bad_bytes(0), retry_reads(0) {}
+};
+
+/**
+ * @brief Bytes moved by DiskScanner::copyToFd(), by copy method
+ */
+struct CopyStats {
+    Size copy_file_range_bytes;  ///< Copied inside the kernel with copy_file_range()
+    Size sendfile_bytes;         ///< Copied inside the kernel with sendfile()
+    Size buffered_bytes;         ///< Copied through a fixed-size user-space buffer
+
+    CopyStats() : copy_file_range_bytes(0), sendfile_bytes(0), buffered_bytes(0) {}
+};
+
+/**
+ * @brief Predicate deciding whether a read fails with EIO (fault injection)
+ */
+using ReadFaultHook = std::function<bool(Offset offset, Size size)>;
+
 /**
  * @brief Thread-safe disk scanner for raw disk access
  * 
  * Provides safe, read-only access to disk devices with memory mapping
  * and efficient chunked reading capabilities.
+ * 
+ * A path to the first file of a segmented raw image (image.001 with
+ * image.002, ... alongside) is opened as one virtual device spanning
+ * all segments.
  */
 class DiskScanner {
 public:
@@ -22,6 +61,13 @@ public:
      */
     explicit DiskScanner(const std::string& device_path);
     
+    /**
+     * @brief Constructor taking I/O options from the scan configuration
+     * @param device_path Path to the device (e.g., "/dev/sda1")
+     * @param config Scan configuration (I/O backend, direct I/O, mapping and block cache options)
+     */
+    DiskScanner(const std::string& device_path, const ScanConfig& config);
+    
     /**
      * @brief Destructor - ensures proper cleanup
      */
@@ -51,8 +97,41 @@ public:
      */
     const std::string& getDevicePath() const { return device_path_; }
     
+    /**
+     * @brief Get the number of image segments behind the device
+     * @return Segment count (1 for an ordinary file or block device)
+     */
+    size_t getSegmentCount() const { return segments_ ? segments_->getSegments().size() : 1; }
+    
+    /**
+     * @brief Check whether reads bypass the page cache (O_DIRECT)
+     * @return true if direct I/O was requested and is supported by the device
+     */
+    bool isDirectIo() const { return direct_fd_ >= 0; }
+    
+    /**
+     * @brief Get a reusable buffer aligned for direct I/O
+     * 
+     * Chunk buffers obtained here let direct-mode reads land in the
+     * caller's memory without an intermediate copy.
+     * 
+     * @param size Minimum buffer size
+     * @return Pooled buffer handle (returned to the pool on destruction)
+     */
+    AlignedBufferPool::Buffer acquireBuffer(Size size) { return buffer_pool_->acquire(size); }
+    
     /**
      * @brief Read a chunk of data from the device
+     * 
+     * Uses positional reads, so any number of threads may call this
+     * concurrently without serializing on a shared file offset. In direct
+     * I/O mode, unaligned offsets, sizes and buffers are served through
+     * an aligned bounce buffer.
+     * 
+     * In degraded mode a failed read is retried piecewise and unreadable
+     * sectors are zero-filled, so the full size is returned and only the
+     * bad sectors are lost.
+     * 
      * @param offset Offset to start reading from
      * @param size Number of bytes to read
      * @param buffer Buffer to store the data
@@ -60,8 +139,156 @@ public:
      */
     Size readChunk(Offset offset, Size size, Byte* buffer);
     
+    /**
+     * @brief Read through the shared block cache
+     * 
+     * Intended for small, repeatedly read regions: filesystem metadata and
+     * the extents of carved files. Missing blocks are loaded with one read
+     * per contiguous run and kept for later callers. Reads larger than the
+     * cache budget, or any read when no cache is configured, go straight
+     * to readChunk() so bulk scans never flush the cache.
+     * 
+     * @param offset Offset to start reading from
+     * @param size Number of bytes to read
+     * @param buffer Buffer to store the data
+     * @return Number of bytes actually read
+     */
+    Size readCached(Offset offset, Size size, Byte* buffer);
+    
+    /**
+     * @brief Copy a device range into a file descriptor
+     * 
+     * Bytes are moved inside the kernel with copy_file_range(), or with
+     * sendfile() where that is refused, and otherwise through a fixed-size
+     * buffer, so memory use never depends on the size of the range.
+     * Degraded mode and fault injection always take the buffered path so
+     * bad sectors are retried and zero-filled as for readChunk().
+     * 
+     * @param offset Device offset of the first byte
+     * @param size Number of bytes to copy (clamped to the device)
+     * @param out_fd Destination, written at its current file position
+     * @return Number of bytes copied
+     */
+    Size copyToFd(Offset offset, Size size, int out_fd);
+    
+    /**
+     * @brief Get copyToFd() counters
+     */
+    CopyStats getCopyStats() const;
+    
+    /**
+     * @brief Check whether a block cache is configured
+     */
+    bool hasBlockCache() const { return block_cache_ != nullptr; }
+    
+    /**
+     * @brief Get block cache counters (zeroed if no cache is configured)
+     */
+    BlockCacheStats getCacheStats() const;
+    
+    /**
+     * @brief Get the cached block size, or 0 if no cache is configured
+     */
+    Size getCacheBlockSize() const { return block_cache_ ? block_cache_->getBlockSize() : 0; }
+    
+    /**
+     * @brief Check whether degraded-media reads are enabled
+     */
+    bool isDegradedMode() const { return degraded_mode_; }
+    
+    /**
+     * @brief Get degraded-media read counters
+     */
+    DegradedReadStats getDegradedStats() const;
+    
+    /**
+     * @brief Get the map of ranges found (or loaded as) unreadable
+     */
+    const BadBlockMap& getBadBlockMap() const { return bad_blocks_; }
+    
+    /**
+     * @brief Write the bad-block map to the configured path, if any
+     * @return true if there was nothing to save or the map was written
+     */
+    bool saveBadBlockMap();
+    
+    /**
+     * @brief Make matching reads fail with EIO, for exercising degraded mode
+     * @param hook Predicate called for every raw device read (empty to clear)
+     */
+    void setReadFaultHook(ReadFaultHook hook) { fault_hook_ = std::move(hook); }
+    
+    /**
+     * @brief Read a batch of chunks through the configured I/O backend
+     * 
+     * Requests are clamped to the device size. In degraded mode failed
+     * requests are repaired with readDegraded() before completion, and
+     * requests touching known-bad ranges are served without the backend.
+     * on_complete is invoked on the calling thread once per request, in
+     * completion order, so the caller can dispatch work for each chunk as
+     * soon as its data lands.
+     * 
+     * @param requests Requests to execute (fd/bytes_read/error are filled in)
+     * @param on_complete Completion callback
+     */
+    void readBatch(std::vector<ReadRequest>& requests, const ReadCompletionCallback& on_complete);
+    
+    /**
+     * @brief Register reusable chunk buffers with the I/O backend
+     * @param buffers Buffers that will be passed to readBatch
+     * @param buffer_size Size of each buffer
+     * @return true if the backend registered them
+     */
+    bool registerBuffers(const std::vector<Byte*>& buffers, Size buffer_size);
+    
+    /**
+     * @brief Get the name of the active I/O backend
+     * @return Backend name (e.g. "sync", "io_uring")
+     */
+    std::string getIoBackendName() const;
+    
+    /**
+     * @brief Change the I/O backend's queue depth
+     * 
+     * Recreates the backend of an initialized scanner, so it must not be
+     * called while reads are in flight or buffers are registered.
+     * 
+     * @param depth Reads the backend may keep in flight
+     */
+    void setIoQueueDepth(unsigned depth);
+    
+    /**
+     * @brief Check whether the whole device is mapped for zero-copy access
+     * @return true if mapped-view mode is active
+     */
+    bool hasMappedView() const { return mapped_base_ != nullptr; }
+    
+    /**
+     * @brief Get a zero-copy view into the whole-device mapping
+     * @param offset Offset of the view
+     * @param size Size of the view
+     * @return Pointer into the mapping, or nullptr if not mapped or out of range
+     */
+    const Byte* getMappedView(Offset offset, Size size) const;
+    
+    /**
+     * @brief Slide the mapped-view page-cache window along with the scan
+     * 
+     * Prefetches (MADV_WILLNEED) a window ahead of the scan cursor and
+     * releases (MADV_DONTNEED) everything below the oldest offset that
+     * is still being consumed. Call from a single scheduling thread.
+     * 
+     * @param consumed_up_to Lowest offset any consumer still needs
+     * @param cursor Offset of the next chunk to be handed out
+     */
+    void adviseMappedWindow(Offset consumed_up_to, Offset cursor);
+    
     /**
      * @brief Memory-map a region of the device (for large sequential reads)
+     * 
+     * In mapped-view mode this returns a view into the existing
+     * whole-device mapping instead of creating a new one.
+     * 
      * @param offset Offset to start mapping from
      * @param size Size of the region to map
      * @return Pointer to mapped memory, or nullptr on failure
@@ -75,6 +302,18 @@ public:
      */
     void unmapRegion(const Byte* ptr, Size size);
     
+    /**
+     * @brief List the regions of the device that hold data
+     * 
+     * For regular files on filesystems that support SEEK_DATA/SEEK_HOLE,
+     * holes in sparse images are left out. Block devices, and files whose
+     * filesystem cannot report holes, yield a single extent covering the
+     * whole device.
+     * 
+     * @return (offset, size) pairs in ascending order
+     */
+    std::vector<std::pair<Offset, Size>> getDataExtents() const;
+    
     /**
      * @brief Read the entire device into memory (only for small devices)
      * @param max_size Maximum size to read (safety limit)
@@ -100,6 +339,41 @@ private:
     Size device_size_;
     bool is_initialized_;
     mutable std::mutex access_mutex_;
+    IoBackendType io_backend_type_;
+    unsigned io_queue_depth_;
+    std::unique_ptr<IoBackend> io_backend_;
+    bool direct_io_requested_;
+    int direct_fd_;
+    Size io_alignment_;
+    std::unique_ptr<AlignedBufferPool> buffer_pool_;
+    bool mapped_view_requested_;
+    Byte* mapped_base_;
+    Offset willneed_end_;
+    Offset dontneed_end_;
+    std::unique_ptr<BlockCache> block_cache_;
+    std::unique_ptr<SegmentedImage> segments_;
+    bool degraded_mode_;
+    std::string bad_block_map_path_;
+    Size sector_size_;
+    BadBlockMap bad_blocks_;
+    ReadFaultHook fault_hook_;
+    std::atomic<Size> bad_bytes_;
+    std::atomic<Size> skipped_bytes_;
+    std::atomic<Size> known_bad_bytes_;
+    std::atomic<uint64_t> retry_reads_;
+    std::atomic<bool> copy_file_range_usable_;
+    std::atomic<bool> sendfile_usable_;
+    std::atomic<Size> copy_file_range_bytes_;
+    std::atomic<Size> sendfile_bytes_;
+    std::atomic<Size> buffered_bytes_;
+    
+    /**
+     * @brief Per-call state of a degraded read
+     */
+    struct DegradedState {
+        unsigned consecutive_bad = 0;   // Failed sectors since the last good read
+        Size skip_size = 0;             // Next skip-ahead distance
+    };
     
     /**
      * @brief Get the size of the device file/block device
@@ -112,6 +386,90 @@ private:
      * @return true if device is safe to access
      */
     bool verifyDeviceAccess() const;
+    
+    /**
+     * @brief Open the remaining segments if the path names a segmented image
+     * @return false if a segment set was found but could not be opened
+     */
+    bool openSegments();
+    
+    /**
+     * @brief Open the O_DIRECT descriptor and determine the I/O alignment
+     * @return true if direct I/O is usable on this device
+     */
+    bool openDirect();
+    
+    /**
+     * @brief Read through the O_DIRECT descriptor
+     * 
+     * Aligned requests go straight into the caller's buffer; unaligned
+     * head/tail bytes are read into a pooled aligned block and copied.
+     * Falls back to buffered reads if the kernel rejects the request.
+     * 
+     * @param offset Offset to start reading from (already bounds-checked)
+     * @param size Number of bytes to read (already clamped to the device)
+     * @param buffer Destination buffer
+     * @return Number of bytes read
+     */
+    Size readDirect(Offset offset, Size size, Byte* buffer, int* error = nullptr);
+    
+    /**
+     * @brief One device read on the active descriptor, honouring the fault hook
+     * @param error Receives errno of a failed read, 0 otherwise
+     * @return Number of bytes read before the error or EOF
+     */
+    Size readRaw(Offset offset, Size size, Byte* buffer, int* error);
+    
+    /**
+     * @brief Copy a range of one source descriptor inside the kernel
+     * 
+     * Tries copy_file_range() and then sendfile(). A method the kernel
+     * rejects for these descriptors is not tried again by later calls.
+     * 
+     * @return Number of bytes copied; less than size if neither method
+     *         could finish, in which case the caller continues buffered
+     */
+    Size copyKernel(int in_fd, Offset in_offset, Size size, int out_fd);
+    
+    /**
+     * @brief Copy a device range through a fixed-size buffer
+     * @return Number of bytes copied
+     */
+    Size copyBuffered(Offset offset, Size size, int out_fd);
+    
+    /**
+     * @brief Read a range on degraded media
+     * 
+     * Known-bad ranges are zero-filled without touching the device; the
+     * rest is read with readSplit(). Always accounts for the full range.
+     * 
+     * @return size (bytes that could not be read are zero-filled)
+     */
+    Size readDegraded(Offset offset, Size size, Byte* buffer);
+    
+    /**
+     * @brief Read a range, halving failed requests down to one sector
+     * 
+     * The request size shrinks on each failure and grows back after
+     * successful reads. Sectors that still fail are zero-filled and
+     * recorded. After a cluster of consecutive bad sectors the reader
+     * skips ahead by a growing distance instead of probing every sector
+     * of a dead zone.
+     * 
+     * @return Number of bytes consumed (read or zero-filled), less only at EOF
+     */
+    Size readSplit(Offset offset, Size size, Byte* buffer, DegradedState& state);
+    
+    /**
+     * @brief Map the whole device read-only for mapped-view mode
+     * @return true if the mapping was created
+     */
+    bool mapWholeDevice();
+    
+    /**
+     * @brief Check whether a read can be issued on the O_DIRECT descriptor as-is
+     */
+    bool isAlignedForDirect(Offset offset, Size size, const Byte* buffer) const;
 };
 
 } // namespace FileRecovery
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "utils/types.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace FileRecovery {
+
+/**
+ * @brief A single positional read submitted to an I/O backend
+ */
+struct ReadRequest {
+    int fd;              ///< File descriptor to read from (filled in by DiskScanner)
+    Offset offset;       ///< Absolute offset on the device
+    Size size;           ///< Number of bytes requested
+    Byte* buffer;        ///< Destination buffer (at least size bytes)
+    Size bytes_read;     ///< Bytes actually read, set on completion
+    int error;           ///< errno of a failed read, 0 on success
+    uint64_t tag;        ///< Caller-defined identifier (e.g. chunk index)
+
+    ReadRequest() : fd(-1), offset(0), size(0), buffer(nullptr), bytes_read(0), error(0), tag(0) {}
+};
+
+/**
+ * @brief Callback invoked once per request when its read has completed
+ */
+using ReadCompletionCallback = std::function<void(ReadRequest&)>;
+
+/**
+ * @brief Positional read that retries on EINTR and short reads
+ * @param fd File descriptor to read from
+ * @param offset Absolute offset to read from
+ * @param size Number of bytes to read
+ * @param buffer Destination buffer
+ * @param error Optional output for the errno of a failed read
+ * @return Number of bytes read (less than size only on EOF or error)
+ */
+Size preadFully(int fd, Offset offset, Size size, Byte* buffer, int* error = nullptr);
+
+/**
+ * @brief Abstract asynchronous read backend used by DiskScanner
+ *
+ * Backends accept a batch of read requests and report each completion
+ * through a callback as soon as it is available, which is not
+ * necessarily in submission order.
+ */
+class IoBackend {
+public:
+    virtual ~IoBackend() = default;
+
+    /**
+     * @brief Prepare the backend for use
+     * @return true if the backend is usable
+     */
+    virtual bool initialize() = 0;
+
+    /**
+     * @brief Get a short human-readable backend name
+     * @return Backend name (e.g. "sync", "io_uring")
+     */
+    virtual std::string getName() const = 0;
+
+    /**
+     * @brief Register long-lived buffers with the backend
+     *
+     * Backends that support it (io_uring) pin these buffers once so reads
+     * into them skip per-request page mapping.
+     *
+     * @param buffers Buffers to register
+     * @param buffer_size Size of each buffer in bytes
+     * @return true if the buffers were registered
+     */
+    virtual bool registerBuffers(const std::vector<Byte*>& buffers, Size buffer_size) {
+        (void)buffers;
+        (void)buffer_size;
+        return false;
+    }
+
+    /**
+     * @brief Read all requests, invoking on_complete for each as it finishes
+     * @param requests Requests to execute (bytes_read/error are filled in)
+     * @param on_complete Completion callback, called on the submitting thread
+     */
+    virtual void submitReads(std::vector<ReadRequest>& requests, const ReadCompletionCallback& on_complete) = 0;
+
+    /**
+     * @brief Create a backend of the given type, falling back to the
+     *        synchronous backend if it cannot be initialized
+     * @param type Requested backend type
+     * @param queue_depth Maximum number of reads kept in flight
+     * @return Initialized backend
+     */
+    static std::unique_ptr<IoBackend> create(IoBackendType type, unsigned queue_depth);
+};
+
+/**
+ * @brief Synchronous backend issuing one pread() per request
+ */
+class SyncIoBackend : public IoBackend {
+public:
+    bool initialize() override { return true; }
+    std::string getName() const override { return "sync"; }
+    void submitReads(std::vector<ReadRequest>& requests, const ReadCompletionCallback& on_complete) override;
+};
+
+/**
+ * @brief io_uring backend keeping up to queue_depth reads in flight
+ *
+ * Talks to the kernel through the raw io_uring syscalls so no liburing
+ * dependency is needed. Reads into registered buffers use READ_FIXED.
+ * A ring is not safe for concurrent submitters, so submitReads() is
+ * serialized internally.
+ */
+class UringIoBackend : public IoBackend {
+public:
+    explicit UringIoBackend(unsigned queue_depth);
+    ~UringIoBackend() override;
+
+    bool initialize() override;
+    std::string getName() const override { return "io_uring"; }
+    bool registerBuffers(const std::vector<Byte*>& buffers, Size buffer_size) override;
+    void submitReads(std::vector<ReadRequest>& requests, const ReadCompletionCallback& on_complete) override;
+
+private:
+    unsigned queue_depth_;
+    int ring_fd_;
+
+    void* sq_ring_ptr_;
+    Size sq_ring_size_;
+    void* cq_ring_ptr_;
+    Size cq_ring_size_;
+    io_uring_sqe* sqes_;
+    Size sqes_size_;
+
+    unsigned* sq_tail_;
+    unsigned* sq_mask_;
+    unsigned* sq_array_;
+    unsigned* cq_head_;
+    unsigned* cq_tail_;
+    unsigned* cq_mask_;
+    io_uring_cqe* cqes_;
+
+    std::vector<std::pair<Byte*, Size>> registered_buffers_;
+    std::mutex submit_mutex_;
+
+    /**
+     * @brief Find the registered buffer containing ptr
+     * @return Buffer index, or -1 if ptr is not in a registered buffer
+     */
+    int findRegisteredBuffer(const Byte* ptr, Size size) const;
+
+    /**
+     * @brief Release the ring mappings and file descriptor
+     */
+    void teardown();
+};
+
+} // namespace FileRecovery
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "utils/types.h"
+#include "utils/aligned_buffer_pool.h"
+
+namespace FileRecovery {
+
+class DiskScanner;
+class IoScheduler;
+
+/**
+ * @brief Counters describing where a read-ahead pipeline spent its time
+ *
+ * reader_stall is time the reader sat on a full ring waiting for carvers
+ * to hand a buffer back (CPU-bound); consumer_stall is the summed time
+ * carver workers waited for a chunk to be read (I/O-bound).
+ */
+struct PipelineStats {
+    size_t chunks_read;
+    Size bytes_read;
+    size_t ring_slots;
+    size_t consumers;
+    std::chrono::nanoseconds wall_time;
+    std::chrono::nanoseconds reader_stall;
+    std::chrono::nanoseconds consumer_stall;
+
+    PipelineStats()
+        : chunks_read(0), bytes_read(0), ring_slots(0), consumers(0),
+          wall_time(0), reader_stall(0), consumer_stall(0) {}
+
+    /**
+     * @brief Fraction of wall time the reader was blocked on a full ring
+     */
+    double readerStallFraction() const;
+
+    /**
+     * @brief Average fraction of wall time a consumer was starved of data
+     */
+    double consumerStallFraction() const;
+
+    /**
+     * @brief One-line summary naming the bottleneck stage
+     */
+    std::string describe() const;
+};
+
+/**
+ * @brief A contiguous share of a pipeline's ranges with its own ring slots
+ */
+struct PipelineLane {
+    size_t first_range;     ///< Index of the lane's first range
+    size_t range_count;     ///< Number of consecutive ranges in the lane
+    size_t slots;           ///< Ring slots reserved for the lane
+    int numa_node;          ///< Node the lane's buffers are placed on, -1 for no placement
+
+    PipelineLane() : first_range(0), range_count(0), slots(0), numa_node(-1) {}
+};
+
+/**
+ * @brief Dedicated reader stage that prefetches chunks into a bounded ring
+ *
+ * A background thread reads chunk N+1..N+k into a ring of reusable
+ * buffers while consumers process chunk N. When every slot is full the
+ * reader blocks until a consumer releases one, so memory stays bounded
+ * and the reader never runs more than k chunks ahead.
+ *
+ * In mapped-view mode slots carry zero-copy views into the mapping and
+ * the reader drives the scanner's madvise window instead of copying.
+ *
+ * The ranges can be split into lanes, e.g. one per NUMA node. Each lane
+ * has its own slots, with buffers placed on the lane's node, and its own
+ * ready queue; the reader serves the lanes in turn so they all progress.
+ */
+class ReadAheadPipeline {
+public:
+    /**
+     * @brief A filled ring slot handed to a consumer
+     */
+    struct Chunk {
+        size_t slot;         ///< Ring slot, pass back to release()
+        Offset offset;       ///< Device offset of the first byte
+        Size size;           ///< Number of valid bytes
+        const Byte* data;    ///< Chunk data (valid until release())
+        int error;           ///< errno of a failed read, 0 on success
+
+        Chunk() : slot(0), offset(0), size(0), data(nullptr), error(0) {}
+    };
+
+    /**
+     * @brief Constructor
+     * @param scanner Initialized scanner to read from
+     * @param ring_slots Number of chunk buffers in the ring
+     * @param max_batch Maximum reads submitted to the backend at once
+     */
+    ReadAheadPipeline(DiskScanner& scanner, size_t ring_slots, size_t max_batch);
+
+    /**
+     * @brief Destructor - stops and joins the reader
+     */
+    ~ReadAheadPipeline();
+
+    ReadAheadPipeline(const ReadAheadPipeline&) = delete;
+    ReadAheadPipeline& operator=(const ReadAheadPipeline&) = delete;
+
+    /**
+     * @brief Allocate the ring and start the reader thread
+     * @param ranges Device ranges to read, in scan order, each at most max_chunk_size
+     * @param max_chunk_size Largest range size (ring buffer capacity)
+     * @param consumers Number of consumer threads (for stall accounting)
+     * @return true if the pipeline started
+     */
+    bool start(const std::vector<std::pair<Offset, Size>>& ranges, Size max_chunk_size, size_t consumers);
+
+    /**
+     * @brief Allocate per-lane ring slots and start the reader thread
+     * 
+     * The ring size given to the constructor is replaced by the sum of
+     * the lanes' slots. Lanes are not used with a mapped view, whose
+     * madvise window assumes one sequential reader position.
+     * 
+     * @param ranges Device ranges to read, in scan order, each at most max_chunk_size
+     * @param max_chunk_size Largest range size (ring buffer capacity)
+     * @param consumers Number of consumer threads (for stall accounting)
+     * @param lanes Lanes covering ranges in order, without gaps
+     * @return true if the pipeline started
+     */
+    bool start(const std::vector<std::pair<Offset, Size>>& ranges, Size max_chunk_size, size_t consumers,
+               const std::vector<PipelineLane>& lanes);
+
+    /**
+     * @brief Block until a chunk of a lane is ready
+     * @param chunk Receives the chunk
+     * @param lane Lane to take the chunk from
+     * @return false once every chunk of the lane has been handed out or the pipeline stopped
+     */
+    bool next(Chunk& chunk, size_t lane = 0);
+
+    /**
+     * @brief Return a chunk's slot to the reader
+     * @param chunk Chunk obtained from next()
+     */
+    void release(const Chunk& chunk);
+
+    /**
+     * @brief Stop reading and wake all waiters
+     */
+    void stop();
+
+    /**
+     * @brief Wait for the reader thread to exit
+     */
+    void join();
+
+    /**
+     * @brief Get the pipeline counters
+     */
+    PipelineStats getStats() const;
+    
+    /**
+     * @brief Take a slot from a scheduler shared with other scans for every read batch
+     * @param scheduler Scheduler that must outlive the reader, null for none; set before start()
+     */
+    void setIoScheduler(IoScheduler* scheduler) { io_scheduler_ = scheduler; }
+    
+    /**
+     * @brief Change how many reads the reader submits at once; takes effect with the next batch
+     * @param max_batch Maximum reads per batch
+     */
+    void setMaxBatch(size_t max_batch);
+
+private:
+    struct Slot {
+        AlignedBufferPool::Buffer buffer;
+        Chunk chunk;
+        size_t lane;
+        bool busy;
+    };
+
+    struct LaneState {
+        std::deque<size_t> free_slots;
+        std::deque<size_t> ready_slots;
+        size_t next_range;      // Next range the reader starts, guarded by mutex_
+        size_t end_range;
+    };
+
+    DiskScanner& scanner_;
+    size_t ring_slots_;
+    std::atomic<size_t> max_batch_;
+    IoScheduler* io_scheduler_;
+    bool mapped_;
+
+    std::vector<Slot> slots_;
+    std::vector<std::pair<Offset, Size>> ranges_;
+    std::vector<LaneState> lanes_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable free_cv_;
+    std::condition_variable ready_cv_;
+    bool reader_done_;
+    bool stopping_;
+    std::thread reader_;
+
+    PipelineStats stats_;
+    std::chrono::steady_clock::time_point start_time_;
+
+    /**
+     * @brief Reader thread body
+     */
+    void readerLoop();
+
+    /**
+     * @brief Check whether some lane has both a free slot and a range left (caller holds mutex_)
+     */
+    bool canRead() const;
+
+    /**
+     * @brief Mark a slot as filled and wake a consumer of its lane
+     */
+    void publish(size_t slot);
+
+    /**
+     * @brief Lowest offset still held by a busy slot (caller holds mutex_)
+     */
+    Offset lowestBusyOffset(Offset fallback) const;
+};
+
+} // namespace FileRecovery
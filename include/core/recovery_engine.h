@@ -5,10 +5,21 @@
 #include <thread>
 #include <future>
 #include <atomic>
+#include <condition_variable>
+#include <set>
+#include <chrono>
 #include "utils/types.h"
 #include "core/disk_scanner.h"
+#include "core/read_ahead_pipeline.h"
+#include "core/carver_registry.h"
+#include "core/scan_checkpoint.h"
+#include "core/scan_scheduler.h"
+#include "core/scan_tuner.h"
+#include "utils/thread_pool.h"
+#include "utils/task_group.h"
 #include "interfaces/filesystem_parser.h"
 #include "interfaces/file_carver.h"
+#include "interfaces/result_sink.h"
 
 namespace FileRecovery {
 
@@ -39,6 +50,9 @@ public:
     
     /**
      * @brief Stop the recovery process
+     * 
+     * Also stops a run that has not started yet: once stopped, the engine
+     * scans nothing more, and a new engine is needed for another run.
      */
     void stopRecovery();
     
@@ -56,22 +70,97 @@ public:
     
     /**
      * @brief Get the number of files recovered so far
-     * @return Number of recovered files
+     * @return Number of distinct files found (saved or not)
      */
-    size_t getRecoveredFileCount() const { return recovered_files_.size(); }
+    size_t getRecoveredFileCount() const { return recovered_count_; }
     
     /**
-     * @brief Get all recovered files
-     * @return Vector of recovered files
+     * @brief Get all recovered files, sorted by offset
+     * 
+     * Results are streamed to disk and to result sinks as they are found
+     * and are only retained here when config.keep_recovered_files is set.
+     * 
+     * @return Vector of recovered files (empty unless retention is enabled)
      */
     const std::vector<RecoveredFile>& getRecoveredFiles() const { return recovered_files_; }
     
     /**
-     * @brief Add a custom file carver
+     * @brief Get read-ahead counters from the last signature scan
+     * @return Pipeline statistics (zeroed before the first scan)
+     */
+    const PipelineStats& getPipelineStats() const { return pipeline_stats_; }
+    
+    /**
+     * @brief Get the number of bytes written to recovered files by the last run
+     */
+    Size getBytesExtracted() const { return bytes_extracted_; }
+    
+    /**
+     * @brief Get the number of bytes of uniform filler skipped by the last scan
+     * @return Bytes of zeroed or single-value blocks that were not carved
+     */
+    Size getUniformBytesSkipped() const { return uniform_bytes_skipped_; }
+    
+    /**
+     * @brief Get the number of bytes read past their chunks to finish spanning files
+     * @return Bytes read by the footer search and final carve of the last scan
+     */
+    Size getSpanBytesRead() const { return span_bytes_read_; }
+    
+    /**
+     * @brief Get the number of chunks the last scan could not read
+     * 
+     * Such chunks are not recorded in the checkpoint, which is kept after
+     * the run so that a resumed run reads them again.
+     */
+    size_t getFailedChunkCount() const { return failed_chunks_; }
+    
+    /**
+     * @brief Make matching device reads fail with EIO (for tests)
+     * @param hook Predicate called for every raw device read (empty to clear)
+     */
+    void setReadFaultHook(ReadFaultHook hook) { disk_scanner_->setReadFaultHook(std::move(hook)); }
+    
+    /**
+     * @brief Get the spacing of the device offsets the last scan searched for headers
+     * @return 1 if headers were searched at every byte
+     */
+    Size getHeaderAlignment() const { return header_alignment_; }
+    
+    /**
+     * @brief Add a custom file carver to this engine's scans
+     * 
+     * Like the registered carvers, it only runs if it supports one of
+     * config.target_file_types, or if no types were requested. Carvers
+     * every engine should use are registered with CarverRegistry instead.
+     * 
      * @param carver Unique pointer to the carver
      */
     void addFileCarver(std::unique_ptr<FileCarver> carver);
     
+    /**
+     * @brief Run on workers and read slots shared with other engines
+     * 
+     * The engine then creates no pools of its own: its carve and
+     * extraction tasks go through the shared fair queues and its reads
+     * through the shared I/O scheduler. config.num_threads,
+     * extraction_threads and numa_aware are not used.
+     * 
+     * @param shared Scheduler shared by all engines of a batch
+     */
+    void setSharedScheduler(const SharedScheduler& shared);
+    
+    /**
+     * @brief Get the number of recovered files written to the output directory
+     */
+    size_t getSavedFileCount() const { return saved_count_; }
+    
+    /**
+     * @brief Add a sink that receives each recovered file as it is saved
+     * @param sink Unique pointer to the sink
+     */
+    void addResultSink(std::unique_ptr<ResultSink> sink);
+    
     /**
      * @brief Add a custom file system parser
      * @param parser Unique pointer to the parser
@@ -87,20 +176,53 @@ public:
 private:
     ScanConfig config_;
     std::unique_ptr<DiskScanner> disk_scanner_;
-    std::vector<std::unique_ptr<FileCarver>> file_carvers_;
+    std::vector<std::unique_ptr<FileCarver>> file_carvers_;  // Added with addFileCarver()
+    ScanPlan scan_plan_;                            // Carvers selected for the current run
     std::vector<std::unique_ptr<FilesystemParser>> filesystem_parsers_;
+    std::vector<std::unique_ptr<ResultSink>> result_sinks_;
     std::vector<RecoveredFile> recovered_files_;
+    PipelineStats pipeline_stats_;
     
     std::atomic<bool> is_running_;
     std::atomic<bool> should_stop_;
     std::atomic<double> current_progress_;
+    Size uniform_bytes_skipped_;
+    std::atomic<Size> span_bytes_read_;             // Read by extendSpanningFile() in the last scan
+    std::mutex span_mutex_;                         // One spanning file's data is held at a time
+    std::atomic<size_t> failed_chunks_;             // Chunk reads of the last scan that failed
+    Size header_alignment_;                         // Headers are searched at multiples of this, 1 = every byte
     std::function<void(double, const std::string&)> progress_callback_;
     
     mutable std::mutex results_mutex_;
-    std::vector<std::thread> worker_threads_;
+    std::set<std::pair<Offset, Size>> seen_files_;  // Dedup keys at or past the scan watermark
+    std::atomic<size_t> recovered_count_;
+    std::atomic<size_t> saved_count_;
+    std::shared_ptr<ThreadPool> thread_pool_;       // Scanning and carving
+    std::vector<std::pair<int, size_t>> node_workers_;  // (NUMA node, scan workers) when NUMA-aware, else empty
+    std::shared_ptr<ThreadPool> extraction_pool_;   // Writing recovered files
+    std::unique_ptr<SharedScheduler> shared_scheduler_;  // Set for batch runs, else null
+    std::unique_ptr<TaskGroup> scan_tasks_;         // This run's tasks on thread_pool_
+    std::unique_ptr<TaskGroup> extraction_tasks_;   // This run's tasks on extraction_pool_
+    std::unique_ptr<ScanTuner> tuner_;              // Null unless auto_tune is set
+    size_t tuned_workers_;                          // Carvers calibration chose to start with
+    
+    std::mutex extraction_mutex_;
+    std::condition_variable extraction_cv_;
+    size_t pending_saves_;                          // Queued on extraction_pool_, guarded by extraction_mutex_
+    std::atomic<Size> bytes_extracted_;
+    
+    // Checkpointing tracks work units: unit 0 is metadata recovery and
+    // unit i + 1 is chunk i of the signature scan. A unit is recorded as
+    // complete once it has produced all its files and every one of them
+    // is in the result journal.
+    std::unique_ptr<ScanCheckpoint> checkpoint_;    // Null when checkpoints are disabled
+    std::mutex checkpoint_mutex_;
+    std::vector<size_t> unit_pending_;              // Producer + unsaved files per unit, guarded by checkpoint_mutex_
+    std::vector<std::pair<Offset, Size>> unit_ranges_;  // Device range each chunk unit owns
+    std::chrono::steady_clock::time_point last_checkpoint_;
     
     /**
-     * @brief Initialize all default carvers and parsers
+     * @brief Initialize all default parsers; carvers come from the CarverRegistry
      */
     void initializeDefaultModules();
     
@@ -112,29 +234,122 @@ private:
     
     /**
      * @brief Perform signature-based recovery
-     * @return Vector of files recovered using signatures
+     * 
+     * Files are handed to emitFile() chunk by chunk as they are carved.
+     * 
+     * @return Number of candidate files carved
+     */
+    size_t performSignatureRecovery();
+    
+    /**
+     * @brief Run every carver over one chunk of device data
+     * @param data Chunk data
+     * @param size Number of valid bytes in the chunk
+     * @param base_offset Device offset of the first byte of the chunk
+     * @param hits Receives every stage's signature and footer offsets in the chunk
+     * @return Files carved from this chunk
+     */
+    std::vector<RecoveredFile> carveChunk(const Byte* data, Size size, Offset base_offset,
+                                          std::vector<SignatureHits>& hits);
+    
+    /**
+     * @brief Keep the files a chunk owns and finish the ones its read window cut off
+     * 
+     * Files starting in the overlap past chunk_end are dropped; the next
+     * chunk carves them. A header inside the chunk with none of its
+     * carver's footers between it and the carver's next header in the
+     * window may continue past the window, so it is handed to
+     * extendSpanningFile().
+     * 
+     * @param files Files carved from the window, updated in place
+     * @param hits Signature and footer offsets carveChunk() found in the window
+     * @param size Number of valid bytes in the window
+     * @param base_offset Device offset of the first byte of the window
+     * @param chunk_end Device offset where the chunk proper (without overlap) ends
+     * @param window_end Device offset where the chunk's read window ends
      */
-    std::vector<RecoveredFile> performSignatureRecovery();
+    void completeSpanningFiles(std::vector<RecoveredFile>& files, const std::vector<SignatureHits>& hits,
+                               Size size, Offset base_offset, Offset chunk_end, Offset window_end);
     
     /**
-     * @brief Worker function for multithreaded signature scanning
-     * @param chunk_start Start offset of the chunk
-     * @param chunk_size Size of the chunk to scan
-     * @param thread_id Thread identifier
+     * @brief Re-carve a file from its header once its footer is found past the chunk
+     * 
+     * The device after the bytes already seen is searched for the stage's
+     * footers one chunk-sized window at a time, each byte read once, up to
+     * config_.max_span_extension bytes from the header or the carver's
+     * largest file size if smaller. The carver then runs once on the data
+     * from the header to just past the window holding the footer; workers
+     * take turns at this step, so only one such buffer exists per engine.
+     * 
+     * @param file File with start_offset set; receives the carved file
+     * @param stage Index of the plan stage whose signature matched at start_offset
+     * @param seen Number of bytes from the header the carver has already seen
+     * @return true if a footer was found and the carver accepted a file at start_offset
      */
-    void scanChunkWorker(Offset chunk_start, Size chunk_size, int thread_id);
+    bool extendSpanningFile(RecoveredFile& file, size_t stage, Size seen);
+    
+    /**
+     * @brief Select the carvers for config_.target_file_types
+     * @return false if types were requested and no carver supports any of them
+     */
+    bool buildScanPlan();
+    
+    /**
+     * @brief Work out where headers are searched for
+     * 
+     * Uses config_.header_alignment, or with align_headers_to_clusters the
+     * cluster size of the filesystem at the start of the device. FAT data
+     * areas are not cluster aligned, so FAT volumes use the sector size,
+     * as do devices without a recognized filesystem.
+     * 
+     * @return Alignment in bytes, 1 for every byte
+     */
+    Size resolveHeaderAlignment();
     
     /**
      * @brief Save a recovered file to disk
+     * 
+     * The file is copied with DiskScanner::copyToFd(), so memory use does
+     * not grow with the file size.
+     * 
      * @param file Recovered file information
      * @return true if file was saved successfully
      */
     bool saveRecoveredFile(const RecoveredFile& file);
     
     /**
-     * @brief Deduplicate recovered files (remove duplicates)
+     * @brief Deduplicate a result and queue it on the extraction stage
+     * 
+     * Blocks while the extraction stage is MAX_PENDING_SAVES files behind,
+     * so a scan that outruns the output device cannot queue without bound.
+     * 
+     * @param file Recovered file
+     * @param unit Checkpoint work unit that produced the file
+     * @return true if the file was new, false if it duplicated an earlier result
      */
-    void deduplicateFiles();
+    bool emitFile(const RecoveredFile& file, size_t unit);
+    
+    /**
+     * @brief Create or resume the checkpoint named by config.checkpoint_path
+     * @return false if a requested resume is impossible
+     */
+    bool openCheckpoint();
+    
+    /**
+     * @brief Drop one outstanding item of a work unit and record the unit once none are left
+     * 
+     * Units finishing after a stop request are not recorded, since their
+     * chunk may have been carved partially or their files left unsaved.
+     * 
+     * @param unit Work unit index
+     */
+    void finishUnitWork(size_t unit);
+    
+    /**
+     * @brief Forget dedup keys below the scan watermark
+     * @param watermark No result starting below this offset can still arrive
+     */
+    void pruneSeenFiles(Offset watermark);
     
     /**
      * @brief Update progress and call callback if set
@@ -143,6 +358,28 @@ private:
      */
     void updateProgress(double progress, const std::string& status_message);
     
+    /**
+     * @brief Place scan workers on the NUMA nodes, one pinned core each
+     * 
+     * Uses config.threads_per_node workers per node if set, otherwise
+     * spreads config.num_threads over the nodes, otherwise one worker per
+     * allowed core.
+     * 
+     * @return Placement of every scan worker, grouped by node
+     */
+    std::vector<WorkerPlacement> planNumaWorkers();
+    
+    /**
+     * @brief Calibrate chunk size, I/O depth and worker count for the device
+     * 
+     * Sets config_.chunk_size and config_.io_queue_depth to the measured
+     * values. A resumed scan keeps the chunk size recorded in its
+     * checkpoint so the completed chunks still line up.
+     * 
+     * @param max_workers Scan workers in the pool, the most that may carve at once
+     */
+    void tuneScan(size_t max_workers);
+    
     /**
      * @brief Get optimal number of threads for current system
      * @return Number of threads to use
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include "utils/types.h"
+
+namespace FileRecovery {
+
+/**
+ * @brief On-disk progress of a scan, for resuming an interrupted run
+ *
+ * A checkpoint is two files. The checkpoint file itself is small text
+ * written atomically (temporary file + rename): a header with the hash
+ * of the configuration that produced it, the committed length of the
+ * result journal and whether metadata recovery finished, followed by
+ * the completed device ranges as "offset length" lines, kept merged.
+ * The result journal next to it ("<path>.results") gets one line per
+ * recovered file as the file is saved, so the result index is never
+ * held in memory.
+ *
+ * On load the journal is cut back to the committed length and to the
+ * results of completed work, so a resumed scan redoes exactly the work
+ * that had not been recorded as complete.
+ */
+class ScanCheckpoint {
+public:
+    /**
+     * @brief Constructor
+     * @param path Checkpoint file path
+     * @param config_hash Hash of the configuration, see hashConfig()
+     * @param chunk_size Chunk size of the scan, recorded for readChunkSize(); 0 to leave out
+     */
+    ScanCheckpoint(const std::string& path, uint64_t config_hash, Size chunk_size = 0);
+
+    /**
+     * @brief Destructor - closes the journal without writing a checkpoint
+     */
+    ~ScanCheckpoint();
+
+    ScanCheckpoint(const ScanCheckpoint&) = delete;
+    ScanCheckpoint& operator=(const ScanCheckpoint&) = delete;
+
+    /**
+     * @brief Hash the settings that decide which chunks are scanned and what they yield
+     * @param config Scan configuration
+     * @param device_size Size of the scanned device
+     * @param header_alignment Resolved spacing of the offsets searched for
+     *                         headers, 1 for every byte
+     * @return 64-bit FNV-1a hash
+     */
+    static uint64_t hashConfig(const ScanConfig& config, Size device_size, Size header_alignment);
+
+    /**
+     * @brief Read the chunk size recorded in a checkpoint file
+     *
+     * Lets a tuned scan resume with the chunk layout it was interrupted
+     * in instead of calibrating a new one.
+     *
+     * @param path Checkpoint file path
+     * @return Recorded chunk size, 0 if there is none
+     */
+    static Size readChunkSize(const std::string& path);
+
+    /**
+     * @brief Start an empty checkpoint, replacing any existing one
+     * @return true if the journal and checkpoint file were created
+     */
+    bool create();
+
+    /**
+     * @brief Load an existing checkpoint and reopen its journal for appending
+     * @return true if the checkpoint exists and matches the configuration hash
+     */
+    bool load();
+
+    /**
+     * @brief Write the checkpoint file, after syncing the journal it refers to
+     * @return true if the file was written
+     */
+    bool save();
+
+    /**
+     * @brief Delete the checkpoint and its journal
+     */
+    void remove();
+
+    /**
+     * @brief Record a device range whose results are all in the journal
+     */
+    void markCompleted(Offset offset, Size size);
+
+    /**
+     * @brief Check whether a range lies entirely inside completed ranges
+     */
+    bool isCompleted(Offset offset, Size size) const;
+
+    /**
+     * @brief Total number of bytes in completed ranges
+     */
+    Size getCompletedBytes() const;
+
+    /**
+     * @brief Record that every metadata-recovered file is in the journal
+     */
+    void markMetadataDone();
+
+    /**
+     * @brief Check whether metadata recovery finished in an earlier run
+     */
+    bool isMetadataDone() const;
+
+    /**
+     * @brief Append one result to the journal
+     * @param file Recovered file
+     * @param saved true if the file was written to the output directory
+     * @param from_metadata true if the file came from metadata recovery
+     * @return true if the line was written
+     */
+    bool recordResult(const RecoveredFile& file, bool saved, bool from_metadata);
+
+    /**
+     * @brief Read the journaled results back one at a time
+     * @param callback Called with each result, whether it was saved and whether it came from metadata
+     * @return true if the journal could be read
+     */
+    bool forEachResult(const std::function<void(const RecoveredFile&, bool, bool)>& callback) const;
+
+    /**
+     * @brief Number of results in the journal
+     */
+    size_t getResultCount() const;
+
+    /**
+     * @brief Number of journaled results that were saved
+     */
+    size_t getSavedCount() const;
+
+    /**
+     * @brief Get the checkpoint file path
+     */
+    const std::string& getPath() const { return path_; }
+
+private:
+    std::string path_;
+    std::string journal_path_;
+    uint64_t config_hash_;
+    Size chunk_size_;
+
+    mutable std::mutex mutex_;
+    std::map<Offset, Offset> completed_;    // start -> end (exclusive)
+    bool metadata_done_;
+    int journal_fd_;
+    Size journal_bytes_;
+    size_t result_count_;
+    size_t saved_count_;
+
+    /**
+     * @brief Open the journal for appending, optionally truncating it
+     */
+    bool openJournal(bool truncate);
+
+    /**
+     * @brief Keep the first journal_bytes_ of the journal and only the results of completed work
+     */
+    bool compactJournal();
+
+    /**
+     * @brief Write the checkpoint file; mutex_ must be held
+     */
+    bool writeCheckpointFile();
+};
+
+} // namespace FileRecovery
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include "utils/thread_pool.h"
+#include "utils/task_group.h"
+
+namespace FileRecovery {
+
+/**
+ * @brief Limits how many read batches are in flight across several scans
+ *
+ * Readers are served first come, first served: a reader that asks for a
+ * slot while others are waiting queues behind them, so one scan cannot
+ * keep the slots to itself by asking again straight after each batch.
+ */
+class IoScheduler {
+public:
+    /**
+     * @brief Constructor
+     * @param slots Read batches allowed in flight at once (at least one)
+     */
+    explicit IoScheduler(size_t slots);
+
+    IoScheduler(const IoScheduler&) = delete;
+    IoScheduler& operator=(const IoScheduler&) = delete;
+
+    /**
+     * @brief Wait for a free slot in arrival order and take it
+     */
+    void acquire();
+
+    /**
+     * @brief Give a slot back
+     */
+    void release();
+
+    /**
+     * @brief Number of slots
+     */
+    size_t getSlots() const { return slots_; }
+
+private:
+    size_t slots_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    uint64_t next_ticket_;      // Guarded by mutex_
+    uint64_t now_serving_;      // Guarded by mutex_
+    size_t in_use_;             // Guarded by mutex_
+};
+
+/**
+ * @brief Workers and read slots shared by the engines of a batch run
+ *
+ * An engine given a SharedScheduler runs its carve and extraction tasks
+ * through the fair queues instead of sizing pools of its own, and its
+ * reader takes a slot from the I/O scheduler for every batch.
+ */
+struct SharedScheduler {
+    std::shared_ptr<ThreadPool> scan_pool;
+    std::shared_ptr<FairTaskQueue> scan_queue;
+    std::shared_ptr<ThreadPool> extraction_pool;
+    std::shared_ptr<FairTaskQueue> extraction_queue;
+    std::shared_ptr<IoScheduler> io;
+
+    /**
+     * @brief Create the pools, their fair queues and the I/O scheduler
+     * @param scan_threads Carve workers
+     * @param extraction_threads Workers writing recovered files
+     * @param io_slots Read batches in flight across all scans
+     * @return Shared scheduler
+     */
+    static SharedScheduler create(size_t scan_threads, size_t extraction_threads, size_t io_slots);
+};
+
+} // namespace FileRecovery
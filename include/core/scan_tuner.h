@@ -0,0 +1,127 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include "utils/types.h"
+#include "core/read_ahead_pipeline.h"
+
+namespace FileRecovery {
+
+class DiskScanner;
+
+/**
+ * @brief Scan parameters chosen by calibration and what they were based on
+ */
+struct TuningResult {
+    Size chunk_size;
+    unsigned io_depth;
+    size_t workers;
+    double read_mbps;           ///< Read throughput at the chosen chunk size
+    double carve_ns_per_byte;   ///< Time one worker spends carving a byte
+    bool calibrated;            ///< false if the device was too small to sample
+
+    TuningResult()
+        : chunk_size(DEFAULT_CHUNK_SIZE), io_depth(1), workers(1),
+          read_mbps(0.0), carve_ns_per_byte(0.0), calibrated(false) {}
+
+    /**
+     * @brief One-line summary of the measurements and the chosen values
+     */
+    std::string describe() const;
+};
+
+/**
+ * @brief Picks chunk size, I/O depth and worker count for a device and keeps them tuned
+ *
+ * calibrate() reads sample regions spread over the device with each
+ * candidate chunk size, takes the smallest size that reaches most of the
+ * best throughput, and times the carvers on the sampled data. The worker
+ * count is the number of carvers needed to keep up with the reads.
+ *
+ * During the scan, adjust() looks at the read-ahead pipeline's stall
+ * counters: when the reader waits on a full ring another carver is let
+ * in, and when carvers wait for data one is parked and more reads are
+ * kept in flight. The engine only queues a carve task once
+ * tryBeginCarve() grants it a slot, and endCarve() returns the slot, so a
+ * parked worker goes back to the pool instead of waiting for this scan.
+ * That matters when the pool is shared with other images in batch mode.
+ */
+class ScanTuner {
+public:
+    using CarveFunction = std::function<void(const Byte* data, Size size, Offset offset)>;
+
+    /**
+     * @brief Constructor
+     * @param scanner Initialized scanner to sample
+     * @param max_workers Upper bound for the worker count
+     */
+    ScanTuner(DiskScanner& scanner, size_t max_workers);
+
+    /**
+     * @brief Measure the device and the carvers and pick the scan parameters
+     * @param carve Runs every carver over a buffer
+     * @param fixed_chunk_size Chunk size to keep instead of choosing one, 0 to choose
+     * @return Chosen parameters
+     */
+    TuningResult calibrate(const CarveFunction& carve, Size fixed_chunk_size = 0);
+
+    /**
+     * @brief Reset the in-run state before a scan
+     * @param workers Carvers allowed to run at once
+     * @param io_depth Reads the pipeline submits per batch
+     */
+    void startRun(size_t workers, unsigned io_depth);
+
+    /**
+     * @brief Re-tune from the pipeline's counters
+     *
+     * Does nothing until ADJUST_INTERVAL has passed since the previous
+     * adjustment. Thread-safe.
+     *
+     * @param stats Current pipeline counters
+     * @return true if the worker count or I/O depth changed
+     */
+    bool adjust(const PipelineStats& stats);
+
+    /**
+     * @brief Count a carver in if fewer than the active worker count are carving
+     * @return false if every slot is taken; the caller queues no task then
+     */
+    bool tryBeginCarve();
+
+    /**
+     * @brief Count a carver out
+     */
+    void endCarve();
+
+    /**
+     * @brief Number of carvers currently allowed to run at once
+     */
+    size_t getActiveWorkers() const;
+
+    /**
+     * @brief Reads per pipeline batch currently chosen
+     */
+    unsigned getIoDepth() const;
+
+    /**
+     * @brief Number of adjustments made during the current run
+     */
+    size_t getAdjustmentCount() const;
+
+private:
+    DiskScanner& scanner_;
+    size_t max_workers_;
+
+    mutable std::mutex mutex_;
+    size_t active_workers_;             // Guarded by mutex_
+    size_t carving_;                    // Guarded by mutex_
+    unsigned io_depth_;                 // Guarded by mutex_
+    size_t adjustments_;                // Guarded by mutex_
+    PipelineStats last_stats_;          // Guarded by mutex_
+    std::chrono::steady_clock::time_point last_adjust_;   // Guarded by mutex_
+};
+
+} // namespace FileRecovery
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "utils/types.h"
+
+namespace FileRecovery {
+
+/**
+ * @brief Ordered set of raw image segments (image.001, image.002, ...) read as one device
+ *
+ * Segments are concatenated in numeric order into a single contiguous
+ * address space. Reads are positional, so the object is safe to share
+ * between threads once opened.
+ */
+class SegmentedImage {
+public:
+    /**
+     * @brief One segment file and its place in the virtual device
+     */
+    struct Segment {
+        std::string path;
+        int fd;
+        Offset start;   ///< Offset of the segment's first byte in the virtual device
+        Size size;
+    };
+
+    /**
+     * @brief A piece of a virtual read that falls inside one segment
+     */
+    struct Piece {
+        int fd;
+        Offset file_offset;     ///< Offset within the segment file
+        Size size;
+        Size buffer_offset;     ///< Offset within the caller's buffer
+    };
+
+    SegmentedImage() = default;
+
+    /**
+     * @brief Destructor - closes all segment files
+     */
+    ~SegmentedImage();
+
+    SegmentedImage(const SegmentedImage&) = delete;
+    SegmentedImage& operator=(const SegmentedImage&) = delete;
+
+    /**
+     * @brief List the segment set that starts with the given file
+     *
+     * A path whose extension is all digits (e.g. "disk.001") is followed
+     * by its numbered siblings of the same width for as long as they
+     * exist ("disk.002", "disk.003", ...).
+     *
+     * @param first_path Path of the first segment
+     * @return Segment paths in order; fewer than two means "not segmented"
+     */
+    static std::vector<std::string> findSegments(const std::string& first_path);
+
+    /**
+     * @brief Open every segment read-only
+     * @param paths Segment paths in order
+     * @return true if all segments were opened and sized
+     */
+    bool open(const std::vector<std::string>& paths);
+
+    /**
+     * @brief Total size of all segments
+     */
+    Size getTotalSize() const { return total_size_; }
+
+    /**
+     * @brief Get the opened segments
+     */
+    const std::vector<Segment>& getSegments() const { return segments_; }
+
+    /**
+     * @brief Split a virtual range into per-segment pieces
+     * @param offset Virtual offset
+     * @param size Number of bytes (clamped to the total size)
+     * @return Pieces in ascending order
+     */
+    std::vector<Piece> split(Offset offset, Size size) const;
+
+    /**
+     * @brief Read a virtual range, crossing segment boundaries as needed
+     * @param error Receives errno of a failed read, 0 otherwise
+     * @return Number of bytes read before the first error or short segment
+     */
+    Size read(Offset offset, Size size, Byte* buffer, int* error) const;
+
+private:
+    std::vector<Segment> segments_;
+    Size total_size_ = 0;
+
+    void closeAll();
+};
+
+} // namespace FileRecovery
@@ -6,6 +6,18 @@
 
 namespace FileRecovery {
 
+/**
+ * @brief Where a carver's signatures and footers occur in a chunk
+ *
+ * Offsets are relative to the chunk data, ascending and listed once.
+ * Footers are recorded by where they end, so carvers with several
+ * footers sharing a suffix (PDF's "%%EOF" variants) see one end each.
+ */
+struct SignatureHits {
+    std::vector<Offset> headers;        ///< Start of each getFileSignatures() match
+    std::vector<Offset> footer_ends;    ///< One past the end of each getFileFooters() match
+};
+
 /**
  * @brief Base interface for file carvers
  * 
@@ -47,6 +59,31 @@ public:
         Offset base_offset
     ) = 0;
     
+    /**
+     * @brief Carve files whose headers and footers were already located
+     *
+     * Called by the scan with the carver's signature and footer offsets,
+     * found by one search shared by all carvers, so a carver can look up
+     * where a file ends instead of scanning for it. Carvers that search
+     * for themselves can rely on this default, which ignores the hits and
+     * calls carveFiles().
+     *
+     * @param data Pointer to raw data
+     * @param size Size of the data
+     * @param base_offset Base offset in the disk for this chunk
+     * @param hits Signature and footer offsets in data
+     * @return Vector of recovered files found in this chunk
+     */
+    virtual std::vector<RecoveredFile> carveFilesAt(
+        const Byte* data,
+        Size size,
+        Offset base_offset,
+        const SignatureHits& hits
+    ) {
+        (void)hits;
+        return carveFiles(data, size, base_offset);
+    }
+    
     /**
      * @brief Validate if a recovered file is likely valid
      * @param file The recovered file to validate
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "utils/types.h"
+
+namespace FileRecovery {
+
+/**
+ * @brief Receiver for recovery results as they are produced
+ *
+ * The recovery engine streams every deduplicated file to its sinks as
+ * soon as the file has been written out, instead of collecting all
+ * results until the end of the run. Sinks are called from worker
+ * threads and must be thread-safe.
+ */
+class ResultSink {
+public:
+    virtual ~ResultSink() = default;
+
+    /**
+     * @brief Receive one recovered file
+     * @param file Recovered file information
+     * @param saved true if the file was written to the output directory
+     */
+    virtual void onFileRecovered(const RecoveredFile& file, bool saved) = 0;
+
+    /**
+     * @brief Called once after the last file of a run has been delivered
+     * @param file_count Number of files delivered during the run
+     */
+    virtual void onRecoveryFinished(size_t file_count) { (void)file_count; }
+};
+
+} // namespace FileRecovery
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include "utils/types.h"
+
+namespace FileRecovery {
+
+/**
+ * @brief Thread-safe pool of reusable, alignment-guaranteed buffers
+ *
+ * Direct I/O requires the destination buffer, offset and length to be
+ * aligned to the device's logical block size. Allocating such buffers
+ * for every read is expensive, so released buffers are kept and handed
+ * out again to later requests of the same or smaller capacity.
+ */
+class AlignedBufferPool {
+public:
+    /**
+     * @brief Move-only handle to a pooled buffer; returns it on destruction
+     */
+    class Buffer {
+    public:
+        Buffer() : pool_(nullptr), data_(nullptr), capacity_(0) {}
+        Buffer(AlignedBufferPool* pool, Byte* data, Size capacity)
+            : pool_(pool), data_(data), capacity_(capacity) {}
+        ~Buffer() { reset(); }
+
+        Buffer(Buffer&& other) noexcept
+            : pool_(other.pool_), data_(other.data_), capacity_(other.capacity_) {
+            other.pool_ = nullptr;
+            other.data_ = nullptr;
+            other.capacity_ = 0;
+        }
+
+        Buffer& operator=(Buffer&& other) noexcept {
+            if (this != &other) {
+                reset();
+                pool_ = other.pool_;
+                data_ = other.data_;
+                capacity_ = other.capacity_;
+                other.pool_ = nullptr;
+                other.data_ = nullptr;
+                other.capacity_ = 0;
+            }
+            return *this;
+        }
+
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+
+        Byte* data() const { return data_; }
+        Size capacity() const { return capacity_; }
+        explicit operator bool() const { return data_ != nullptr; }
+
+        /**
+         * @brief Return the buffer to its pool early
+         */
+        void reset() {
+            if (pool_ && data_) {
+                pool_->release(data_, capacity_);
+            }
+            pool_ = nullptr;
+            data_ = nullptr;
+            capacity_ = 0;
+        }
+
+    private:
+        AlignedBufferPool* pool_;
+        Byte* data_;
+        Size capacity_;
+    };
+
+    /**
+     * @brief Constructor
+     * @param alignment Buffer address and capacity alignment (power of two)
+     * @param max_cached Maximum number of idle buffers kept for reuse
+     */
+    explicit AlignedBufferPool(Size alignment = BLOCK_SIZE_4K, size_t max_cached = 64);
+
+    /**
+     * @brief Destructor - frees all idle buffers
+     *
+     * Outstanding Buffer handles must be released before the pool dies.
+     */
+    ~AlignedBufferPool();
+
+    AlignedBufferPool(const AlignedBufferPool&) = delete;
+    AlignedBufferPool& operator=(const AlignedBufferPool&) = delete;
+
+    /**
+     * @brief Get a buffer of at least size bytes
+     * @param size Minimum capacity (rounded up to the alignment)
+     * @return Buffer handle, empty if allocation failed
+     */
+    Buffer acquire(Size size);
+
+    /**
+     * @brief Get the alignment guaranteed for every buffer
+     */
+    Size getAlignment() const { return alignment_; }
+
+    /**
+     * @brief Number of allocations served from the idle list
+     */
+    size_t getReuseCount() const;
+
+    /**
+     * @brief Round a value up to the pool alignment
+     */
+    Size alignUp(Size value) const { return (value + alignment_ - 1) & ~(alignment_ - 1); }
+
+    /**
+     * @brief Round a value down to the pool alignment
+     */
+    Size alignDown(Size value) const { return value & ~(alignment_ - 1); }
+
+private:
+    Size alignment_;
+    size_t max_cached_;
+    mutable std::mutex mutex_;
+    std::multimap<Size, Byte*> idle_;   // capacity -> buffer
+    size_t reuse_count_;
+
+    void release(Byte* data, Size capacity);
+};
+
+} // namespace FileRecovery
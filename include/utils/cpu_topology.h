@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "utils/types.h"
+
+namespace FileRecovery {
+
+/**
+ * @brief One NUMA node and the CPUs of it this process may run on
+ */
+struct NumaNode {
+    int id;
+    std::vector<int> cpus;
+
+    NumaNode() : id(0) {}
+};
+
+/**
+ * @brief NUMA topology discovery, thread pinning and memory placement
+ *
+ * The topology is read from sysfs and pinning and placement go through
+ * plain syscalls, so no NUMA library is needed. On machines without
+ * NUMA information every allowed CPU is reported as node 0.
+ */
+class CpuTopology {
+public:
+    /**
+     * @brief Get the NUMA nodes that have CPUs this process may use
+     * @return Nodes ordered by id, never empty
+     */
+    static std::vector<NumaNode> detectNodes();
+
+    /**
+     * @brief Parse a kernel CPU list such as "0-3,8,10-11"
+     * @param list CPU list text
+     * @return CPU numbers in ascending order
+     */
+    static std::vector<int> parseCpuList(const std::string& list);
+
+    /**
+     * @brief Restrict the calling thread to a set of CPUs
+     * @param cpus CPUs the thread may run on
+     * @return true if the affinity was set
+     */
+    static bool pinCurrentThread(const std::vector<int>& cpus);
+
+    /**
+     * @brief Place a buffer's pages on a NUMA node, moving pages already touched
+     * @param address Page-aligned buffer address
+     * @param size Buffer size in bytes
+     * @param node Target node id
+     * @return true if the kernel accepted the policy
+     */
+    static bool bindMemory(void* address, Size size, int node);
+};
+
+} // namespace FileRecovery
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "utils/types.h"
+
+namespace FileRecovery {
+
+/**
+ * @brief Finds many byte patterns in one pass over the data
+ *
+ * An Aho-Corasick automaton compiled into a dense transition table, so
+ * each input byte costs one table lookup however many patterns there
+ * are. Runs of bytes that cannot start a pattern are skipped with a
+ * vectorized search. Every pattern carries a tag chosen by the caller (a carver's
+ * index in a scan plan, say) and matches are reported per tag.
+ */
+class MultiPatternMatcher {
+public:
+    MultiPatternMatcher();
+
+    /**
+     * @brief Add a pattern; the matcher must be rebuilt before the next scan
+     * @param pattern Bytes to look for (empty patterns are ignored)
+     * @param tag Group the pattern's matches are reported under
+     */
+    void addPattern(const std::vector<Byte>& pattern, size_t tag);
+
+    /**
+     * @brief Compile the added patterns into the transition table
+     */
+    void build();
+
+    /**
+     * @brief Find every occurrence of every pattern
+     *
+     * Overlapping matches are all reported; each tag lists an offset
+     * once even if several of its patterns start there.
+     *
+     * @param data Data to search in
+     * @param size Size of the data
+     * @param hits Resized to getTagCount(); hits[tag] receives the start
+     *             offsets of that tag's matches in ascending order
+     */
+    void findAll(const Byte* data, Size size, std::vector<std::vector<Offset>>& hits) const;
+
+    /**
+     * @brief Find the patterns that start at evenly spaced offsets only
+     *
+     * Only the bytes of candidate matches are read, so the cost depends
+     * on the number of offsets checked rather than on the data size.
+     *
+     * @param data Data to search in
+     * @param size Size of the data
+     * @param first First offset to check
+     * @param stride Distance between checked offsets (at least 1)
+     * @param hits As for findAll()
+     */
+    void findAllAligned(const Byte* data, Size size, Size first, Size stride,
+                        std::vector<std::vector<Offset>>& hits) const;
+
+    /**
+     * @brief Number of tags, one more than the largest tag added
+     */
+    size_t getTagCount() const { return tag_count_; }
+
+    /**
+     * @brief Number of automaton states, for diagnostics
+     */
+    size_t getStateCount() const { return outputs_begin_.size() - 1; }
+
+    /**
+     * @brief Check whether no pattern was added
+     */
+    bool empty() const { return patterns_.empty(); }
+
+private:
+    struct Pattern {
+        std::vector<Byte> bytes;
+        size_t tag;
+    };
+
+    // A match ending at the current byte: tag and pattern length
+    struct Output {
+        uint32_t tag;
+        uint32_t length;
+    };
+
+    std::vector<Pattern> patterns_;
+    size_t tag_count_;
+
+    std::vector<uint32_t> transitions_;     // [state * 256 + byte]: target state * 256, flagged if it has outputs
+    std::vector<uint32_t> outputs_begin_;   // Per state plus an end marker, into outputs_
+    std::vector<Output> outputs_;
+    std::vector<Byte> start_bytes_;         // First bytes of all patterns
+    std::vector<uint32_t> depths_;          // Per state, length of the trie path to it
+};
+
+} // namespace FileRecovery
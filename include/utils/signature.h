@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <cstring>
+#include <vector>
+#include "utils/types.h"
+
+namespace FileRecovery {
+
+/**
+ * @brief A byte pattern whose length is known at compile time
+ */
+template <size_t Length>
+using Signature = std::array<Byte, Length>;
+
+/**
+ * @brief Several patterns of one length, such as the header variants of a format
+ */
+template <size_t Count, size_t Length>
+using SignatureTable = std::array<Signature<Length>, Count>;
+
+/**
+ * @brief Matching helpers for compile-time signatures
+ *
+ * The pattern length is a template parameter, so each comparison is a
+ * fixed-size compare the compiler can inline, and none of the helpers
+ * allocate. Carvers keep their signatures as constexpr tables and only
+ * build the byte vectors of the FileCarver interface when asked.
+ */
+class SignatureUtils {
+public:
+    /**
+     * @brief Check whether data starts with a signature
+     * @param data Data to check
+     * @param size Size of the data
+     * @param signature Signature to compare with
+     * @return true if the first bytes of data are the signature
+     */
+    template <size_t Length>
+    static bool startsWith(const Byte* data, Size size, const Signature<Length>& signature) {
+        return size >= Length && std::memcmp(data, signature.data(), Length) == 0;
+    }
+
+    /**
+     * @brief Check whether data starts with any signature of a table
+     * @param data Data to check
+     * @param size Size of the data
+     * @param table Signatures to compare with
+     * @return true if the first bytes of data are one of the signatures
+     */
+    template <size_t Count, size_t Length>
+    static bool startsWithAny(const Byte* data, Size size, const SignatureTable<Count, Length>& table) {
+        if (size < Length) {
+            return false;
+        }
+        for (const auto& signature : table) {
+            if (std::memcmp(data, signature.data(), Length) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Find the first occurrence of a signature
+     * @param data Data to search in
+     * @param size Size of the data
+     * @param signature Signature to look for
+     * @return Offset of the first match, or size if there is none
+     */
+    template <size_t Length>
+    static Size find(const Byte* data, Size size, const Signature<Length>& signature) {
+        static_assert(Length > 0, "signatures are never empty");
+        if (size < Length) {
+            return size;
+        }
+        Size last_start = size - Length;
+        for (Size i = 0; i <= last_start; ++i) {
+            // Jump to the next candidate first byte, then compare the rest
+            const void* candidate = std::memchr(data + i, signature[0], last_start - i + 1);
+            if (!candidate) {
+                break;
+            }
+            i = static_cast<const Byte*>(candidate) - data;
+            if (std::memcmp(data + i + 1, signature.data() + 1, Length - 1) == 0) {
+                return i;
+            }
+        }
+        return size;
+    }
+
+    /**
+     * @brief Copy a signature into the byte vector of the FileCarver interface
+     */
+    template <size_t Length>
+    static std::vector<Byte> toBytes(const Signature<Length>& signature) {
+        return std::vector<Byte>(signature.begin(), signature.end());
+    }
+
+    /**
+     * @brief Copy a table into the byte vectors of the FileCarver interface
+     */
+    template <size_t Count, size_t Length>
+    static std::vector<std::vector<Byte>> toBytes(const SignatureTable<Count, Length>& table) {
+        std::vector<std::vector<Byte>> patterns;
+        patterns.reserve(Count);
+        for (const auto& signature : table) {
+            patterns.push_back(toBytes(signature));
+        }
+        return patterns;
+    }
+};
+
+} // namespace FileRecovery
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+#include "utils/types.h"
+
+namespace FileRecovery {
+
+/**
+ * @brief Instruction set used by the vectorized helpers
+ */
+enum class SimdLevel {
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+/**
+ * @brief Vectorized byte-scanning helpers with runtime CPU dispatch
+ *
+ * The best implementation supported by the running CPU is selected once
+ * on first use; builds for other architectures use the scalar versions.
+ */
+class SimdUtils {
+public:
+    /**
+     * @brief Get the best instruction set supported by this CPU
+     */
+    static SimdLevel getSimdLevel();
+
+    /**
+     * @brief Get a printable name for an instruction set
+     */
+    static const char* getSimdLevelName(SimdLevel level);
+
+    /**
+     * @brief Check whether every byte equals the first one
+     * @param data Data to check
+     * @param size Size of the data (empty data counts as uniform)
+     * @return true if the data is one repeated byte value
+     */
+    static bool isUniform(const Byte* data, Size size);
+
+    /**
+     * @brief isUniform() with an explicit implementation (for tests and benchmarks)
+     *
+     * Levels the CPU does not support fall back to the next lower one.
+     */
+    static bool isUniform(const Byte* data, Size size, SimdLevel level);
+
+    /**
+     * @brief Find every occurrence of a byte pattern
+     *
+     * Candidates are positions where both the first and the last pattern
+     * byte match, tested 32 positions at a time; only those are compared
+     * in full.
+     *
+     * @param data Data to search in
+     * @param size Size of the data
+     * @param pattern Pattern to search for
+     * @return Offsets of all (possibly overlapping) matches, ascending
+     */
+    static std::vector<Offset> findPattern(const Byte* data, Size size, const std::vector<Byte>& pattern);
+
+    /**
+     * @brief findPattern() with an explicit implementation (for tests and benchmarks)
+     *
+     * Levels the CPU does not support fall back to the next lower one.
+     */
+    static std::vector<Offset> findPattern(const Byte* data, Size size, const std::vector<Byte>& pattern,
+                                           SimdLevel level);
+
+    /**
+     * @brief Find the first byte that is one of a small set of values
+     *
+     * Sets of more than MAX_VECTOR_BYTE_SET values are searched with the
+     * scalar version.
+     *
+     * @param data Data to search in
+     * @param size Size of the data
+     * @param values Byte values to look for
+     * @return Offset of the first match, or size if there is none
+     */
+    static Size findFirstOf(const Byte* data, Size size, const std::vector<Byte>& values);
+
+    /**
+     * @brief findFirstOf() with an explicit implementation (for tests and benchmarks)
+     */
+    static Size findFirstOf(const Byte* data, Size size, const std::vector<Byte>& values, SimdLevel level);
+
+    /// Largest value set findFirstOf() compares in vector registers
+    static constexpr Size MAX_VECTOR_BYTE_SET = 8;
+
+    /**
+     * @brief Find the parts of a buffer that are not uniform filler
+     *
+     * The buffer is split into block_size blocks and each block is tested
+     * with isUniform(). Runs of uniform blocks at least min_uniform_run
+     * bytes long are dropped; shorter runs stay attached to their
+     * neighbours so padding inside a file does not split it.
+     *
+     * @param data Data to scan
+     * @param size Size of the data
+     * @param block_size Granularity of the uniformity test
+     * @param min_uniform_run Shortest uniform run worth skipping
+     * @return (offset, length) pairs relative to data, in ascending order
+     */
+    static std::vector<std::pair<Size, Size>> findNonUniformRuns(
+        const Byte* data,
+        Size size,
+        Size block_size = BLOCK_SIZE_4K,
+        Size min_uniform_run = BLOCK_SIZE_4K
+    );
+};
+
+} // namespace FileRecovery
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "utils/thread_pool.h"
+
+namespace FileRecovery {
+
+/**
+ * @brief Shares a thread pool fairly between several clients
+ *
+ * Every client has its own queue. At most max_in_flight tasks are handed
+ * to the pool at a time, taken from the client queues in turn, so a
+ * client that queues thousands of tasks at once still lets every other
+ * client's next task run after at most one task of its own.
+ */
+class FairTaskQueue : public std::enable_shared_from_this<FairTaskQueue> {
+public:
+    /**
+     * @brief Constructor - the queue must be owned by a std::shared_ptr
+     * @param pool Pool that runs the tasks; must outlive the queue
+     * @param max_in_flight Tasks handed to the pool at once, 0 for one per worker
+     */
+    FairTaskQueue(ThreadPool& pool, size_t max_in_flight = 0);
+
+    FairTaskQueue(const FairTaskQueue&) = delete;
+    FairTaskQueue& operator=(const FairTaskQueue&) = delete;
+
+    /**
+     * @brief Register a client
+     * @return Client id for submit()
+     */
+    size_t addClient();
+
+    /**
+     * @brief Unregister a client whose tasks have all finished
+     * @param client Client id
+     */
+    void removeClient(size_t client);
+
+    /**
+     * @brief Queue a task for a client
+     * @param client Client id
+     * @param task Task to run
+     */
+    void submit(size_t client, ThreadPool::Task task);
+
+    /**
+     * @brief Get the pool the tasks run on
+     */
+    ThreadPool& getPool() { return pool_; }
+
+private:
+    ThreadPool& pool_;
+    size_t max_in_flight_;
+
+    std::mutex mutex_;
+    std::map<size_t, std::deque<ThreadPool::Task>> queues_;     // Guarded by mutex_
+    size_t next_client_;                                        // Guarded by mutex_
+    size_t turn_;                                               // Client served last, guarded by mutex_
+    size_t in_flight_;                                          // Guarded by mutex_
+
+    /**
+     * @brief Hand queued tasks to the pool while there is room; mutex_ must be held
+     */
+    void dispatch();
+};
+
+/**
+ * @brief Tasks of one owner on a thread pool that can be waited for on their own
+ *
+ * ThreadPool::wait() waits for every task in the pool. When several
+ * engines share a pool each of them waits through its own group, which
+ * only counts the tasks submitted through it. A group attached to a
+ * FairTaskQueue submits through the queue and gets its fair share of
+ * the workers.
+ */
+class TaskGroup {
+public:
+    /**
+     * @brief Constructor
+     * @param pool Pool that runs the tasks
+     * @param queue Fair queue to submit through, null to submit to the pool directly
+     */
+    explicit TaskGroup(ThreadPool& pool, std::shared_ptr<FairTaskQueue> queue = nullptr);
+
+    /**
+     * @brief Destructor - waits for the group's tasks
+     */
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /**
+     * @brief Queue a task
+     * @param task Task to run
+     * @param node NUMA node to run it on, -1 for any; ignored with a fair queue
+     */
+    void submit(ThreadPool::Task task, int node = -1);
+
+    /**
+     * @brief Block until every task of this group has finished
+     *
+     * Must not be called from inside a task of the group.
+     */
+    void wait();
+
+    /**
+     * @brief Number of workers that may run the group's tasks
+     */
+    size_t getThreadCount() const { return pool_.getThreadCount(); }
+
+    /**
+     * @brief Number of the group's tasks that have finished
+     */
+    size_t getExecutedCount() const;
+
+private:
+    ThreadPool& pool_;
+    std::shared_ptr<FairTaskQueue> queue_;
+    size_t client_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable idle_cv_;
+    size_t pending_;        // Guarded by mutex_
+    size_t executed_;       // Guarded by mutex_
+
+    /**
+     * @brief Count a task as finished
+     */
+    void finishTask();
+};
+
+} // namespace FileRecovery
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace FileRecovery {
+
+/**
+ * @brief Counters describing how a thread pool distributed its work
+ */
+struct ThreadPoolStats {
+    size_t tasks_executed;
+    size_t tasks_stolen;    ///< Tasks run by a worker other than the one they were queued on
+
+    ThreadPoolStats() : tasks_executed(0), tasks_stolen(0) {}
+};
+
+/**
+ * @brief Where one worker runs
+ */
+struct WorkerPlacement {
+    int node;               ///< NUMA node, -1 if unplaced
+    std::vector<int> cpus;  ///< CPUs the worker is pinned to, empty for no pinning
+
+    WorkerPlacement() : node(-1) {}
+};
+
+/**
+ * @brief Persistent worker pool with per-worker deques and work stealing
+ *
+ * Every worker owns a deque. Tasks submitted from outside the pool are
+ * spread round-robin over the deques; tasks submitted from inside a task
+ * go to the submitting worker's own deque. A worker takes its newest
+ * task first and, when its deque is empty, steals the oldest task of
+ * another worker, so one slow task never holds back the tasks queued
+ * behind it.
+ *
+ * Workers can be placed on NUMA nodes and pinned to CPUs. An idle
+ * worker then steals from workers on its own node before it reaches
+ * across to another node.
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Constructor - starts the workers
+     * @param num_threads Number of workers (at least one)
+     */
+    explicit ThreadPool(size_t num_threads);
+    
+    /**
+     * @brief Constructor - starts one pinned worker per placement
+     * @param placement Node and CPUs of each worker (at least one worker is started)
+     */
+    explicit ThreadPool(const std::vector<WorkerPlacement>& placement);
+
+    /**
+     * @brief Destructor - runs the remaining tasks and joins the workers
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queue a task
+     * @param task Task to run; exceptions it throws are logged and dropped
+     */
+    void submit(Task task);
+    
+    /**
+     * @brief Queue a task on a worker of a NUMA node
+     * @param task Task to run
+     * @param node Node id; tasks for a node without workers are queued as by submit(Task)
+     */
+    void submit(Task task, int node);
+
+    /**
+     * @brief Block until every submitted task has finished
+     *
+     * Must not be called from inside a task of the same pool.
+     */
+    void wait();
+
+    /**
+     * @brief Number of workers
+     */
+    size_t getThreadCount() const { return workers_.size(); }
+
+    /**
+     * @brief Get execution counters
+     */
+    ThreadPoolStats getStats() const;
+    
+    /**
+     * @brief NUMA node of the calling pool worker
+     * @return Node id, or -1 outside a placed worker
+     */
+    static int currentNode();
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::vector<WorkerPlacement> placement_;
+
+    std::mutex mutex_;
+    std::condition_variable work_cv_;   // Signalled when tasks are queued or on shutdown
+    std::condition_variable idle_cv_;   // Signalled when the last pending task finishes
+    size_t pending_;                    // Submitted but not finished, guarded by mutex_
+    bool stopping_;                     // Guarded by mutex_
+
+    std::atomic<size_t> queued_;        // Tasks sitting in a deque
+    std::atomic<size_t> next_queue_;
+    std::atomic<size_t> tasks_executed_;
+    std::atomic<size_t> tasks_stolen_;
+
+    void startWorkers(std::vector<WorkerPlacement> placement);
+    void enqueue(size_t index, Task task);
+    void workerLoop(size_t index);
+    bool popLocal(size_t index, Task& task);
+    bool steal(size_t index, Task& task, bool same_node);
+    void runTask(Task& task);
+};
+
+} // namespace FileRecovery
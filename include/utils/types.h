@@ -17,6 +17,8 @@ using Size = uint64_t;
 constexpr Size SECTOR_SIZE = 512;
 constexpr Size BLOCK_SIZE_4K = 4096;
 constexpr Size DEFAULT_CHUNK_SIZE = 1024 * 1024; // 1MB chunks
+constexpr Size DEFAULT_CHUNK_OVERLAP = 64 * 1024; // Extra bytes read past each chunk
+constexpr Size DEFAULT_MAX_SPAN_EXTENSION = 64 * 1024 * 1024; // Furthest a file is followed past its chunk
 constexpr Size MAX_FILE_SIZE = 1ULL << 32; // 4GB max file size
 
 // Recovery result structure
@@ -33,6 +35,12 @@ struct RecoveredFile {
     RecoveredFile() : start_offset(0), file_size(0), confidence_score(0.0), is_fragmented(false) {}
 };
 
+// Read backend used by DiskScanner for bulk scanning
+enum class IoBackendType {
+    SYNC,       // One blocking pread() per chunk
+    IO_URING    // Batched asynchronous reads through io_uring
+};
+
 // Scan configuration
 struct ScanConfig {
     std::string device_path;
@@ -41,15 +49,57 @@ struct ScanConfig {
     bool use_metadata_recovery;
     bool use_signature_recovery;
     size_t num_threads;
+    size_t extraction_threads;
+    bool numa_aware;
+    size_t threads_per_node;
     Size chunk_size;
+    Size chunk_overlap;
+    Size max_span_extension;
+    bool auto_tune;
     bool verbose_logging;
+    IoBackendType io_backend;
+    unsigned io_queue_depth;
+    bool direct_io;
+    bool use_mmap;
+    size_t read_ahead_chunks;
+    Size cache_size;
+    Size cache_block_size;
+    bool skip_uniform_blocks;
+    Size header_alignment;
+    bool align_headers_to_clusters;
+    bool degraded_mode;
+    std::string bad_block_map_path;
+    bool keep_recovered_files;
+    std::string checkpoint_path;
+    unsigned checkpoint_interval;
+    bool resume;
     
     ScanConfig() : 
         use_metadata_recovery(true), 
         use_signature_recovery(true),
         num_threads(0), // 0 = auto-detect
+        extraction_threads(0), // 0 = auto-detect
+        numa_aware(false),
+        threads_per_node(0), // 0 = every allowed core of the node
         chunk_size(DEFAULT_CHUNK_SIZE),
-        verbose_logging(false) {}
+        chunk_overlap(DEFAULT_CHUNK_OVERLAP),
+        max_span_extension(DEFAULT_MAX_SPAN_EXTENSION), // 0 = files end where their chunk's window does
+        auto_tune(false), // true = chunk_size, io_queue_depth and num_threads are measured
+        verbose_logging(false),
+        io_backend(IoBackendType::SYNC),
+        io_queue_depth(32),
+        direct_io(false),
+        use_mmap(false),
+        read_ahead_chunks(4),
+        cache_size(64 * 1024 * 1024), // 0 = no block cache
+        cache_block_size(64 * 1024),
+        skip_uniform_blocks(true),
+        header_alignment(0), // 0 = headers are searched at every byte
+        align_headers_to_clusters(false), // true = header_alignment is the detected cluster size
+        degraded_mode(false),
+        keep_recovered_files(false),
+        checkpoint_interval(30), // Seconds between checkpoint writes, 0 = only when the run ends
+        resume(false) {}
 };
 
 // File system types
@@ -1,5 +1,6 @@
 #include "carvers/base_carver.h"
 #include "utils/logger.h"
+#include "utils/simd_utils.h"
 #include <algorithm>
 #include <array>
 #include <cmath>
@@ -8,25 +9,39 @@
 
 namespace FileRecovery {
 
-std::vector<Offset> BaseCarver::findPattern(
+std::vector<RecoveredFile> BaseCarver::carveFiles(
     const Byte* data, 
     Size size, 
-    const std::vector<Byte>& pattern
-) const {
-    std::vector<Offset> matches;
-    
-    if (pattern.empty() || size < pattern.size()) {
-        return matches;
+    Offset base_offset
+) {
+    return carveFilesAt(data, size, base_offset, findSignatures(data, size));
+}
+
+SignatureHits BaseCarver::findSignatures(const Byte* data, Size size) const {
+    SignatureHits hits;
+    for (const auto& signature : getFileSignatures()) {
+        auto matches = findPattern(data, size, signature);
+        hits.headers.insert(hits.headers.end(), matches.begin(), matches.end());
     }
-    
-    // Use Boyer-Moore-like approach for efficiency
-    for (Size i = 0; i <= size - pattern.size(); ++i) {
-        if (std::equal(pattern.begin(), pattern.end(), data + i)) {
-            matches.push_back(i);
+    for (const auto& footer : getFileFooters()) {
+        for (Offset match : findPattern(data, size, footer)) {
+            hits.footer_ends.push_back(match + footer.size());
         }
     }
-    
-    return matches;
+    for (auto* offsets : {&hits.headers, &hits.footer_ends}) {
+        std::sort(offsets->begin(), offsets->end());
+        offsets->erase(std::unique(offsets->begin(), offsets->end()), offsets->end());
+    }
+    return hits;
+}
+
+std::vector<Offset> BaseCarver::findPattern(
+    const Byte* data, 
+    Size size, 
+    const std::vector<Byte>& pattern
+) const {
+    // Vectorized first/last byte prefilter, dispatched for this CPU
+    return SimdUtils::findPattern(data, size, pattern);
 }
 
 double BaseCarver::calculateEntropy(const Byte* data, Size size) const {
@@ -58,16 +73,7 @@ bool BaseCarver::validateFileStructure(const Byte* data, Size size) const {
         return false;
     }
     
-    Byte first_byte = data[0];
-    bool all_same = true;
-    for (Size i = 1; i < std::min(size, Size(1024)); ++i) {
-        if (data[i] != first_byte) {
-            all_same = false;
-            break;
-        }
-    }
-    
-    return !all_same;
+    return !SimdUtils::isUniform(data, std::min(size, Size(1024)));
 }
 
 std::string BaseCarver::extractMetadata(const Byte* data, Size size) const {
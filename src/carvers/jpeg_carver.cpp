@@ -1,31 +1,37 @@
 #include "carvers/jpeg_carver.h"
 #include "utils/logger.h"
+#include "utils/signature.h"
 #include <algorithm>
 
 namespace FileRecovery {
 
+// Start of image followed by the first marker: JFIF, EXIF or raw JPEG
+constexpr SignatureTable<3, 4> JPEG_SIGNATURES = {{
+    {0xFF, 0xD8, 0xFF, 0xE0},
+    {0xFF, 0xD8, 0xFF, 0xE1},
+    {0xFF, 0xD8, 0xFF, 0xDB}
+}};
+
+// End of image marker
+constexpr Signature<2> JPEG_EOI = {0xFF, 0xD9};
+
 std::vector<std::string> JpegCarver::getSupportedTypes() const {
     return {"JPEG", "JPG"}; // Change to uppercase to match test expectations
 }
 
 std::vector<std::vector<Byte>> JpegCarver::getFileSignatures() const {
-    return {
-        {0xFF, 0xD8, 0xFF, 0xE0}, // JFIF
-        {0xFF, 0xD8, 0xFF, 0xE1}, // EXIF
-        {0xFF, 0xD8, 0xFF, 0xDB}  // Raw JPEG
-    };
+    return SignatureUtils::toBytes(JPEG_SIGNATURES);
 }
 
 std::vector<std::vector<Byte>> JpegCarver::getFileFooters() const {
-    return {
-        {0xFF, 0xD9} // JPEG end marker
-    };
+    return {SignatureUtils::toBytes(JPEG_EOI)};
 }
 
-std::vector<RecoveredFile> JpegCarver::carveFiles(
+std::vector<RecoveredFile> JpegCarver::carveFilesAt(
     const Byte* data, 
     Size size, 
-    Offset base_offset
+    Offset base_offset,
+    const SignatureHits& hits
 ) {
     std::vector<RecoveredFile> recovered_files;
     
@@ -33,35 +39,29 @@ std::vector<RecoveredFile> JpegCarver::carveFiles(
         return recovered_files;
     }
     
-    // Search for JPEG signatures
-    auto signatures = getFileSignatures();
-    for (const auto& signature : signatures) {
-        auto matches = findPattern(data, size, signature);
+    for (Offset match_offset : hits.headers) {
+        // Find the end of this JPEG
+        Size jpeg_size = findJpegEnd(data, size, match_offset, hits.footer_ends);
+        if (jpeg_size == 0 || jpeg_size < 100) { // Skip tiny files
+            continue;
+        }
         
-        for (Offset match_offset : matches) {
-            // Find the end of this JPEG
-            Size jpeg_size = findJpegEnd(data, size, match_offset);
-            if (jpeg_size == 0 || jpeg_size < 100) { // Skip tiny files
-                continue;
-            }
-            
-            // Create recovered file entry
-            RecoveredFile file;
-            file.filename = generateFilename(base_offset + match_offset, "jpg");
-            file.file_type = "JPEG";
-            file.start_offset = base_offset + match_offset;
-            file.file_size = jpeg_size;
-            file.is_fragmented = false;
-            
-            // Validate and calculate confidence
-            file.confidence_score = validateFile(file, data + match_offset);
-            
-            if (file.confidence_score > 0.3) { // Only include files with reasonable confidence
-                recovered_files.push_back(file);
-                LOG_DEBUG("Found JPEG at offset " + std::to_string(file.start_offset) + 
-                         ", size: " + std::to_string(file.file_size) + 
-                         ", confidence: " + std::to_string(file.confidence_score));
-            }
+        // Create recovered file entry
+        RecoveredFile file;
+        file.filename = generateFilename(base_offset + match_offset, "jpg");
+        file.file_type = "JPEG";
+        file.start_offset = base_offset + match_offset;
+        file.file_size = jpeg_size;
+        file.is_fragmented = false;
+        
+        // Validate and calculate confidence
+        file.confidence_score = validateFile(file, data + match_offset);
+        
+        if (file.confidence_score > 0.3) { // Only include files with reasonable confidence
+            recovered_files.push_back(file);
+            LOG_DEBUG("Found JPEG at offset " + std::to_string(file.start_offset) + 
+                     ", size: " + std::to_string(file.file_size) + 
+                     ", confidence: " + std::to_string(file.confidence_score));
         }
     }
     
@@ -78,20 +78,12 @@ double JpegCarver::validateFile(const RecoveredFile& file, const Byte* data) {
     bool structure_valid = false;
     
     // Check header
-    auto signatures = getFileSignatures();
-    for (const auto& signature : signatures) {
-        if (file.file_size >= signature.size() && 
-            std::equal(signature.begin(), signature.end(), data)) {
-            has_valid_header = true;
-            break;
-        }
-    }
+    has_valid_header = SignatureUtils::startsWithAny(data, file.file_size, JPEG_SIGNATURES);
     
     // Check footer
-    if (file.file_size >= 2) {
-        if (data[file.file_size - 2] == 0xFF && data[file.file_size - 1] == 0xD9) {
-            has_valid_footer = true;
-        }
+    if (file.file_size >= JPEG_EOI.size()) {
+        has_valid_footer = SignatureUtils::startsWith(data + file.file_size - JPEG_EOI.size(),
+                                                      JPEG_EOI.size(), JPEG_EOI);
     }
     
     // Validate structure
@@ -107,21 +99,18 @@ Size JpegCarver::getMaxFileSize() const {
     return 100 * 1024 * 1024; // 100MB max for JPEG
 }
 
-Size JpegCarver::findJpegEnd(const Byte* data, Size size, Offset start_offset) const {
+Size JpegCarver::findJpegEnd(const Byte* data, Size size, Offset start_offset,
+                             const std::vector<Offset>& footer_ends) const {
     if (start_offset + 10 >= size) {
         return 0;
     }
     
-    // Look for the JPEG end marker (0xFF 0xD9)
-    for (Size i = start_offset + 10; i < size - 1; ++i) {
-        if (data[i] == 0xFF && data[i + 1] == 0xD9) {
-            return i - start_offset + 2; // Include the end marker
-        }
-        
-        // Safety check - don't search beyond reasonable JPEG size
-        if (i - start_offset > getMaxFileSize()) {
-            break;
-        }
+    // First end marker (0xFF 0xD9) starting at least 10 bytes in
+    auto end = std::lower_bound(footer_ends.begin(), footer_ends.end(), start_offset + 12);
+    
+    // Safety check - don't accept an end beyond reasonable JPEG size
+    if (end != footer_ends.end() && *end - start_offset <= getMaxFileSize()) {
+        return *end - start_offset; // Include the end marker
     }
     
     // If no end marker found, try to estimate size based on segments
@@ -1,37 +1,45 @@
 #include "carvers/pdf_carver.h"
 #include "utils/logger.h"
+#include "utils/signature.h"
 #include <algorithm>
 #include <string>
 #include <cstring>
 
 namespace FileRecovery {
 
+// "%PDF-", followed by the version
+constexpr Signature<5> PDF_SIGNATURE = {0x25, 0x50, 0x44, 0x46, 0x2D};
+
+// "%%EOF", alone or after a line break; every variant ends with PDF_EOF
+constexpr Signature<5> PDF_EOF = {0x25, 0x25, 0x45, 0x4F, 0x46};
+constexpr Signature<6> PDF_EOF_LF = {0x0A, 0x25, 0x25, 0x45, 0x4F, 0x46};
+constexpr Signature<7> PDF_EOF_CRLF = {0x0D, 0x0A, 0x25, 0x25, 0x45, 0x4F, 0x46};
+
 std::vector<std::string> PdfCarver::getSupportedTypes() const {
     return {"PDF"}; // Change to uppercase to match test expectations
 }
 
 std::vector<std::vector<Byte>> PdfCarver::getFileSignatures() const {
-    return {
-        {0x25, 0x50, 0x44, 0x46, 0x2D} // "%PDF-"
-    };
+    return {SignatureUtils::toBytes(PDF_SIGNATURE)};
 }
 
 std::vector<std::vector<Byte>> PdfCarver::getFileFooters() const {
     return {
-        {0x25, 0x25, 0x45, 0x4F, 0x46}, // "%%EOF"
-        {0x0A, 0x25, 0x25, 0x45, 0x4F, 0x46}, // "\n%%EOF"
-        {0x0D, 0x0A, 0x25, 0x25, 0x45, 0x4F, 0x46} // "\r\n%%EOF"
+        SignatureUtils::toBytes(PDF_EOF),
+        SignatureUtils::toBytes(PDF_EOF_LF),
+        SignatureUtils::toBytes(PDF_EOF_CRLF)
     };
 }
 
-std::vector<RecoveredFile> PdfCarver::carveFiles(
+std::vector<RecoveredFile> PdfCarver::carveFilesAt(
     const Byte* data, 
     Size size, 
-    Offset base_offset
+    Offset base_offset,
+    const SignatureHits& hits
 ) {
     std::vector<RecoveredFile> recovered_files;
     
-    LOG_DEBUG("PdfCarver::carveFiles - size=" + std::to_string(size) + 
+    LOG_DEBUG("PdfCarver::carveFilesAt - size=" + std::to_string(size) + 
               ", base_offset=" + std::to_string(base_offset));
     
     if (size < 20) { // Minimum PDF size
@@ -42,47 +50,42 @@ std::vector<RecoveredFile> PdfCarver::carveFiles(
     // Dump start of data for debugging
     dumpData(data, std::min(size, Size(64)), "PDF data start");
     
-    // Search for PDF signatures
-    auto signatures = getFileSignatures();
-    for (const auto& signature : signatures) {
-        auto matches = findPattern(data, size, signature);
-        LOG_DEBUG("Found " + std::to_string(matches.size()) + " PDF signatures");
+    LOG_DEBUG("Found " + std::to_string(hits.headers.size()) + " PDF signatures");
+    
+    for (Offset match_offset : hits.headers) {
+        // Find the end of this PDF
+        Size pdf_size = findPdfEnd(data, size, match_offset, hits);
+        LOG_DEBUG("PDF at offset " + std::to_string(match_offset) + 
+                 ", calculated size: " + std::to_string(pdf_size));
+        
+        // MODIFIED: For test data, don't skip small PDFs
+        // This allows testing corrupted PDFs which may be small
+        bool is_test_data = (size < 1000); // Small data is likely test data
+        if (pdf_size == 0 || (pdf_size < 100 && !is_test_data)) {
+            LOG_DEBUG("Skipping small PDF file");
+            continue;
+        }
+        
+        // Create recovered file entry
+        RecoveredFile file;
+        file.filename = generateFilename(base_offset + match_offset, "pdf");
+        file.file_type = "PDF";
+        file.start_offset = base_offset + match_offset;
+        file.file_size = pdf_size;
+        file.is_fragmented = false;
+        
+        // Validate and calculate confidence
+        file.confidence_score = validateFile(file, data + match_offset);
+        LOG_DEBUG("PDF confidence: " + std::to_string(file.confidence_score));
         
-        for (Offset match_offset : matches) {
-            // Find the end of this PDF
-            Size pdf_size = findPdfEnd(data, size, match_offset);
-            LOG_DEBUG("PDF at offset " + std::to_string(match_offset) + 
-                     ", calculated size: " + std::to_string(pdf_size));
-            
-            // MODIFIED: For test data, don't skip small PDFs
-            // This allows testing corrupted PDFs which may be small
-            bool is_test_data = (size < 1000); // Small data is likely test data
-            if (pdf_size == 0 || (pdf_size < 100 && !is_test_data)) {
-                LOG_DEBUG("Skipping small PDF file");
-                continue;
-            }
-            
-            // Create recovered file entry
-            RecoveredFile file;
-            file.filename = generateFilename(base_offset + match_offset, "pdf");
-            file.file_type = "PDF";
-            file.start_offset = base_offset + match_offset;
-            file.file_size = pdf_size;
-            file.is_fragmented = false;
-            
-            // Validate and calculate confidence
-            file.confidence_score = validateFile(file, data + match_offset);
-            LOG_DEBUG("PDF confidence: " + std::to_string(file.confidence_score));
-            
-            // MODIFIED: For test data, use a lower threshold
-            double threshold = is_test_data ? 0.1 : 0.3;
-            
-            if (file.confidence_score > threshold) {
-                recovered_files.push_back(file);
-                LOG_INFO("Found PDF at offset " + std::to_string(file.start_offset) + 
-                       ", size: " + std::to_string(file.file_size) + 
-                       ", confidence: " + std::to_string(file.confidence_score));
-            }
+        // MODIFIED: For test data, use a lower threshold
+        double threshold = is_test_data ? 0.1 : 0.3;
+        
+        if (file.confidence_score > threshold) {
+            recovered_files.push_back(file);
+            LOG_INFO("Found PDF at offset " + std::to_string(file.start_offset) + 
+                   ", size: " + std::to_string(file.file_size) + 
+                   ", confidence: " + std::to_string(file.confidence_score));
         }
     }
     
@@ -93,30 +96,22 @@ Size PdfCarver::getMaxFileSize() const {
     return 1ULL * 1024 * 1024 * 1024; // 1GB max for PDF
 }
 
-Size PdfCarver::findPdfEnd(const Byte* data, Size size, Offset start_offset) const {
+Size PdfCarver::findPdfEnd(const Byte* data, Size size, Offset start_offset, const SignatureHits& hits) const {
     if (start_offset + 20 >= size) {
         LOG_DEBUG("PDF data too small to find end");
         return 0;
     }
     
-    // Look for PDF end markers
-    auto footers = getFileFooters();
-    auto signatures = getFileSignatures();
-    
     // Find the next PDF signature after our start_offset
     // This is critical for handling multiple PDFs correctly
     Size next_pdf_offset = size;
-    for (const auto& signature : signatures) {
-        for (Size i = start_offset + signature.size(); i + signature.size() < size; ++i) {
-            if (std::equal(signature.begin(), signature.end(), data + i)) {
-                LOG_DEBUG("Found next PDF signature at offset " + std::to_string(i));
-                next_pdf_offset = std::min(next_pdf_offset, i);
-                break;
-            }
-        }
+    auto next_header = std::upper_bound(hits.headers.begin(), hits.headers.end(), start_offset);
+    if (next_header != hits.headers.end()) {
+        LOG_DEBUG("Found next PDF signature at offset " + std::to_string(*next_header));
+        next_pdf_offset = *next_header;
     }
     
-    // Search backwards from the next PDF (or end of buffer) to find the EOF
+    // Take the last EOF before the next PDF (or end of buffer)
     // This ensures we don't pick up the EOF from a later PDF
     Size search_end = std::min(next_pdf_offset, start_offset + getMaxFileSize());
     search_end = std::min(search_end, size);
@@ -124,14 +119,10 @@ Size PdfCarver::findPdfEnd(const Byte* data, Size size, Offset start_offset) con
     LOG_DEBUG("Searching for EOF between " + std::to_string(start_offset) + 
              " and " + std::to_string(search_end));
     
-    for (Size i = search_end - 1; i > start_offset + 20; --i) {
-        for (const auto& footer : footers) {
-            if (i >= footer.size() && 
-                std::equal(footer.begin(), footer.end(), data + i - footer.size() + 1)) {
-                LOG_DEBUG("Found EOF at offset " + std::to_string(i));
-                return i - start_offset + 1;
-            }
-        }
+    auto eof_end = std::upper_bound(hits.footer_ends.begin(), hits.footer_ends.end(), search_end);
+    if (eof_end != hits.footer_ends.begin() && *--eof_end > start_offset + 21) {
+        LOG_DEBUG("Found EOF at offset " + std::to_string(*eof_end - 1));
+        return *eof_end - start_offset;
     }
     
     // If no footer found, estimate based on structure or use until next PDF
@@ -204,26 +195,22 @@ bool PdfCarver::hasValidTrailer(const Byte* data, Size size) const {
     }
     LOG_DEBUG("End of file dump: " + trailer_dump);
     
-    auto footers = getFileFooters();
+    // Special handling for corrupted test PDF (~58 bytes)
+    if (size < 100) {
+        // For corrupted test data, manually check if it contains %%EOF
+        bool has_eof = (trailer_dump.find("25 25 45 4F 46") != std::string::npos);
+        LOG_DEBUG("Small PDF " + std::string(has_eof ? "has" : "doesn't have") + " %%EOF trailer");
+        return has_eof;
+    }
     
-    // Check last part of file for %%EOF
+    // Check last part of file for %%EOF, which every footer variant ends with
     Size check_size = std::min(size, Size(1024));
     const Byte* end_data = data + size - check_size;
     
-    for (const auto& footer : footers) {
-        // Special handling for corrupted test PDF (~58 bytes)
-        if (size < 100) {
-            // For corrupted test data, manually check if it contains %%EOF
-            bool has_eof = (trailer_dump.find("25 25 45 4F 46") != std::string::npos);
-            LOG_DEBUG("Small PDF " + std::string(has_eof ? "has" : "doesn't have") + " %%EOF trailer");
-            return has_eof;
-        }
-        
-        auto matches = findPattern(end_data, check_size, footer);
-        if (!matches.empty()) {
-            LOG_DEBUG("Found valid footer at offset " + std::to_string(matches[0]));
-            return true;
-        }
+    Size match = SignatureUtils::find(end_data, check_size, PDF_EOF);
+    if (match < check_size) {
+        LOG_DEBUG("Found valid footer at offset " + std::to_string(match));
+        return true;
     }
     
     LOG_DEBUG("No valid trailer found");
@@ -241,14 +228,9 @@ double PdfCarver::validateFile(const RecoveredFile& file, const Byte* data) {
     bool structure_valid = false;
     
     // Check header
-    auto signatures = getFileSignatures();
-    for (const auto& signature : signatures) {
-        if (file.file_size >= signature.size() && 
-            std::equal(signature.begin(), signature.end(), data)) {
-            has_valid_header = true;
-            LOG_DEBUG("Valid PDF header found");
-            break;
-        }
+    if (SignatureUtils::startsWith(data, file.file_size, PDF_SIGNATURE)) {
+        has_valid_header = true;
+        LOG_DEBUG("Valid PDF header found");
     }
     
     // Check footer
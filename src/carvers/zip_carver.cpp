@@ -1,11 +1,22 @@
 #include "carvers/zip_carver.h"
 #include "utils/logger.h"
+#include "utils/signature.h"
 #include <cstring>
 #include <algorithm>
 #include <sstream>
 
 namespace FileRecovery {
 
+// Local file header ("PK\x03\x04"), empty archive and spanned archive markers
+constexpr SignatureTable<3, 4> ZIP_SIGNATURES = {{
+    {0x50, 0x4B, 0x03, 0x04},
+    {0x50, 0x4B, 0x05, 0x06},
+    {0x50, 0x4B, 0x07, 0x08}
+}};
+
+// End of central directory record
+constexpr Signature<4> ZIP_EOCD = {0x50, 0x4B, 0x05, 0x06};
+
 ZipCarver::ZipCarver() = default;
 
 std::vector<std::string> ZipCarver::getSupportedTypes() const {
@@ -14,28 +25,22 @@ std::vector<std::string> ZipCarver::getSupportedTypes() const {
 }
 
 std::vector<std::vector<Byte>> ZipCarver::getFileSignatures() const {
-    return {
-        {0x50, 0x4B, 0x03, 0x04}, // PK\x03\x04 - standard ZIP
-        {0x50, 0x4B, 0x05, 0x06}, // PK\x05\x06 - empty archive
-        {0x50, 0x4B, 0x07, 0x08}  // PK\x07\x08 - spanned archive
-    };
+    return SignatureUtils::toBytes(ZIP_SIGNATURES);
 }
 
 std::vector<std::vector<Byte>> ZipCarver::getFileFooters() const {
     // ZIP files can end with End of Central Directory signature
-    return {
-        {0x50, 0x4B, 0x05, 0x06} // End of central directory
-    };
+    return {SignatureUtils::toBytes(ZIP_EOCD)};
 }
 
-std::vector<RecoveredFile> ZipCarver::carveFiles(const Byte* data, Size size, Offset base_offset) {
+std::vector<RecoveredFile> ZipCarver::carveFilesAt(const Byte* data, Size size, Offset base_offset,
+                                                   const SignatureHits& hits) {
     std::vector<RecoveredFile> recovered_files;
     if (!data || size < 4) {
         return recovered_files;
     }
     dumpData(data, std::min(size, Size(64)), "ZIP data start");
     bool is_test_data = (size < 1000);
-    auto signatures = getFileSignatures();
     // --- Collect all candidate ZIPs (offset, size) ---
     struct ZipCandidate {
         size_t offset;
@@ -43,64 +48,61 @@ std::vector<RecoveredFile> ZipCarver::carveFiles(const Byte* data, Size size, Of
         double confidence;
     };
     std::vector<ZipCandidate> candidates;
-    for (const auto& signature : signatures) {
-        auto offsets = findPattern(data, size, signature);
-        // Only log signature counts in debug builds to avoid performance impact
+    // Only log signature counts in debug builds to avoid performance impact
 #ifdef DEBUG
-        LOG_DEBUG("Signature " + std::to_string(signature[0]) + "... found at " + std::to_string(offsets.size()) + " offsets");
+    LOG_DEBUG("Signatures found at " + std::to_string(hits.headers.size()) + " offsets");
 #endif
-        for (auto offset : offsets) {
+    for (auto offset : hits.headers) {
 #ifdef DEBUG
-            LOG_DEBUG("Checking candidate at offset " + std::to_string(offset));
+        LOG_DEBUG("Checking candidate at offset " + std::to_string(offset));
 #endif
-            if (offset + sizeof(ZipLocalFileHeader) > size) {
+        if (offset + sizeof(ZipLocalFileHeader) > size) {
 #ifdef DEBUG
-                LOG_DEBUG("Offset " + std::to_string(offset) + " too close to end for header");
+            LOG_DEBUG("Offset " + std::to_string(offset) + " too close to end for header");
 #endif
-                continue;
-            }
-            const auto* header = reinterpret_cast<const ZipLocalFileHeader*>(data + offset);
-            bool header_valid = true;
-            if (!is_test_data) {
-                header_valid = validate_local_file_header(header);
+            continue;
+        }
+        const auto* header = reinterpret_cast<const ZipLocalFileHeader*>(data + offset);
+        bool header_valid = true;
+        if (!is_test_data) {
+            header_valid = validate_local_file_header(header);
 #ifdef DEBUG
-                LOG_DEBUG("Header valid at offset " + std::to_string(offset) + ": " + (header_valid ? "yes" : "no"));
+            LOG_DEBUG("Header valid at offset " + std::to_string(offset) + ": " + (header_valid ? "yes" : "no"));
 #endif
-            }
-            if (!header_valid) continue;
-            size_t zip_size = calculate_zip_size(data + offset, size - offset);
+        }
+        if (!header_valid) continue;
+        size_t zip_size = calculate_zip_size(data, size, offset, hits);
 #ifdef DEBUG
-            LOG_DEBUG("Calculated zip_size at offset " + std::to_string(offset) + ": " + std::to_string(zip_size));
+        LOG_DEBUG("Calculated zip_size at offset " + std::to_string(offset) + ": " + std::to_string(zip_size));
 #endif
-            if (zip_size == 0) {
-                if (is_test_data) {
-                    zip_size = size - offset;
+        if (zip_size == 0) {
+            if (is_test_data) {
+                zip_size = size - offset;
 #ifdef DEBUG
-                    LOG_DEBUG("Test data: using fallback zip_size " + std::to_string(zip_size));
+                LOG_DEBUG("Test data: using fallback zip_size " + std::to_string(zip_size));
 #endif
-                } else {
+            } else {
 #ifdef DEBUG
-                    LOG_DEBUG("Skipping candidate at offset " + std::to_string(offset) + " due to zero size");
+                LOG_DEBUG("Skipping candidate at offset " + std::to_string(offset) + " due to zero size");
 #endif
-                    continue;
-                }
-            }
-            if (offset + zip_size > size) {
-                LOG_DEBUG("Truncating zip_size at offset " + std::to_string(offset) + " to fit buffer");
-                zip_size = size - offset;
-            }
-            double confidence = 0.5;
-            if (is_test_data) {
-                bool has_eocd = find_end_of_central_directory(data + offset, zip_size) > 0;
-                confidence = has_eocd ? 0.9 : 0.6;
-            } else {
-                confidence = calculateConfidence(data + offset, zip_size);
+                continue;
             }
+        }
+        if (offset + zip_size > size) {
+            LOG_DEBUG("Truncating zip_size at offset " + std::to_string(offset) + " to fit buffer");
+            zip_size = size - offset;
+        }
+        double confidence = 0.5;
+        bool has_eocd = find_end_of_central_directory(data, offset, zip_size, hits.footer_ends) > 0;
+        if (is_test_data) {
+            confidence = has_eocd ? 0.9 : 0.6;
+        } else {
+            confidence = calculateConfidence(data + offset, zip_size, has_eocd);
+        }
 #ifdef DEBUG
-            LOG_DEBUG("Candidate at offset " + std::to_string(offset) + ", size " + std::to_string(zip_size) + ", confidence " + std::to_string(confidence));
+        LOG_DEBUG("Candidate at offset " + std::to_string(offset) + ", size " + std::to_string(zip_size) + ", confidence " + std::to_string(confidence));
 #endif
-            candidates.push_back({offset, zip_size, confidence});
-        }
+        candidates.push_back({offset, zip_size, confidence});
     }
     // --- Sort by offset, deduplicate, and filter overlaps ---
     std::sort(candidates.begin(), candidates.end(), [](const ZipCandidate& a, const ZipCandidate& b) {
@@ -160,6 +162,10 @@ Size ZipCarver::getMaxFileSize() const {
 }
 
 double ZipCarver::calculateConfidence(const Byte* data, Size size) const {
+    return calculateConfidence(data, size, find_end_of_central_directory(data, size) > 0);
+}
+
+double ZipCarver::calculateConfidence(const Byte* data, Size size, bool has_eocd) const {
     double confidence = 0.5; // Base confidence
     
     // Check if we have a valid local file header
@@ -176,7 +182,7 @@ double ZipCarver::calculateConfidence(const Byte* data, Size size) const {
     }
     
     // Fix #7: Check for end of central directory - this is critical for confidence
-    if (find_end_of_central_directory(data, size) > 0) {
+    if (has_eocd) {
         confidence += 0.3; // Higher weight for having valid EOCD
     } else {
         // If no EOCD but valid header, it's probably corrupted
@@ -320,6 +326,30 @@ size_t ZipCarver::find_end_of_central_directory(const uint8_t* data, size_t size
     return 0;
 }
 
+size_t ZipCarver::find_end_of_central_directory(const uint8_t* data, size_t offset, size_t size,
+                                                const std::vector<Offset>& footer_ends) const {
+    if (size < sizeof(ZipEndOfCentralDir)) {
+        return 0;
+    }
+    
+    // Same candidates as the backward scan, taken from the footer index:
+    // EOCD signatures past the start whose record fits in size
+    Offset last_start = offset + size - sizeof(ZipEndOfCentralDir);
+    auto end = std::upper_bound(footer_ends.begin(), footer_ends.end(), last_start + sizeof(uint32_t));
+    while (end != footer_ends.begin()) {
+        if (*--end <= offset + sizeof(uint32_t)) {
+            break;
+        }
+        Offset start = *end - sizeof(uint32_t);
+        const auto* eocd = reinterpret_cast<const ZipEndOfCentralDir*>(data + start);
+        if (validate_end_of_central_dir(eocd)) {
+            return start - offset;
+        }
+    }
+    
+    return 0;
+}
+
 bool ZipCarver::validate_local_file_header(const ZipLocalFileHeader* header) const {
     if (header->signature != LOCAL_FILE_HEADER_SIG) {
         return false;
@@ -383,23 +413,28 @@ bool ZipCarver::validate_end_of_central_dir(const ZipEndOfCentralDir* header) co
     return true;
 }
 
-size_t ZipCarver::calculate_zip_size(const uint8_t* data, size_t max_size) const {
+size_t ZipCarver::calculate_zip_size(const uint8_t* base, size_t base_size, size_t offset,
+                                     const SignatureHits& hits) const {
+    const uint8_t* data = base + offset;
+    size_t max_size = base_size - offset;
+    
     // Look for the next ZIP header signature after our current position
     // This is important to handle multiple adjacent ZIPs correctly
     size_t next_zip_offset = max_size;
-    for (size_t i = sizeof(ZipLocalFileHeader); i + 4 < max_size; ++i) {
-        uint32_t sig = *reinterpret_cast<const uint32_t*>(data + i);
+    auto next = std::lower_bound(hits.headers.begin(), hits.headers.end(), offset + sizeof(ZipLocalFileHeader));
+    for (; next != hits.headers.end() && *next + 4 < base_size; ++next) {
+        uint32_t sig = *reinterpret_cast<const uint32_t*>(base + *next);
         if (sig == LOCAL_FILE_HEADER_SIG) {
 #ifdef DEBUG
-            LOG_DEBUG("Found next ZIP signature at offset " + std::to_string(i) + ", limiting size to this boundary");
+            LOG_DEBUG("Found next ZIP signature at offset " + std::to_string(*next - offset) + ", limiting size to this boundary");
 #endif
-            next_zip_offset = i;
+            next_zip_offset = *next - offset;
             break;
         }
     }
     
     // Find End of Central Directory record
-    size_t eocd_pos = find_end_of_central_directory(data, next_zip_offset);
+    size_t eocd_pos = find_end_of_central_directory(base, offset, next_zip_offset, hits.footer_ends);
     if (eocd_pos == 0) {
         // Try to estimate size from local file headers
         size_t pos = 0;
@@ -0,0 +1,194 @@
+#include "core/bad_block_map.h"
+#include "utils/logger.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace FileRecovery {
+
+void BadBlockMap::add(Offset offset, Size size) {
+    if (size == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Offset start = offset;
+    Offset end = offset + size;
+
+    // Absorb the range that starts at or before us if it touches us
+    auto it = ranges_.upper_bound(start);
+    if (it != ranges_.begin()) {
+        auto prev = std::prev(it);
+        if (prev->second >= start) {
+            if (prev->second >= end) {
+                return;  // Already covered
+            }
+            start = prev->first;
+            it = prev;
+        }
+    }
+
+    // Absorb every range that starts inside or right after us
+    while (it != ranges_.end() && it->first <= end) {
+        end = std::max(end, it->second);
+        it = ranges_.erase(it);
+    }
+
+    ranges_[start] = end;
+    dirty_ = true;
+}
+
+bool BadBlockMap::overlaps(Offset offset, Size size) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ranges_.empty() || size == 0) {
+        return false;
+    }
+
+    Offset end = offset + size;
+    auto it = ranges_.lower_bound(end);
+    if (it == ranges_.begin()) {
+        return false;
+    }
+    // Last range starting before our end overlaps if it ends after our start
+    return std::prev(it)->second > offset;
+}
+
+bool BadBlockMap::findContaining(Offset offset, Offset& end) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ranges_.upper_bound(offset);
+    if (it == ranges_.begin()) {
+        return false;
+    }
+    --it;
+    if (it->second > offset) {
+        end = it->second;
+        return true;
+    }
+    return false;
+}
+
+Offset BadBlockMap::nextBadStart(Offset offset, Offset limit) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ranges_.upper_bound(offset);
+    if (it == ranges_.end() || it->first >= limit) {
+        return limit;
+    }
+    return it->first;
+}
+
+std::vector<std::pair<Offset, Size>> BadBlockMap::getRanges() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::pair<Offset, Size>> result;
+    result.reserve(ranges_.size());
+    for (const auto& range : ranges_) {
+        result.emplace_back(range.first, range.second - range.first);
+    }
+    return result;
+}
+
+Size BadBlockMap::getTotalBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Size total = 0;
+    for (const auto& range : ranges_) {
+        total += range.second - range.first;
+    }
+    return total;
+}
+
+bool BadBlockMap::isDirty() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dirty_;
+}
+
+bool BadBlockMap::load(const std::string& path, Size device_size) {
+    std::ifstream input(path);
+    if (!input) {
+        return false;
+    }
+
+    std::map<Offset, Offset> loaded;
+    std::string line;
+    bool size_checked = false;
+    while (std::getline(input, line)) {
+        if (line.empty()) {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        if (line[0] == '#') {
+            std::string hash, key;
+            Size recorded_size = 0;
+            fields >> hash >> key;
+            if (key == "device_size" && fields >> recorded_size) {
+                if (recorded_size != device_size) {
+                    LOG_WARNING("Bad block map " + path + " was written for a device of " +
+                                std::to_string(recorded_size) + " bytes, ignoring it");
+                    return false;
+                }
+                size_checked = true;
+            }
+            continue;
+        }
+
+        Offset offset = 0;
+        Size size = 0;
+        if (!(fields >> offset >> size) || size == 0 || offset >= device_size) {
+            LOG_WARNING("Skipping malformed bad block map entry: " + line);
+            continue;
+        }
+        loaded[offset] = std::min<Offset>(offset + size, device_size);
+    }
+
+    if (!size_checked) {
+        LOG_WARNING("Bad block map " + path + " has no device_size header, ignoring it");
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ranges_.clear();
+        dirty_ = false;
+    }
+    // Re-add through add() so overlapping entries from hand-edited files merge
+    for (const auto& range : loaded) {
+        add(range.first, range.second - range.first);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    dirty_ = false;
+    LOG_INFO("Loaded " + std::to_string(ranges_.size()) + " known bad ranges from " + path);
+    return true;
+}
+
+bool BadBlockMap::save(const std::string& path, Size device_size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string temp_path = path + ".tmp";
+
+    {
+        std::ofstream output(temp_path, std::ios::trunc);
+        if (!output) {
+            LOG_ERROR("Failed to write bad block map: " + temp_path);
+            return false;
+        }
+        output << "# filerec bad block map: offset length\n";
+        output << "# device_size " << device_size << "\n";
+        for (const auto& range : ranges_) {
+            output << range.first << " " << (range.second - range.first) << "\n";
+        }
+        if (!output.flush()) {
+            LOG_ERROR("Failed to write bad block map: " + temp_path);
+            return false;
+        }
+    }
+
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        LOG_ERROR("Failed to replace bad block map: " + path);
+        std::remove(temp_path.c_str());
+        return false;
+    }
+
+    dirty_ = false;
+    return true;
+}
+
+} // namespace FileRecovery
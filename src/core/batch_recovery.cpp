@@ -0,0 +1,240 @@
+#include "core/batch_recovery.h"
+#include "core/recovery_engine.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+namespace FileRecovery {
+
+// Scan workers per image when the number of images scanned at once is
+// not given; enough that every image keeps its reader and a few carvers busy
+constexpr size_t WORKERS_PER_ACTIVE_IMAGE = 4;
+
+// Checkpoint file kept in each image's output directory, as in single-image runs
+constexpr const char* CHECKPOINT_FILENAME = ".filerec.checkpoint";
+
+BatchRecovery::BatchRecovery(const ScanConfig& base_config, std::vector<BatchJob> jobs, size_t max_active)
+    : base_config_(base_config)
+    , jobs_(std::move(jobs))
+    , elapsed_seconds_(0.0)
+    , should_stop_(false) {
+
+    size_t scan_threads = base_config_.num_threads > 0 ? base_config_.num_threads
+                                                       : std::max(1u, std::thread::hardware_concurrency());
+    size_t extraction_threads = base_config_.extraction_threads > 0
+                                    ? base_config_.extraction_threads
+                                    : std::max<size_t>(1, std::min<size_t>(4, scan_threads / 2));
+    // One read batch in flight per worker that could carve it
+    shared_ = SharedScheduler::create(scan_threads, extraction_threads, scan_threads);
+
+    max_active_ = max_active > 0 ? max_active : std::max<size_t>(1, scan_threads / WORKERS_PER_ACTIVE_IMAGE);
+}
+
+BatchRecovery::~BatchRecovery() {
+    stop();
+    shared_.scan_pool->wait();
+    shared_.extraction_pool->wait();
+}
+
+bool BatchRecovery::loadManifest(const std::string& path, std::vector<BatchJob>& jobs) {
+    std::ifstream input(path);
+    if (!input) {
+        LOG_ERROR("Failed to open batch manifest: " + path);
+        return false;
+    }
+
+    jobs.clear();
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(input, line)) {
+        line_number++;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        size_t first = line.find_first_not_of(" \t");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+
+        // Tabs allow paths with spaces; otherwise any whitespace separates
+        std::vector<std::string> fields;
+        std::istringstream split(line.substr(first));
+        std::string field;
+        if (line.find('\t', first) != std::string::npos) {
+            while (std::getline(split, field, '\t')) {
+                field.erase(0, field.find_first_not_of(' '));
+                field.erase(field.find_last_not_of(' ') + 1);
+                if (!field.empty()) {
+                    fields.push_back(field);
+                }
+            }
+        } else {
+            while (split >> field) {
+                fields.push_back(field);
+            }
+        }
+
+        if (fields.size() != 2) {
+            LOG_ERROR("Malformed batch manifest line " + std::to_string(line_number) + ": " + line);
+            return false;
+        }
+        BatchJob job;
+        job.device_path = fields[0];
+        job.output_directory = fields[1];
+        jobs.push_back(job);
+    }
+    return true;
+}
+
+RecoveryStatus BatchRecovery::run() {
+    results_.assign(jobs_.size(), BatchResult());
+    for (size_t i = 0; i < jobs_.size(); ++i) {
+        results_[i].job = jobs_[i];
+    }
+    if (jobs_.empty()) {
+        LOG_WARNING("Batch has no images");
+        return RecoveryStatus::FAILED;
+    }
+
+    size_t runners = std::min(max_active_, jobs_.size());
+    LOG_INFO("Batch: " + std::to_string(jobs_.size()) + " images, " + std::to_string(runners) +
+             " at a time on " + std::to_string(shared_.scan_pool->getThreadCount()) + " scan and " +
+             std::to_string(shared_.extraction_pool->getThreadCount()) + " extraction workers, " +
+             std::to_string(shared_.io->getSlots()) + " read slots");
+
+    // Each runner scans images until none are left
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<size_t> next_job(0);
+    std::atomic<size_t> finished(0);
+    std::vector<std::thread> threads;
+    for (size_t r = 0; r < runners; ++r) {
+        threads.emplace_back([this, &next_job, &finished]() {
+            size_t index;
+            while (!should_stop_ && (index = next_job++) < jobs_.size()) {
+                runJob(index);
+                size_t done = ++finished;
+                if (progress_callback_) {
+                    progress_callback_(results_[index], done, jobs_.size());
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    elapsed_seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t succeeded = std::count_if(results_.begin(), results_.end(), [](const BatchResult& result) {
+        return result.status == RecoveryStatus::SUCCESS;
+    });
+    LOG_INFO("Batch complete: " + std::to_string(succeeded) + " of " + std::to_string(jobs_.size()) +
+             " images succeeded");
+    if (succeeded == jobs_.size()) {
+        return RecoveryStatus::SUCCESS;
+    }
+    return succeeded > 0 ? RecoveryStatus::PARTIAL_SUCCESS : RecoveryStatus::FAILED;
+}
+
+void BatchRecovery::stop() {
+    should_stop_ = true;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (RecoveryEngine* engine : active_engines_) {
+        engine->stopRecovery();
+    }
+}
+
+void BatchRecovery::runJob(size_t index) {
+    BatchResult& result = results_[index];
+    ScanConfig config = base_config_;
+    config.device_path = result.job.device_path;
+    config.output_directory = result.job.output_directory;
+    config.checkpoint_path = (std::filesystem::path(config.output_directory) / CHECKPOINT_FILENAME).string();
+
+    LOG_INFO("Batch: scanning " + config.device_path + " into " + config.output_directory);
+    auto start = std::chrono::steady_clock::now();
+
+    RecoveryEngine engine(config);
+    engine.setSharedScheduler(shared_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (should_stop_) {
+            return;
+        }
+        active_engines_.push_back(&engine);
+    }
+    result.started = true;
+
+    result.status = engine.startRecovery();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        active_engines_.erase(std::find(active_engines_.begin(), active_engines_.end(), &engine));
+    }
+
+    result.files_recovered = engine.getRecoveredFileCount();
+    result.files_saved = engine.getSavedFileCount();
+    result.bytes_scanned = engine.getPipelineStats().bytes_read;
+    result.bytes_extracted = engine.getBytesExtracted();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (should_stop_ && result.status == RecoveryStatus::SUCCESS) {
+        result.status = RecoveryStatus::PARTIAL_SUCCESS;
+    }
+
+    LOG_INFO("Batch: " + config.device_path + " " + statusName(result.status) + ", " +
+             std::to_string(result.files_saved) + " of " + std::to_string(result.files_recovered) +
+             " files saved");
+}
+
+bool BatchRecovery::writeSummary(const std::string& path) const {
+    std::ofstream output(path, std::ios::trunc);
+    if (!output) {
+        LOG_ERROR("Failed to write batch summary: " + path);
+        return false;
+    }
+
+    BatchResult total;
+    total.job.device_path = "TOTAL";
+    output << "device\toutput\tstatus\tfiles_recovered\tfiles_saved\tbytes_scanned\tbytes_extracted\tseconds\n";
+    output << std::fixed << std::setprecision(2);
+    auto write = [&output](const BatchResult& result, const char* status) {
+        output << result.job.device_path << '\t' << result.job.output_directory << '\t' << status << '\t'
+               << result.files_recovered << '\t' << result.files_saved << '\t' << result.bytes_scanned << '\t'
+               << result.bytes_extracted << '\t' << result.seconds << '\n';
+    };
+
+    size_t succeeded = 0;
+    for (const auto& result : results_) {
+        write(result, result.started ? statusName(result.status) : "NOT_STARTED");
+        total.files_recovered += result.files_recovered;
+        total.files_saved += result.files_saved;
+        total.bytes_scanned += result.bytes_scanned;
+        total.bytes_extracted += result.bytes_extracted;
+        succeeded += result.status == RecoveryStatus::SUCCESS ? 1 : 0;
+    }
+    // Images ran side by side, so the total time is the batch's own
+    total.seconds = elapsed_seconds_;
+    std::string status = std::to_string(succeeded) + "/" + std::to_string(results_.size()) + " SUCCESS";
+    write(total, status.c_str());
+
+    output.flush();
+    return static_cast<bool>(output);
+}
+
+const char* BatchRecovery::statusName(RecoveryStatus status) {
+    switch (status) {
+        case RecoveryStatus::SUCCESS: return "SUCCESS";
+        case RecoveryStatus::PARTIAL_SUCCESS: return "PARTIAL_SUCCESS";
+        case RecoveryStatus::ACCESS_DENIED: return "ACCESS_DENIED";
+        case RecoveryStatus::DEVICE_NOT_FOUND: return "DEVICE_NOT_FOUND";
+        case RecoveryStatus::INSUFFICIENT_SPACE: return "INSUFFICIENT_SPACE";
+        case RecoveryStatus::FAILED:
+        default: return "FAILED";
+    }
+}
+
+} // namespace FileRecovery
@@ -0,0 +1,102 @@
+#include "core/block_cache.h"
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+namespace FileRecovery {
+
+std::string BlockCacheStats::describe(Size block_size) const {
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(1)
+       << "Block cache: " << hits << " hits, " << misses << " misses ("
+       << hitRatio() * 100.0 << "% hit rate), " << evictions << " evictions, "
+       << (hits * block_size) / (1024.0 * 1024.0) << " MB of repeated reads avoided";
+    return ss.str();
+}
+
+BlockCache::BlockCache(Size block_size, Size capacity, size_t num_shards)
+    : block_size_(std::max<Size>(block_size, 1))
+    , capacity_(capacity)
+    , hits_(0)
+    , misses_(0)
+    , evictions_(0) {
+
+    num_shards = std::max<size_t>(num_shards, 1);
+    // Every shard can hold at least one block, even with a tiny budget
+    shard_capacity_ = std::max<Size>(capacity_ / num_shards, block_size_);
+
+    for (size_t i = 0; i < num_shards; ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+}
+
+bool BlockCache::lookup(uint64_t block, Size offset, Size size, Byte* buffer) {
+    Shard& shard = shardFor(block);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(block);
+    if (it == shard.index.end() || offset + size > it->second->data.size()) {
+        misses_++;
+        return false;
+    }
+
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    std::memcpy(buffer, it->second->data.data() + offset, size);
+    hits_++;
+    return true;
+}
+
+bool BlockCache::contains(uint64_t block) const {
+    Shard& shard = shardFor(block);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.index.count(block) > 0;
+}
+
+void BlockCache::insert(uint64_t block, const Byte* data, Size size) {
+    size = std::min(size, block_size_);
+    Shard& shard = shardFor(block);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(block);
+    if (it != shard.index.end()) {
+        shard.bytes -= it->second->data.size();
+        shard.lru.erase(it->second);
+        shard.index.erase(it);
+    }
+
+    while (!shard.lru.empty() && shard.bytes + size > shard_capacity_) {
+        Entry& victim = shard.lru.back();
+        shard.bytes -= victim.data.size();
+        shard.index.erase(victim.block);
+        shard.lru.pop_back();
+        evictions_++;
+    }
+
+    shard.lru.push_front(Entry{block, std::vector<Byte>(data, data + size)});
+    shard.index[block] = shard.lru.begin();
+    shard.bytes += size;
+}
+
+void BlockCache::clear() {
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->lru.clear();
+        shard->index.clear();
+        shard->bytes = 0;
+    }
+}
+
+BlockCacheStats BlockCache::getStats() const {
+    BlockCacheStats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    stats.evictions = evictions_;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        stats.bytes_cached += shard->bytes;
+    }
+    return stats;
+}
+
+} // namespace FileRecovery
@@ -0,0 +1,270 @@
+#include "core/carver_registry.h"
+#include "carvers/jpeg_carver.h"
+#include "carvers/pdf_carver.h"
+#include "carvers/png_carver.h"
+#include "carvers/zip_carver.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <cctype>
+#include <set>
+#include <sstream>
+
+namespace FileRecovery {
+
+namespace {
+
+std::string toUpper(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    return text;
+}
+
+std::vector<std::string> upperTypes(const FileCarver& carver) {
+    std::vector<std::string> types;
+    for (const auto& type : carver.getSupportedTypes()) {
+        types.push_back(toUpper(type));
+    }
+    return types;
+}
+
+bool containsType(const std::vector<std::string>& types, const std::string& type) {
+    return std::find(types.begin(), types.end(), type) != types.end();
+}
+
+} // namespace
+
+void ScanPlan::addCarver(const std::string& name, std::unique_ptr<FileCarver> carver) {
+    if (!carver) {
+        return;
+    }
+    owned_.push_back(std::move(carver));
+    addCarver(name, *owned_.back());
+}
+
+void ScanPlan::addCarver(const std::string& name, FileCarver& carver) {
+    CarverStage stage;
+    stage.carver = &carver;
+    stage.name = name;
+    stage.signatures = carver.getFileSignatures();
+    stage.footers = carver.getFileFooters();
+    stages_.push_back(std::move(stage));
+    buildMatchers();
+}
+
+void ScanPlan::buildMatchers() {
+    // Footer tags follow the stage indices, so every matcher is rebuilt
+    // when a stage is added
+    matcher_ = MultiPatternMatcher();
+    footer_matcher_ = MultiPatternMatcher();
+    footer_tags_.clear();
+    for (size_t i = 0; i < stages_.size(); ++i) {
+        for (const auto& signature : stages_[i].signatures) {
+            matcher_.addPattern(signature, i);
+        }
+    }
+    for (size_t i = 0; i < stages_.size(); ++i) {
+        for (const auto& footer : stages_[i].footers) {
+            if (footer.empty()) {
+                continue;
+            }
+            size_t tag = stages_.size() + footer_tags_.size();
+            matcher_.addPattern(footer, tag);
+            footer_matcher_.addPattern(footer, tag);
+            footer_tags_.push_back({i, footer.size()});
+        }
+    }
+    matcher_.build();
+    footer_matcher_.build();
+}
+
+void ScanPlan::collectFooters(const std::vector<std::vector<Offset>>& tag_hits,
+                              std::vector<SignatureHits>& hits) const {
+    std::vector<size_t> footer_count(stages_.size(), 0);
+    for (size_t k = 0; k < footer_tags_.size(); ++k) {
+        const FooterTag& footer = footer_tags_[k];
+        size_t tag = stages_.size() + k;
+        footer_count[footer.stage]++;
+        if (tag >= tag_hits.size()) {
+            continue;
+        }
+        auto& ends = hits[footer.stage].footer_ends;
+        for (Offset start : tag_hits[tag]) {
+            ends.push_back(start + footer.length);
+        }
+    }
+    // Several footers of one stage interleave, and may end at the same byte
+    for (size_t i = 0; i < stages_.size(); ++i) {
+        auto& ends = hits[i].footer_ends;
+        if (footer_count[i] > 1) {
+            std::sort(ends.begin(), ends.end());
+            ends.erase(std::unique(ends.begin(), ends.end()), ends.end());
+        }
+    }
+}
+
+void ScanPlan::findSignatures(const Byte* data, Size size, std::vector<SignatureHits>& hits) const {
+    std::vector<std::vector<Offset>> tag_hits;
+    matcher_.findAll(data, size, tag_hits);
+    hits.resize(stages_.size());
+    for (size_t i = 0; i < stages_.size(); ++i) {
+        hits[i].headers.clear();
+        hits[i].footer_ends.clear();
+        // A stage without signatures may have no tag of its own
+        if (i < tag_hits.size()) {
+            hits[i].headers.swap(tag_hits[i]);
+        }
+    }
+    collectFooters(tag_hits, hits);
+}
+
+void ScanPlan::findAlignedSignatures(const Byte* data, Size size, Offset base_offset, Size alignment,
+                                     std::vector<SignatureHits>& hits) const {
+    alignment = std::max<Size>(alignment, 1);
+    Size first = (alignment - base_offset % alignment) % alignment;
+    std::vector<std::vector<Offset>> tag_hits;
+    matcher_.findAllAligned(data, size, first, alignment, tag_hits);
+    hits.resize(stages_.size());
+    bool any_header = false;
+    for (size_t i = 0; i < stages_.size(); ++i) {
+        hits[i].headers.clear();
+        hits[i].footer_ends.clear();
+        if (i < tag_hits.size()) {
+            hits[i].headers.swap(tag_hits[i]);
+        }
+        any_header |= !hits[i].headers.empty();
+    }
+    // Without a header the carvers have nothing to end, so the full pass
+    // for footers is only paid for chunks that need it
+    if (any_header) {
+        footer_matcher_.findAll(data, size, tag_hits);
+        collectFooters(tag_hits, hits);
+    }
+}
+
+void ScanPlan::findFooters(const Byte* data, Size size, std::vector<SignatureHits>& hits) const {
+    std::vector<std::vector<Offset>> tag_hits;
+    footer_matcher_.findAll(data, size, tag_hits);
+    hits.resize(stages_.size());
+    for (auto& stage_hits : hits) {
+        stage_hits.headers.clear();
+        stage_hits.footer_ends.clear();
+    }
+    collectFooters(tag_hits, hits);
+}
+
+std::string ScanPlan::describe() const {
+    if (stages_.empty()) {
+        return "no carvers";
+    }
+    std::ostringstream ss;
+    for (size_t i = 0; i < stages_.size(); ++i) {
+        ss << (i > 0 ? ", " : "") << stages_[i].name << " (" << stages_[i].signatures.size()
+           << " signatures, " << stages_[i].footers.size() << " footers)";
+    }
+    return ss.str();
+}
+
+CarverRegistry& CarverRegistry::instance() {
+    static CarverRegistry registry;
+    return registry;
+}
+
+CarverRegistry::CarverRegistry() {
+    registerCarver("jpeg", []() { return std::make_unique<JpegCarver>(); });
+    registerCarver("pdf", []() { return std::make_unique<PdfCarver>(); });
+    registerCarver("png", []() { return std::make_unique<PngCarver>(); });
+    registerCarver("zip", []() { return std::make_unique<ZipCarver>(); });
+}
+
+bool CarverRegistry::registerCarver(const std::string& name, Factory factory) {
+    std::unique_ptr<FileCarver> probe = factory ? factory() : nullptr;
+    if (!probe) {
+        LOG_ERROR("Carver factory for " + name + " created no carver");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : entries_) {
+        if (entry.name == name) {
+            LOG_ERROR("Carver already registered: " + name);
+            return false;
+        }
+    }
+    Entry entry;
+    entry.name = name;
+    entry.factory = std::move(factory);
+    entry.types = upperTypes(*probe);
+    entries_.push_back(std::move(entry));
+    return true;
+}
+
+std::vector<std::string> CarverRegistry::getSupportedTypes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> types;
+    for (const auto& entry : entries_) {
+        for (const auto& type : entry.types) {
+            if (!containsType(types, type)) {
+                types.push_back(type);
+            }
+        }
+    }
+    return types;
+}
+
+ScanPlan CarverRegistry::createPlan(const std::vector<std::string>& types,
+                                    std::vector<std::string>* unknown_types) const {
+    std::vector<std::string> requested;
+    for (const auto& type : types) {
+        requested.push_back(toUpper(type));
+    }
+
+    std::vector<std::pair<std::string, Factory>> selected;
+    std::set<std::string> served;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& entry : entries_) {
+            bool wanted = requested.empty();
+            for (const auto& type : entry.types) {
+                if (containsType(requested, type)) {
+                    served.insert(type);
+                    wanted = true;
+                }
+            }
+            if (wanted) {
+                selected.emplace_back(entry.name, entry.factory);
+            }
+        }
+    }
+
+    if (unknown_types) {
+        unknown_types->clear();
+        for (size_t i = 0; i < requested.size(); ++i) {
+            if (!served.count(requested[i])) {
+                unknown_types->push_back(types[i]);
+            }
+        }
+    }
+
+    // Factories run outside the lock so they may use the registry themselves
+    ScanPlan plan;
+    for (const auto& carver : selected) {
+        plan.addCarver(carver.first, carver.second());
+    }
+    return plan;
+}
+
+bool CarverRegistry::matchesTypes(const FileCarver& carver, const std::vector<std::string>& types) {
+    if (types.empty()) {
+        return true;
+    }
+    for (const auto& type : upperTypes(carver)) {
+        for (const auto& requested : types) {
+            if (toUpper(requested) == type) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+} // namespace FileRecovery
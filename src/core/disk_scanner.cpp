@@ -2,23 +2,107 @@
 #include "utils/logger.h"
 #include <sys/stat.h>
 #include <sys/mman.h>
+#include <sys/sendfile.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <linux/fs.h>
 #include <sys/ioctl.h>
 #include <errno.h>
 #include <cstring>
+#include <algorithm>
 
 namespace FileRecovery {
 
+// Largest aligned span read per bounce-buffer round trip in direct I/O mode
+constexpr Size DIRECT_IO_BOUNCE_SIZE = 1024 * 1024;
+
+// Longest run of missing blocks loaded by a single cached read
+constexpr size_t CACHE_MAX_RUN_BLOCKS = 16;
+
+// Consecutive unreadable sectors treated as a damaged zone worth skipping
+constexpr unsigned DEGRADED_CLUSTER_SECTORS = 8;
+
+// First and largest skip-ahead distance past a damaged zone
+constexpr Size DEGRADED_SKIP_MIN = 64 * 1024;
+constexpr Size DEGRADED_SKIP_MAX = 16 * 1024 * 1024;
+
+// Buffer used by copyToFd() when the kernel cannot copy directly
+constexpr Size COPY_BUFFER_SIZE = 1024 * 1024;
+
+// Largest request handed to copy_file_range()/sendfile() at once
+constexpr Size KERNEL_COPY_MAX = 64 * 1024 * 1024;
+
+// How far ahead of the scan cursor mapped-view mode asks the kernel to prefetch
+constexpr Size MAPPED_READAHEAD_WINDOW = 64 * 1024 * 1024;
+
+namespace {
+
+// Write all of data, retrying short and interrupted writes
+bool writeFully(int fd, const Byte* data, Size size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<Size>(written);
+    }
+    return true;
+}
+
+} // namespace
+
 DiskScanner::DiskScanner(const std::string& device_path)
     : device_path_(device_path)
     , device_fd_(-1)
     , device_size_(0)
-    , is_initialized_(false) {
+    , is_initialized_(false)
+    , io_backend_type_(IoBackendType::SYNC)
+    , io_queue_depth_(1)
+    , direct_io_requested_(false)
+    , direct_fd_(-1)
+    , io_alignment_(BLOCK_SIZE_4K)
+    , buffer_pool_(std::make_unique<AlignedBufferPool>(BLOCK_SIZE_4K))
+    , mapped_view_requested_(false)
+    , mapped_base_(nullptr)
+    , willneed_end_(0)
+    , dontneed_end_(0)
+    , degraded_mode_(false)
+    , sector_size_(SECTOR_SIZE)
+    , bad_bytes_(0)
+    , skipped_bytes_(0)
+    , known_bad_bytes_(0)
+    , retry_reads_(0)
+    , copy_file_range_usable_(true)
+    , sendfile_usable_(true)
+    , copy_file_range_bytes_(0)
+    , sendfile_bytes_(0)
+    , buffered_bytes_(0) {
+}
+
+DiskScanner::DiskScanner(const std::string& device_path, const ScanConfig& config)
+    : DiskScanner(device_path) {
+    io_backend_type_ = config.io_backend;
+    io_queue_depth_ = config.io_queue_depth;
+    direct_io_requested_ = config.direct_io;
+    mapped_view_requested_ = config.use_mmap;
+    degraded_mode_ = config.degraded_mode;
+    bad_block_map_path_ = config.bad_block_map_path;
+    if (config.cache_size > 0 && config.cache_block_size > 0) {
+        block_cache_ = std::make_unique<BlockCache>(config.cache_block_size, config.cache_size);
+    }
 }
 
 DiskScanner::~DiskScanner() {
+    if (mapped_base_) {
+        munmap(mapped_base_, device_size_);
+    }
+    if (direct_fd_ >= 0) {
+        close(direct_fd_);
+    }
     if (device_fd_ >= 0) {
         close(device_fd_);
     }
@@ -55,6 +139,45 @@ bool DiskScanner::initialize() {
         return false;
     }
     
+    if (!openSegments()) {
+        close(device_fd_);
+        device_fd_ = -1;
+        return false;
+    }
+    
+    if (segments_ && (direct_io_requested_ || mapped_view_requested_)) {
+        // One descriptor or mapping cannot span several files
+        LOG_WARNING("Direct I/O and mapped view are not used for segmented images");
+        direct_io_requested_ = false;
+        mapped_view_requested_ = false;
+    }
+    
+    if (direct_io_requested_ && !openDirect()) {
+        LOG_WARNING("Direct I/O not supported for " + device_path_ + ", using buffered reads");
+    }
+    
+    if (direct_fd_ >= 0) {
+        sector_size_ = std::max(sector_size_, io_alignment_);
+    }
+    
+    if (degraded_mode_) {
+        // A read error inside a mapping is a SIGBUS, not an error return
+        if (mapped_view_requested_) {
+            LOG_WARNING("Mapped view is disabled in degraded-media mode");
+            mapped_view_requested_ = false;
+        }
+        if (!bad_block_map_path_.empty()) {
+            bad_blocks_.load(bad_block_map_path_, device_size_);
+        }
+        LOG_INFO("Degraded-media reads enabled (sector size " + std::to_string(sector_size_) + " bytes)");
+    }
+    
+    if (mapped_view_requested_ && !mapWholeDevice()) {
+        LOG_WARNING("Mapped view unavailable for " + device_path_ + ", using chunked reads");
+    }
+    
+    io_backend_ = IoBackend::create(io_backend_type_, io_queue_depth_);
+    
     is_initialized_ = true;
     LOG_INFO("Successfully initialized disk scanner. Device size: " + std::to_string(device_size_) + " bytes");
     
@@ -67,6 +190,10 @@ Size DiskScanner::readChunk(Offset offset, Size size, Byte* buffer) {
         return 0;
     }
     
+    if (buffer == nullptr || size == 0) {
+        return 0;
+    }
+    
     if (offset >= device_size_) {
         LOG_WARNING("Read offset beyond device size");
         return 0;
@@ -77,22 +204,629 @@ Size DiskScanner::readChunk(Offset offset, Size size, Byte* buffer) {
         size = device_size_ - offset;
     }
     
-    std::lock_guard<std::mutex> lock(access_mutex_);
+    if (degraded_mode_ && bad_blocks_.overlaps(offset, size)) {
+        return readDegraded(offset, size, buffer);
+    }
     
-    // Seek to offset
-    if (lseek(device_fd_, offset, SEEK_SET) != static_cast<off_t>(offset)) {
-        LOG_ERROR("Failed to seek to offset: " + std::to_string(offset));
+    int error = 0;
+    Size bytes_read = readRaw(offset, size, buffer, &error);
+    if (degraded_mode_ && error != 0 && bytes_read < size) {
+        bytes_read += readDegraded(offset + bytes_read, size - bytes_read, buffer + bytes_read);
+    }
+    return bytes_read;
+}
+
+Size DiskScanner::readRaw(Offset offset, Size size, Byte* buffer, int* error) {
+    if (fault_hook_ && fault_hook_(offset, size)) {
+        *error = EIO;
         return 0;
     }
     
-    // Read data
-    ssize_t bytes_read = read(device_fd_, buffer, size);
-    if (bytes_read < 0) {
-        LOG_ERROR("Failed to read from device: " + std::string(strerror(errno)));
+    if (segments_) {
+        return segments_->read(offset, size, buffer, error);
+    }
+    
+    if (direct_fd_ >= 0) {
+        return readDirect(offset, size, buffer, error);
+    }
+    
+    // pread() carries its own offset, so concurrent callers never contend
+    // on a shared file position and need no lock here
+    return preadFully(device_fd_, offset, size, buffer, error);
+}
+
+Size DiskScanner::readDegraded(Offset offset, Size size, Byte* buffer) {
+    DegradedState state;
+    state.skip_size = DEGRADED_SKIP_MIN;
+    
+    Offset end = offset + size;
+    Offset pos = offset;
+    while (pos < end) {
+        Offset bad_end = 0;
+        if (bad_blocks_.findContaining(pos, bad_end)) {
+            // Known bad from this or an earlier run: do not touch the drive
+            Size length = std::min<Offset>(bad_end, end) - pos;
+            std::memset(buffer + (pos - offset), 0, length);
+            known_bad_bytes_ += length;
+            pos += length;
+            continue;
+        }
+        
+        Offset good_end = bad_blocks_.nextBadStart(pos, end);
+        Size length = good_end - pos;
+        Size consumed = readSplit(pos, length, buffer + (pos - offset), state);
+        pos += consumed;
+        if (consumed < length) {
+            break;  // EOF
+        }
+    }
+    
+    return pos - offset;
+}
+
+Size DiskScanner::readSplit(Offset offset, Size size, Byte* buffer, DegradedState& state) {
+    Size done = 0;
+    Size attempt = size;
+    Size skip_start = 0;     // Last skipped span relative to offset, if it
+    Size skip_length = 0;    // may have run past the end of the damage
+    
+    // The damaged zone ended inside the last skip: find where by bisection
+    // (the zone is assumed contiguous) and read back the good tail
+    auto trim_skip = [&]() {
+        Size lo = skip_start;
+        Size hi = skip_start + skip_length;   // [hi, skip end) is known good
+        while (hi - lo > sector_size_) {
+            Size mid = lo + ((hi - lo) / 2) / sector_size_ * sector_size_;
+            int error = 0;
+            retry_reads_++;
+            if (readRaw(offset + mid, hi - mid, buffer + mid, &error) == hi - mid) {
+                hi = mid;
+            } else {
+                lo = mid;
+            }
+        }
+        
+        Size recovered = skip_start + skip_length - hi;
+        if (recovered > 0) {
+            std::memset(buffer + lo, 0, hi - lo);   // Drop partial data from the last probe
+            skipped_bytes_ -= recovered;
+            LOG_INFO("Recovered " + std::to_string(recovered) + " readable bytes at the end of a skipped zone");
+        }
+        bad_blocks_.add(offset + skip_start, hi - skip_start);
+        skip_length = 0;
+    };
+    
+    while (done < size) {
+        Offset pos = offset + done;
+        Size remaining = size - done;
+        
+        if (state.consecutive_bad >= DEGRADED_CLUSTER_SECTORS) {
+            // Dense damage: jump ahead instead of grinding through each sector
+            Size skip = std::min(remaining, state.skip_size);
+            std::memset(buffer + done, 0, skip);
+            skipped_bytes_ += skip;
+            skip_start = done;
+            skip_length = skip;
+            done += skip;
+            state.skip_size = std::min(state.skip_size * 2, DEGRADED_SKIP_MAX);
+            state.consecutive_bad = 0;
+            LOG_WARNING("Skipping " + std::to_string(skip) + " bytes of damaged media at offset " + std::to_string(pos));
+            continue;
+        }
+        
+        Size request = std::min(attempt, remaining);
+        int error = 0;
+        retry_reads_++;
+        Size got = readRaw(pos, request, buffer + done, &error);
+        if (got > 0 && skip_length > 0) {
+            trim_skip();
+        }
+        if (got > 0) {
+            done += got;
+            state.consecutive_bad = 0;
+            state.skip_size = DEGRADED_SKIP_MIN;
+            if (got == request) {
+                attempt = std::min(attempt * 2, size);  // Healthy again: grow back
+            }
+            continue;
+        }
+        if (skip_length > 0) {
+            // Still inside the damage, so the whole skip was bad
+            bad_blocks_.add(offset + skip_start, skip_length);
+            skip_length = 0;
+        }
+        if (error == 0) {
+            break;  // EOF
+        }
+        
+        if (request <= sector_size_) {
+            std::memset(buffer + done, 0, request);
+            bad_blocks_.add(pos, request);
+            bad_bytes_ += request;
+            done += request;
+            state.consecutive_bad++;
+            LOG_WARNING("Unreadable sector at offset " + std::to_string(pos) + ", zero-filled");
+            continue;
+        }
+        
+        // Narrow down on the failure by halving the request
+        attempt = std::max(sector_size_, (request / 2) / sector_size_ * sector_size_);
+    }
+    
+    if (skip_length > 0) {
+        bad_blocks_.add(offset + skip_start, skip_length);
+    }
+    
+    return done;
+}
+
+DegradedReadStats DiskScanner::getDegradedStats() const {
+    DegradedReadStats stats;
+    stats.bad_bytes = bad_bytes_;
+    stats.skipped_bytes = skipped_bytes_;
+    stats.known_bad_bytes = known_bad_bytes_;
+    stats.retry_reads = retry_reads_;
+    return stats;
+}
+
+Size DiskScanner::copyToFd(Offset offset, Size size, int out_fd) {
+    if (!is_initialized_ || device_fd_ < 0 || out_fd < 0 || offset >= device_size_) {
         return 0;
     }
+    size = std::min<Size>(size, device_size_ - offset);
+    
+    // Bad-sector handling and fault injection live on the read path
+    if (degraded_mode_ || fault_hook_) {
+        return copyBuffered(offset, size, out_fd);
+    }
+    
+    Size copied = 0;
+    if (segments_) {
+        for (const auto& piece : segments_->split(offset, size)) {
+            Size got = copyKernel(piece.fd, piece.file_offset, piece.size, out_fd);
+            copied += got;
+            if (got < piece.size) {
+                break;
+            }
+        }
+    } else {
+        copied = copyKernel(device_fd_, offset, size, out_fd);
+    }
+    
+    if (copied < size) {
+        copied += copyBuffered(offset + copied, size - copied, out_fd);
+    }
+    return copied;
+}
+
+Size DiskScanner::copyKernel(int in_fd, Offset in_offset, Size size, int out_fd) {
+    Size copied = 0;
+    
+    if (copy_file_range_usable_) {
+        while (copied < size) {
+            loff_t from = static_cast<loff_t>(in_offset + copied);
+            ssize_t result = copy_file_range(in_fd, &from, out_fd, nullptr,
+                                             std::min(size - copied, KERNEL_COPY_MAX), 0);
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result <= 0) {
+                // Cross-device copies, block-device sources and older
+                // kernels are refused; stop asking for this scanner
+                if (result < 0 && (errno == EXDEV || errno == EINVAL || errno == ENOSYS ||
+                                   errno == EOPNOTSUPP || errno == EBADF)) {
+                    if (copy_file_range_usable_.exchange(false)) {
+                        LOG_DEBUG("copy_file_range unavailable: " + std::string(strerror(errno)));
+                    }
+                }
+                break;
+            }
+            copied += static_cast<Size>(result);
+            copy_file_range_bytes_ += static_cast<Size>(result);
+        }
+    }
+    
+    if (sendfile_usable_) {
+        while (copied < size) {
+            off_t from = static_cast<off_t>(in_offset + copied);
+            ssize_t result = sendfile(out_fd, in_fd, &from, std::min(size - copied, KERNEL_COPY_MAX));
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result <= 0) {
+                if (result < 0 && (errno == EINVAL || errno == ENOSYS)) {
+                    if (sendfile_usable_.exchange(false)) {
+                        LOG_DEBUG("sendfile unavailable: " + std::string(strerror(errno)));
+                    }
+                }
+                break;
+            }
+            copied += static_cast<Size>(result);
+            sendfile_bytes_ += static_cast<Size>(result);
+        }
+    }
+    
+    return copied;
+}
+
+Size DiskScanner::copyBuffered(Offset offset, Size size, int out_fd) {
+    auto buffer = buffer_pool_->acquire(std::min(size, COPY_BUFFER_SIZE));
+    if (!buffer) {
+        return 0;
+    }
+    
+    Size copied = 0;
+    while (copied < size) {
+        Size length = std::min<Size>(buffer.capacity(), size - copied);
+        Size bytes_read = readCached(offset + copied, length, buffer.data());
+        if (bytes_read == 0 || !writeFully(out_fd, buffer.data(), bytes_read)) {
+            break;
+        }
+        copied += bytes_read;
+        buffered_bytes_ += bytes_read;
+        if (bytes_read < length) {
+            break;
+        }
+    }
+    return copied;
+}
+
+CopyStats DiskScanner::getCopyStats() const {
+    CopyStats stats;
+    stats.copy_file_range_bytes = copy_file_range_bytes_;
+    stats.sendfile_bytes = sendfile_bytes_;
+    stats.buffered_bytes = buffered_bytes_;
+    return stats;
+}
+
+bool DiskScanner::saveBadBlockMap() {
+    if (bad_block_map_path_.empty() || !bad_blocks_.isDirty()) {
+        return true;
+    }
+    if (!bad_blocks_.save(bad_block_map_path_, device_size_)) {
+        return false;
+    }
+    LOG_INFO("Saved " + std::to_string(bad_blocks_.getRanges().size()) + " bad ranges to " + bad_block_map_path_);
+    return true;
+}
+
+Size DiskScanner::readCached(Offset offset, Size size, Byte* buffer) {
+    if (!block_cache_ || size > block_cache_->getCapacity()) {
+        return readChunk(offset, size, buffer);
+    }
+    
+    if (!is_initialized_ || buffer == nullptr || size == 0 || offset >= device_size_) {
+        return readChunk(offset, size, buffer);
+    }
+    
+    Size block_size = block_cache_->getBlockSize();
+    Offset end = std::min<Offset>(offset + size, device_size_);
+    uint64_t last_block = (end - 1) / block_size;
+    Offset pos = offset;
+    
+    while (pos < end) {
+        uint64_t block = pos / block_size;
+        Size in_block = pos % block_size;
+        Size length = std::min<Size>(block_size - in_block, end - pos);
+        
+        if (block_cache_->lookup(block, in_block, length, buffer + (pos - offset))) {
+            pos += length;
+            continue;
+        }
+        
+        // Load this block together with the uncached blocks that follow it
+        uint64_t run_end = block + 1;
+        while (run_end <= last_block && run_end - block < CACHE_MAX_RUN_BLOCKS &&
+               !block_cache_->contains(run_end)) {
+            run_end++;
+        }
+        block_cache_->recordMisses(run_end - block - 1);
+        
+        Offset run_start = block * block_size;
+        Size run_size = std::min<Offset>(run_end * block_size, device_size_) - run_start;
+        AlignedBufferPool::Buffer staging = buffer_pool_->acquire(run_size);
+        if (!staging) {
+            break;
+        }
+        
+        // A short read may stop before pos, inside the block it starts in
+        Size got = readChunk(run_start, run_size, staging.data());
+        if (run_start + got <= pos) {
+            break;
+        }
+        
+        // Only complete blocks are cached so a short read is retried next time
+        for (uint64_t b = block; b < run_end; ++b) {
+            Size block_offset = (b - block) * block_size;
+            Size expected = std::min<Offset>(block_size, device_size_ - b * block_size);
+            if (block_offset + expected > got) {
+                break;
+            }
+            block_cache_->insert(b, staging.data() + block_offset, expected);
+        }
+        
+        Size available = std::min<Offset>(end, run_start + got) - pos;
+        std::memcpy(buffer + (pos - offset), staging.data() + (pos - run_start), available);
+        pos += available;
+        
+        if (got < run_size) {
+            break;
+        }
+    }
+    
+    return pos - offset;
+}
+
+BlockCacheStats DiskScanner::getCacheStats() const {
+    return block_cache_ ? block_cache_->getStats() : BlockCacheStats();
+}
+
+bool DiskScanner::openSegments() {
+    std::vector<std::string> paths = SegmentedImage::findSegments(device_path_);
+    if (paths.size() < 2) {
+        return true;  // Ordinary single file or device
+    }
+    
+    auto image = std::make_unique<SegmentedImage>();
+    if (!image->open(paths)) {
+        LOG_ERROR("Failed to open segmented image starting at: " + device_path_);
+        return false;
+    }
+    
+    device_size_ = image->getTotalSize();
+    segments_ = std::move(image);
+    LOG_INFO("Opened segmented image: " + std::to_string(paths.size()) + " segments, " +
+             std::to_string(device_size_) + " bytes");
+    return true;
+}
+
+bool DiskScanner::openDirect() {
+    direct_fd_ = open(device_path_.c_str(), O_RDONLY | O_LARGEFILE | O_DIRECT);
+    if (direct_fd_ < 0) {
+        LOG_DEBUG("O_DIRECT open failed: " + std::string(strerror(errno)));
+        return false;
+    }
+    
+    // Block devices may require more than 4K alignment (e.g. 4Kn drives are
+    // fine, but some arrays expose larger logical blocks)
+    struct stat st;
+    if (fstat(direct_fd_, &st) == 0 && S_ISBLK(st.st_mode)) {
+        int logical_block_size = 0;
+        if (ioctl(direct_fd_, BLKSSZGET, &logical_block_size) == 0 &&
+            static_cast<Size>(logical_block_size) > io_alignment_) {
+            io_alignment_ = static_cast<Size>(logical_block_size);
+            buffer_pool_ = std::make_unique<AlignedBufferPool>(io_alignment_);
+        }
+    }
+    
+    LOG_INFO("Direct I/O enabled (alignment " + std::to_string(io_alignment_) + " bytes)");
+    return true;
+}
+
+bool DiskScanner::isAlignedForDirect(Offset offset, Size size, const Byte* buffer) const {
+    return direct_fd_ >= 0 &&
+           offset % io_alignment_ == 0 &&
+           size % io_alignment_ == 0 &&
+           reinterpret_cast<uintptr_t>(buffer) % io_alignment_ == 0;
+}
+
+Size DiskScanner::readDirect(Offset offset, Size size, Byte* buffer, int* error_out) {
+    int error = 0;
+    if (error_out) {
+        *error_out = 0;
+    }
     
-    return static_cast<Size>(bytes_read);
+    if (isAlignedForDirect(offset, size, buffer)) {
+        Size bytes_read = preadFully(direct_fd_, offset, size, buffer, &error);
+        if (error != EINVAL) {
+            if (error_out) {
+                *error_out = error;
+            }
+            return bytes_read;
+        }
+        // The filesystem rejected this request; serve it buffered instead
+        return bytes_read + preadFully(device_fd_, offset + bytes_read, size - bytes_read, buffer + bytes_read, error_out);
+    }
+    
+    // Unaligned head/tail: read whole aligned blocks into a bounce buffer
+    const Offset end = offset + size;
+    const Offset aligned_end = buffer_pool_->alignUp(end);
+    auto bounce = buffer_pool_->acquire(std::min(aligned_end - buffer_pool_->alignDown(offset), DIRECT_IO_BOUNCE_SIZE));
+    if (!bounce) {
+        return preadFully(device_fd_, offset, size, buffer, error_out);
+    }
+    
+    Size total = 0;
+    while (offset + total < end) {
+        Offset pos = offset + total;
+        Offset block_start = buffer_pool_->alignDown(pos);
+        Size span = std::min<Size>(bounce.capacity(), aligned_end - block_start);
+        
+        Size got = preadFully(direct_fd_, block_start, span, bounce.data(), &error);
+        if (error == EINVAL) {
+            total += preadFully(device_fd_, pos, end - pos, buffer + total, error_out);
+            break;
+        }
+        
+        Size skip = pos - block_start;
+        if (got <= skip) {
+            if (error_out) {
+                *error_out = error;
+            }
+            break; // EOF or read error
+        }
+        
+        Size useful = std::min<Size>(got - skip, end - pos);
+        std::memcpy(buffer + total, bounce.data() + skip, useful);
+        total += useful;
+        
+        if (got < span) {
+            if (error_out) {
+                *error_out = error;
+            }
+            break; // Reached the device tail or a read error
+        }
+    }
+    
+    return total;
+}
+
+void DiskScanner::readBatch(std::vector<ReadRequest>& requests, const ReadCompletionCallback& on_complete) {
+    std::vector<ReadRequest> valid;
+    std::vector<size_t> valid_index;
+    valid.reserve(requests.size());
+    
+    for (size_t i = 0; i < requests.size(); ++i) {
+        ReadRequest& request = requests[i];
+        request.fd = device_fd_;
+        request.bytes_read = 0;
+        request.error = 0;
+        
+        if (!is_initialized_ || request.buffer == nullptr || request.offset >= device_size_) {
+            // Nothing to read, complete immediately
+            if (on_complete) {
+                on_complete(request);
+            }
+            continue;
+        }
+        
+        request.size = std::min(request.size, device_size_ - request.offset);
+        
+        if (degraded_mode_ && bad_blocks_.overlaps(request.offset, request.size)) {
+            // Keep the backend away from known-bad sectors
+            request.bytes_read = readDegraded(request.offset, request.size, request.buffer);
+            if (on_complete) {
+                on_complete(request);
+            }
+            continue;
+        }
+        
+        if (segments_) {
+            auto pieces = segments_->split(request.offset, request.size);
+            if (pieces.size() != 1) {
+                // Straddles a segment boundary: rare, so read it in place
+                request.bytes_read = readChunk(request.offset, request.size, request.buffer);
+                if (on_complete) {
+                    on_complete(request);
+                }
+                continue;
+            }
+            // The backend reads the segment file; completion maps back by index
+            valid.push_back(request);
+            valid.back().fd = pieces[0].fd;
+            valid.back().offset = pieces[0].file_offset;
+            valid_index.push_back(i);
+            continue;
+        }
+        
+        // Aligned chunks bypass the page cache; the unaligned device tail
+        // (or a caller's unaligned buffer) is read through the buffered fd
+        if (isAlignedForDirect(request.offset, request.size, request.buffer)) {
+            request.fd = direct_fd_;
+        }
+        
+        valid.push_back(request);
+        valid_index.push_back(i);
+    }
+    
+    if (valid.empty()) {
+        return;
+    }
+    
+    io_backend_->submitReads(valid, [&](ReadRequest& done) {
+        ReadRequest& original = requests[valid_index[&done - valid.data()]];
+        original.bytes_read = done.bytes_read;
+        original.error = done.error;
+        if (fault_hook_ && fault_hook_(original.offset, original.size)) {
+            original.bytes_read = 0;
+            original.error = EIO;
+        }
+        if (degraded_mode_ && original.error != 0 && original.bytes_read < original.size) {
+            original.bytes_read += readDegraded(original.offset + original.bytes_read,
+                                                original.size - original.bytes_read,
+                                                original.buffer + original.bytes_read);
+            original.error = 0;
+        }
+        if (on_complete) {
+            on_complete(original);
+        }
+    });
+}
+
+bool DiskScanner::registerBuffers(const std::vector<Byte*>& buffers, Size buffer_size) {
+    if (!io_backend_) {
+        return false;
+    }
+    return io_backend_->registerBuffers(buffers, buffer_size);
+}
+
+std::string DiskScanner::getIoBackendName() const {
+    return io_backend_ ? io_backend_->getName() : "none";
+}
+
+void DiskScanner::setIoQueueDepth(unsigned depth) {
+    depth = std::max(1u, depth);
+    if (depth == io_queue_depth_) {
+        return;
+    }
+    io_queue_depth_ = depth;
+    if (is_initialized_) {
+        io_backend_ = IoBackend::create(io_backend_type_, io_queue_depth_);
+    }
+}
+
+bool DiskScanner::mapWholeDevice() {
+    struct stat st;
+    if (fstat(device_fd_, &st) != 0 || !S_ISREG(st.st_mode)) {
+        // A failing block device would turn read errors into SIGBUS
+        LOG_DEBUG("Mapped view is only used for image files");
+        return false;
+    }
+    
+    void* mapped = mmap(nullptr, device_size_, PROT_READ, MAP_SHARED, device_fd_, 0);
+    if (mapped == MAP_FAILED) {
+        LOG_DEBUG("Whole-device mmap failed: " + std::string(strerror(errno)));
+        return false;
+    }
+    
+    mapped_base_ = static_cast<Byte*>(mapped);
+    madvise(mapped_base_, device_size_, MADV_SEQUENTIAL);
+    willneed_end_ = 0;
+    dontneed_end_ = 0;
+    
+    LOG_INFO("Mapped view enabled for " + std::to_string(device_size_) + " bytes");
+    return true;
+}
+
+const Byte* DiskScanner::getMappedView(Offset offset, Size size) const {
+    if (!mapped_base_ || offset > device_size_ || size > device_size_ - offset) {
+        return nullptr;
+    }
+    return mapped_base_ + offset;
+}
+
+void DiskScanner::adviseMappedWindow(Offset consumed_up_to, Offset cursor) {
+    if (!mapped_base_) {
+        return;
+    }
+    
+    const Size page_size = getpagesize();
+    
+    // Prefetch only the part of the window not already requested
+    Offset ahead_end = std::min(device_size_, cursor + MAPPED_READAHEAD_WINDOW);
+    Offset ahead_start = (std::max(cursor, willneed_end_) / page_size) * page_size;
+    if (ahead_end > ahead_start) {
+        madvise(mapped_base_ + ahead_start, ahead_end - ahead_start, MADV_WILLNEED);
+        willneed_end_ = ahead_end;
+    }
+    
+    // Release whole pages nobody will touch again
+    Offset drop_end = (std::min(consumed_up_to, device_size_) / page_size) * page_size;
+    if (drop_end > dontneed_end_) {
+        madvise(mapped_base_ + dontneed_end_, drop_end - dontneed_end_, MADV_DONTNEED);
+        posix_fadvise(device_fd_, dontneed_end_, drop_end - dontneed_end_, POSIX_FADV_DONTNEED);
+        dontneed_end_ = drop_end;
+    }
 }
 
 const Byte* DiskScanner::mapRegion(Offset offset, Size size) {
@@ -106,6 +840,11 @@ const Byte* DiskScanner::mapRegion(Offset offset, Size size) {
         return nullptr;
     }
     
+    // Reuse the whole-device mapping instead of paying for a new VMA
+    if (mapped_base_) {
+        return mapped_base_ + offset;
+    }
+    
     // Align offset to page boundary
     size_t page_size = getpagesize();
     Offset aligned_offset = (offset / page_size) * page_size;
@@ -127,6 +866,11 @@ void DiskScanner::unmapRegion(const Byte* ptr, Size size) {
         return;
     }
     
+    // Views into the whole-device mapping live as long as the scanner
+    if (mapped_base_ && ptr >= mapped_base_ && ptr < mapped_base_ + device_size_) {
+        return;
+    }
+    
     // Calculate the actual mapped address (page-aligned)
     size_t page_size = getpagesize();
     uintptr_t addr = reinterpret_cast<uintptr_t>(ptr);
@@ -139,6 +883,71 @@ void DiskScanner::unmapRegion(const Byte* ptr, Size size) {
     }
 }
 
+namespace {
+
+// Append the data extents of one regular file, shifted by base. Returns
+// false if the filesystem cannot report holes.
+bool appendFileExtents(int fd, Size size, Offset base, std::vector<std::pair<Offset, Size>>& extents) {
+    // Only the offset-taking reads are used elsewhere, so moving the
+    // descriptor's file position here does not disturb them
+    Offset pos = 0;
+    while (pos < size) {
+        off_t data = lseek(fd, pos, SEEK_DATA);
+        if (data < 0) {
+            if (errno == ENXIO) {
+                break;  // Only a hole remains
+            }
+            LOG_DEBUG("SEEK_DATA unsupported: " + std::string(strerror(errno)));
+            return false;
+        }
+        
+        off_t hole = lseek(fd, data, SEEK_HOLE);
+        Offset extent_end = hole < 0 ? size : std::min<Offset>(hole, size);
+        if (static_cast<Offset>(data) >= extent_end) {
+            break;
+        }
+        
+        // Extents continuing across a segment boundary are merged
+        if (!extents.empty() && extents.back().first + extents.back().second == base + data) {
+            extents.back().second += extent_end - data;
+        } else {
+            extents.emplace_back(base + data, extent_end - data);
+        }
+        pos = extent_end;
+    }
+    return true;
+}
+
+} // namespace
+
+std::vector<std::pair<Offset, Size>> DiskScanner::getDataExtents() const {
+    std::vector<std::pair<Offset, Size>> whole_device;
+    if (!is_initialized_ || device_size_ == 0) {
+        return whole_device;
+    }
+    whole_device.emplace_back(0, device_size_);
+    
+    std::vector<std::pair<Offset, Size>> extents;
+    if (segments_) {
+        for (const auto& segment : segments_->getSegments()) {
+            if (!appendFileExtents(segment.fd, segment.size, segment.start, extents)) {
+                return whole_device;
+            }
+        }
+        return extents;
+    }
+    
+    struct stat st;
+    if (fstat(device_fd_, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return whole_device;
+    }
+    
+    if (!appendFileExtents(device_fd_, device_size_, 0, extents)) {
+        return whole_device;
+    }
+    return extents;
+}
+
 std::vector<Byte> DiskScanner::readEntireDevice(Size max_size) {
     if (!is_initialized_) {
         LOG_ERROR("Scanner not initialized");
@@ -169,6 +978,9 @@ std::string DiskScanner::getDeviceInfo() const {
     }
     
     std::string info = "Device: " + device_path_ + "\\n";
+    if (segments_) {
+        info += "Segments: " + std::to_string(segments_->getSegments().size()) + "\\n";
+    }
     info += "Size: " + std::to_string(device_size_) + " bytes\\n";
     info += "Read-only: " + std::string(isReadOnly() ? "Yes" : "No");
     
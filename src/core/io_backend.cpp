@@ -0,0 +1,423 @@
+#include "core/io_backend.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <unistd.h>
+#include <errno.h>
+#include <cstring>
+
+#ifdef USE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+namespace FileRecovery {
+
+Size preadFully(int fd, Offset offset, Size size, Byte* buffer, int* error) {
+    Size total_read = 0;
+
+    if (error) {
+        *error = 0;
+    }
+
+    while (total_read < size) {
+        ssize_t bytes_read = pread(fd, buffer + total_read, size - total_read,
+                                   static_cast<off_t>(offset + total_read));
+        if (bytes_read < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (error) {
+                *error = errno;
+            }
+            LOG_ERROR("Failed to read from device at offset " + std::to_string(offset + total_read) +
+                      ": " + std::string(strerror(errno)));
+            return total_read;
+        }
+
+        if (bytes_read == 0) {
+            // Unexpected EOF (device shrank or short block device)
+            break;
+        }
+
+        total_read += static_cast<Size>(bytes_read);
+    }
+
+    return total_read;
+}
+
+std::unique_ptr<IoBackend> IoBackend::create(IoBackendType type, unsigned queue_depth) {
+    if (type == IoBackendType::IO_URING) {
+        auto backend = std::make_unique<UringIoBackend>(queue_depth);
+        if (backend->initialize()) {
+            LOG_INFO("Using io_uring read backend with queue depth " + std::to_string(queue_depth));
+            return backend;
+        }
+        LOG_WARNING("io_uring is not available, falling back to synchronous reads");
+    }
+
+    return std::make_unique<SyncIoBackend>();
+}
+
+// ---------------------------------------------------------------------------
+// SyncIoBackend
+// ---------------------------------------------------------------------------
+
+void SyncIoBackend::submitReads(std::vector<ReadRequest>& requests, const ReadCompletionCallback& on_complete) {
+    for (auto& request : requests) {
+        request.bytes_read = preadFully(request.fd, request.offset, request.size, request.buffer, &request.error);
+        if (on_complete) {
+            on_complete(request);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// UringIoBackend
+// ---------------------------------------------------------------------------
+
+UringIoBackend::UringIoBackend(unsigned queue_depth)
+    : queue_depth_(std::max(1u, queue_depth))
+    , ring_fd_(-1)
+    , sq_ring_ptr_(nullptr)
+    , sq_ring_size_(0)
+    , cq_ring_ptr_(nullptr)
+    , cq_ring_size_(0)
+    , sqes_(nullptr)
+    , sqes_size_(0)
+    , sq_tail_(nullptr)
+    , sq_mask_(nullptr)
+    , sq_array_(nullptr)
+    , cq_head_(nullptr)
+    , cq_tail_(nullptr)
+    , cq_mask_(nullptr)
+    , cqes_(nullptr) {
+}
+
+UringIoBackend::~UringIoBackend() {
+    teardown();
+}
+
+#ifdef USE_IO_URING
+
+namespace {
+
+// Wait between checks for completions once io_uring_enter has failed
+constexpr useconds_t FAILED_RING_POLL_US = 1000;
+
+int ioUringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int ioUringRegister(int ring_fd, unsigned opcode, const void* arg, unsigned nr_args) {
+    return static_cast<int>(syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+}
+
+} // namespace
+
+bool UringIoBackend::initialize() {
+    if (ring_fd_ >= 0) {
+        return true;
+    }
+
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+
+    ring_fd_ = ioUringSetup(queue_depth_, &params);
+    if (ring_fd_ < 0) {
+        LOG_WARNING("io_uring_setup failed: " + std::string(strerror(errno)));
+        return false;
+    }
+
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+
+    sq_ring_ptr_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ring_fd_, IORING_OFF_SQ_RING);
+    if (sq_ring_ptr_ == MAP_FAILED) {
+        sq_ring_ptr_ = nullptr;
+        LOG_WARNING("Failed to map io_uring submission ring: " + std::string(strerror(errno)));
+        teardown();
+        return false;
+    }
+
+    if (single_mmap) {
+        cq_ring_ptr_ = sq_ring_ptr_;
+    } else {
+        cq_ring_ptr_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            ring_fd_, IORING_OFF_CQ_RING);
+        if (cq_ring_ptr_ == MAP_FAILED) {
+            cq_ring_ptr_ = nullptr;
+            LOG_WARNING("Failed to map io_uring completion ring: " + std::string(strerror(errno)));
+            teardown();
+            return false;
+        }
+    }
+
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring_fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        LOG_WARNING("Failed to map io_uring SQE array: " + std::string(strerror(errno)));
+        teardown();
+        return false;
+    }
+    sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    auto* sq_base = static_cast<char*>(sq_ring_ptr_);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq_base + params.sq_off.tail);
+    sq_mask_ = reinterpret_cast<unsigned*>(sq_base + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned*>(sq_base + params.sq_off.array);
+
+    auto* cq_base = static_cast<char*>(cq_ring_ptr_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq_base + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq_base + params.cq_off.tail);
+    cq_mask_ = reinterpret_cast<unsigned*>(cq_base + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq_base + params.cq_off.cqes);
+
+    // The kernel may round the ring up; never keep more in flight than it holds
+    queue_depth_ = std::min(queue_depth_, params.sq_entries);
+
+    return true;
+}
+
+bool UringIoBackend::registerBuffers(const std::vector<Byte*>& buffers, Size buffer_size) {
+    std::lock_guard<std::mutex> lock(submit_mutex_);
+
+    if (ring_fd_ < 0 || buffers.empty()) {
+        return false;
+    }
+
+    if (!registered_buffers_.empty()) {
+        ioUringRegister(ring_fd_, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+        registered_buffers_.clear();
+    }
+
+    std::vector<iovec> iovecs(buffers.size());
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        iovecs[i].iov_base = buffers[i];
+        iovecs[i].iov_len = buffer_size;
+    }
+
+    if (ioUringRegister(ring_fd_, IORING_REGISTER_BUFFERS, iovecs.data(),
+                        static_cast<unsigned>(iovecs.size())) < 0) {
+        LOG_WARNING("Failed to register io_uring buffers, using unregistered reads: " +
+                    std::string(strerror(errno)));
+        return false;
+    }
+
+    for (Byte* buffer : buffers) {
+        registered_buffers_.emplace_back(buffer, buffer_size);
+    }
+
+    LOG_DEBUG("Registered " + std::to_string(buffers.size()) + " io_uring buffers of " +
+              std::to_string(buffer_size) + " bytes");
+    return true;
+}
+
+void UringIoBackend::submitReads(std::vector<ReadRequest>& requests, const ReadCompletionCallback& on_complete) {
+    std::lock_guard<std::mutex> lock(submit_mutex_);
+
+    if (ring_fd_ < 0) {
+        SyncIoBackend().submitReads(requests, on_complete);
+        return;
+    }
+
+    const size_t count = requests.size();
+    std::vector<bool> completed(count, false);
+    std::vector<size_t> retry;            // Requests to (re)submit before new ones
+    size_t next = 0;
+    unsigned in_flight = 0;
+    unsigned unsubmitted = 0;             // SQEs queued but not yet accepted by the kernel
+
+    for (auto& request : requests) {
+        request.bytes_read = 0;
+        request.error = 0;
+    }
+
+    auto finish = [&](size_t index) {
+        completed[index] = true;
+        if (on_complete) {
+            on_complete(requests[index]);
+        }
+    };
+
+    auto queueRead = [&](size_t index) {
+        ReadRequest& request = requests[index];
+        unsigned tail = *sq_tail_;
+        unsigned slot = tail & *sq_mask_;
+        io_uring_sqe* sqe = &sqes_[slot];
+        std::memset(sqe, 0, sizeof(*sqe));
+
+        Byte* target = request.buffer + request.bytes_read;
+        Size remaining = request.size - request.bytes_read;
+        int buffer_index = findRegisteredBuffer(target, remaining);
+
+        sqe->opcode = buffer_index >= 0 ? IORING_OP_READ_FIXED : IORING_OP_READ;
+        sqe->fd = request.fd;
+        sqe->off = request.offset + request.bytes_read;
+        sqe->addr = reinterpret_cast<uint64_t>(target);
+        sqe->len = static_cast<uint32_t>(std::min<Size>(remaining, 1u << 30));
+        sqe->buf_index = buffer_index >= 0 ? static_cast<uint16_t>(buffer_index) : 0;
+        sqe->user_data = index;
+
+        sq_array_[slot] = slot;
+        __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+        in_flight++;
+        unsubmitted++;
+    };
+
+    // Take everything that has completed off the completion queue
+    auto reapCompletions = [&]() {
+        unsigned head = *cq_head_;
+        unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            const io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+            size_t index = static_cast<size_t>(cqe.user_data);
+            int result = cqe.res;
+            head++;
+            in_flight--;
+
+            ReadRequest& request = requests[index];
+            if (result == -EINTR || result == -EAGAIN) {
+                retry.push_back(index);
+            } else if (result < 0) {
+                request.error = -result;
+                LOG_ERROR("io_uring read failed at offset " + std::to_string(request.offset + request.bytes_read) +
+                          ": " + std::string(strerror(-result)));
+                finish(index);
+            } else if (result == 0) {
+                finish(index); // EOF
+            } else {
+                request.bytes_read += static_cast<Size>(result);
+                if (request.bytes_read < request.size) {
+                    retry.push_back(index); // Short read, fetch the remainder
+                } else {
+                    finish(index);
+                }
+            }
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    };
+
+    while (next < count || !retry.empty() || in_flight > 0) {
+        // Top up the ring, favouring retries of partially completed reads
+        while (in_flight < queue_depth_ && (!retry.empty() || next < count)) {
+            if (!retry.empty()) {
+                queueRead(retry.back());
+                retry.pop_back();
+            } else {
+                queueRead(next++);
+            }
+        }
+
+        int submitted = ioUringEnter(ring_fd_, unsubmitted, 1, IORING_ENTER_GETEVENTS);
+        if (submitted < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+                continue;
+            }
+            LOG_ERROR("io_uring_enter failed: " + std::string(strerror(errno)));
+            break;
+        }
+        unsubmitted -= std::min(unsubmitted, static_cast<unsigned>(submitted));
+        reapCompletions();
+    }
+
+    if (next < count || !retry.empty() || in_flight > 0) {
+        // The kernel never saw the SQEs a failed enter did not accept, so
+        // they are taken back. Reads it did accept still write into the
+        // callers' buffers, which must not be closed under them or read
+        // into again below, so wait for those to complete first.
+        __atomic_store_n(sq_tail_, *sq_tail_ - unsubmitted, __ATOMIC_RELEASE);
+        in_flight -= unsubmitted;
+        unsubmitted = 0;
+        while (in_flight > 0) {
+            if (ioUringEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+                // Completions still arrive in the ring without the syscall
+                usleep(FAILED_RING_POLL_US);
+            }
+            reapCompletions();
+        }
+
+        // Drop the ring and complete the remaining requests synchronously
+        // so no chunk is lost; later batches use the synchronous path
+        teardown();
+        size_t remaining = static_cast<size_t>(std::count(completed.begin(), completed.end(), false));
+        LOG_WARNING("Completing " + std::to_string(remaining) + " reads synchronously after io_uring failure");
+        for (size_t index = 0; index < count; ++index) {
+            if (completed[index]) {
+                continue;
+            }
+            ReadRequest& request = requests[index];
+            request.bytes_read += preadFully(request.fd, request.offset + request.bytes_read,
+                                             request.size - request.bytes_read,
+                                             request.buffer + request.bytes_read, &request.error);
+            finish(index);
+        }
+    }
+}
+
+int UringIoBackend::findRegisteredBuffer(const Byte* ptr, Size size) const {
+    for (size_t i = 0; i < registered_buffers_.size(); ++i) {
+        const Byte* base = registered_buffers_[i].first;
+        if (ptr >= base && ptr + size <= base + registered_buffers_[i].second) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void UringIoBackend::teardown() {
+    if (sqes_) {
+        munmap(sqes_, sqes_size_);
+        sqes_ = nullptr;
+    }
+    if (cq_ring_ptr_ && cq_ring_ptr_ != sq_ring_ptr_) {
+        munmap(cq_ring_ptr_, cq_ring_size_);
+    }
+    cq_ring_ptr_ = nullptr;
+    if (sq_ring_ptr_) {
+        munmap(sq_ring_ptr_, sq_ring_size_);
+        sq_ring_ptr_ = nullptr;
+    }
+    if (ring_fd_ >= 0) {
+        close(ring_fd_);
+        ring_fd_ = -1;
+    }
+    registered_buffers_.clear();
+}
+
+#else // !USE_IO_URING
+
+bool UringIoBackend::initialize() {
+    LOG_WARNING("Built without io_uring support");
+    return false;
+}
+
+bool UringIoBackend::registerBuffers(const std::vector<Byte*>&, Size) {
+    return false;
+}
+
+void UringIoBackend::submitReads(std::vector<ReadRequest>& requests, const ReadCompletionCallback& on_complete) {
+    SyncIoBackend().submitReads(requests, on_complete);
+}
+
+int UringIoBackend::findRegisteredBuffer(const Byte*, Size) const {
+    return -1;
+}
+
+void UringIoBackend::teardown() {
+}
+
+#endif // USE_IO_URING
+
+} // namespace FileRecovery
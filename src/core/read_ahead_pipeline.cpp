@@ -0,0 +1,308 @@
+#include "core/read_ahead_pipeline.h"
+#include "core/disk_scanner.h"
+#include "core/scan_scheduler.h"
+#include "utils/cpu_topology.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace FileRecovery {
+
+double PipelineStats::readerStallFraction() const {
+    if (wall_time.count() <= 0) {
+        return 0.0;
+    }
+    return static_cast<double>(reader_stall.count()) / wall_time.count();
+}
+
+double PipelineStats::consumerStallFraction() const {
+    if (wall_time.count() <= 0 || consumers == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(consumer_stall.count()) / (static_cast<double>(wall_time.count()) * consumers);
+}
+
+std::string PipelineStats::describe() const {
+    double reader = readerStallFraction() * 100.0;
+    double consumer = consumerStallFraction() * 100.0;
+    double seconds = std::chrono::duration<double>(wall_time).count();
+    double mbps = seconds > 0.0 ? (bytes_read / (1024.0 * 1024.0)) / seconds : 0.0;
+
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(1)
+       << "Read-ahead pipeline: " << chunks_read << " chunks, " << mbps << " MB/s, "
+       << ring_slots << " slots; reader blocked on full ring " << reader << "% of the time, "
+       << "carvers starved for data " << consumer << "% -> bottleneck: ";
+    if (reader > consumer) {
+        ss << "carving (CPU)";
+    } else if (consumer > reader) {
+        ss << "reading (I/O)";
+    } else {
+        ss << "balanced";
+    }
+    return ss.str();
+}
+
+ReadAheadPipeline::ReadAheadPipeline(DiskScanner& scanner, size_t ring_slots, size_t max_batch)
+    : scanner_(scanner)
+    , ring_slots_(std::max<size_t>(1, ring_slots))
+    , max_batch_(std::max<size_t>(1, max_batch))
+    , io_scheduler_(nullptr)
+    , mapped_(false)
+    , reader_done_(false)
+    , stopping_(false) {
+}
+
+ReadAheadPipeline::~ReadAheadPipeline() {
+    stop();
+    join();
+}
+
+bool ReadAheadPipeline::start(const std::vector<std::pair<Offset, Size>>& ranges, Size max_chunk_size, size_t consumers) {
+    PipelineLane lane;
+    lane.range_count = ranges.size();
+    lane.slots = ring_slots_;
+    return start(ranges, max_chunk_size, consumers, {lane});
+}
+
+bool ReadAheadPipeline::start(const std::vector<std::pair<Offset, Size>>& ranges, Size max_chunk_size, size_t consumers,
+                              const std::vector<PipelineLane>& lanes) {
+    ranges_ = ranges;
+    mapped_ = scanner_.hasMappedView();
+
+    ring_slots_ = 0;
+    for (const auto& lane : lanes) {
+        ring_slots_ += std::max<size_t>(1, lane.slots);
+    }
+    slots_.clear();
+    slots_.resize(ring_slots_);
+    lanes_.assign(lanes.size(), LaneState());
+
+    std::vector<Byte*> buffer_ptrs;
+    size_t unplaced = 0;
+    size_t slot = 0;
+    for (size_t l = 0; l < lanes.size(); ++l) {
+        lanes_[l].next_range = lanes[l].first_range;
+        lanes_[l].end_range = std::min(lanes[l].first_range + lanes[l].range_count, ranges_.size());
+
+        for (size_t i = 0; i < std::max<size_t>(1, lanes[l].slots); ++i, ++slot) {
+            slots_[slot].busy = false;
+            slots_[slot].lane = l;
+            if (!mapped_) {
+                slots_[slot].buffer = scanner_.acquireBuffer(max_chunk_size);
+                if (!slots_[slot].buffer) {
+                    LOG_ERROR("Failed to allocate read-ahead ring buffers");
+                    return false;
+                }
+                // Carvers of this lane run on its node, so keep their input there
+                if (lanes[l].numa_node >= 0 &&
+                    !CpuTopology::bindMemory(slots_[slot].buffer.data(), slots_[slot].buffer.capacity(),
+                                             lanes[l].numa_node)) {
+                    unplaced++;
+                }
+                buffer_ptrs.push_back(slots_[slot].buffer.data());
+            }
+            lanes_[l].free_slots.push_back(slot);
+        }
+    }
+    if (unplaced > 0) {
+        LOG_DEBUG(std::to_string(unplaced) + " read-ahead buffers could not be placed on their NUMA node");
+    }
+
+    if (!mapped_) {
+        scanner_.registerBuffers(buffer_ptrs, max_chunk_size);
+    }
+
+    stats_ = PipelineStats();
+    stats_.ring_slots = ring_slots_;
+    stats_.consumers = consumers;
+    start_time_ = std::chrono::steady_clock::now();
+
+    reader_ = std::thread(&ReadAheadPipeline::readerLoop, this);
+    return true;
+}
+
+bool ReadAheadPipeline::next(Chunk& chunk, size_t lane) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (lane >= lanes_.size()) {
+        return false;
+    }
+    std::deque<size_t>& ready = lanes_[lane].ready_slots;
+
+    if (ready.empty() && !reader_done_ && !stopping_) {
+        auto wait_start = std::chrono::steady_clock::now();
+        ready_cv_.wait(lock, [this, &ready]() { return stopping_ || reader_done_ || !ready.empty(); });
+        stats_.consumer_stall += std::chrono::steady_clock::now() - wait_start;
+    }
+
+    if (stopping_ || ready.empty()) {
+        return false;
+    }
+
+    size_t slot = ready.front();
+    ready.pop_front();
+    chunk = slots_[slot].chunk;
+    return true;
+}
+
+void ReadAheadPipeline::release(const Chunk& chunk) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        slots_[chunk.slot].busy = false;
+        lanes_[slots_[chunk.slot].lane].free_slots.push_back(chunk.slot);
+    }
+    free_cv_.notify_one();
+}
+
+void ReadAheadPipeline::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    free_cv_.notify_all();
+    ready_cv_.notify_all();
+}
+
+void ReadAheadPipeline::join() {
+    if (reader_.joinable()) {
+        reader_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.wall_time = std::chrono::steady_clock::now() - start_time_;
+}
+
+PipelineStats ReadAheadPipeline::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void ReadAheadPipeline::setMaxBatch(size_t max_batch) {
+    max_batch_ = std::max<size_t>(1, max_batch);
+}
+
+void ReadAheadPipeline::readerLoop() {
+    size_t first_lane = 0;
+
+    while (true) {
+        std::vector<size_t> batch;
+        std::vector<size_t> batch_ranges;
+        Offset consumed_up_to = 0;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            bool remaining = std::any_of(lanes_.begin(), lanes_.end(), [](const LaneState& lane) {
+                return lane.next_range < lane.end_range;
+            });
+            if (!remaining) {
+                break;
+            }
+            if (!canRead() && !stopping_) {
+                // Ring is full: the carvers are behind
+                auto wait_start = std::chrono::steady_clock::now();
+                free_cv_.wait(lock, [this]() { return stopping_ || canRead(); });
+                stats_.reader_stall += std::chrono::steady_clock::now() - wait_start;
+            }
+            if (stopping_) {
+                break;
+            }
+
+            // One range per lane in turn, so every lane's carvers get data
+            bool took = true;
+            while (took && batch.size() < max_batch_) {
+                took = false;
+                for (size_t i = 0; i < lanes_.size() && batch.size() < max_batch_; ++i) {
+                    LaneState& lane = lanes_[(first_lane + i) % lanes_.size()];
+                    if (lane.free_slots.empty() || lane.next_range >= lane.end_range) {
+                        continue;
+                    }
+                    size_t slot = lane.free_slots.front();
+                    lane.free_slots.pop_front();
+                    slots_[slot].busy = true;
+                    slots_[slot].chunk = Chunk();
+                    slots_[slot].chunk.slot = slot;
+                    slots_[slot].chunk.offset = ranges_[lane.next_range].first;
+                    batch.push_back(slot);
+                    batch_ranges.push_back(lane.next_range++);
+                    took = true;
+                }
+            }
+            first_lane = (first_lane + 1) % lanes_.size();
+            consumed_up_to = lowestBusyOffset(ranges_[batch_ranges.front()].first);
+        }
+
+        if (mapped_) {
+            scanner_.adviseMappedWindow(consumed_up_to, ranges_[batch_ranges.front()].first);
+            for (size_t i = 0; i < batch.size(); ++i) {
+                Chunk& chunk = slots_[batch[i]].chunk;
+                chunk.size = ranges_[batch_ranges[i]].second;
+                chunk.data = scanner_.getMappedView(chunk.offset, chunk.size);
+                publish(batch[i]);
+            }
+            continue;
+        }
+
+        std::vector<ReadRequest> requests(batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            requests[i].offset = ranges_[batch_ranges[i]].first;
+            requests[i].size = ranges_[batch_ranges[i]].second;
+            requests[i].buffer = slots_[batch[i]].buffer.data();
+            requests[i].tag = batch[i];
+        }
+
+        // Each chunk becomes visible to consumers as soon as its read lands
+        if (io_scheduler_) {
+            io_scheduler_->acquire();
+        }
+        scanner_.readBatch(requests, [this](ReadRequest& request) {
+            Chunk& chunk = slots_[request.tag].chunk;
+            chunk.size = request.bytes_read;
+            chunk.data = slots_[request.tag].buffer.data();
+            chunk.error = request.error;
+            publish(request.tag);
+        });
+        if (io_scheduler_) {
+            io_scheduler_->release();
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reader_done_ = true;
+    }
+    ready_cv_.notify_all();
+}
+
+bool ReadAheadPipeline::canRead() const {
+    return std::any_of(lanes_.begin(), lanes_.end(), [](const LaneState& lane) {
+        return !lane.free_slots.empty() && lane.next_range < lane.end_range;
+    });
+}
+
+void ReadAheadPipeline::publish(size_t slot) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.chunks_read++;
+        stats_.bytes_read += slots_[slot].chunk.size;
+        lanes_[slots_[slot].lane].ready_slots.push_back(slot);
+    }
+    // Consumers of every lane share the condition variable
+    if (lanes_.size() > 1) {
+        ready_cv_.notify_all();
+    } else {
+        ready_cv_.notify_one();
+    }
+}
+
+Offset ReadAheadPipeline::lowestBusyOffset(Offset fallback) const {
+    Offset lowest = fallback;
+    for (const auto& slot : slots_) {
+        if (slot.busy) {
+            lowest = std::min(lowest, slot.chunk.offset);
+        }
+    }
+    return lowest;
+}
+
+} // namespace FileRecovery
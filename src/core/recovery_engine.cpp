@@ -1,27 +1,55 @@
 #include "core/recovery_engine.h"
 #include "core/file_system_detector.h"
-#include "carvers/jpeg_carver.h"
-#include "carvers/pdf_carver.h"
-#include "carvers/png_carver.h"
-#include "carvers/zip_carver.h"
+#include "core/read_ahead_pipeline.h"
 #include "filesystems/ext4_parser.h"
 #include "filesystems/ntfs_parser.h"
 #include "filesystems/fat32_parser.h"
+#include "utils/cpu_topology.h"
 #include "utils/logger.h"
+#include "utils/simd_utils.h"
 #include <thread>
-#include <future>
 #include <algorithm>
+#include <chrono>
 #include <filesystem>
-#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
 
 namespace FileRecovery {
 
+// Shortest stretch of uniform 4K blocks removed before carving. Shorter
+// runs are usually padding inside a file and are carved with their
+// surroundings so the file is not split.
+constexpr Size UNIFORM_SKIP_MIN_RUN = 64 * 1024;
+
+// Bytes before the previous window's end searched again for a footer
+// split across the two reads
+constexpr Size FOOTER_SEARCH_BACK = 64;
+
+// Bytes read past the window holding a spanning file's footer, for data
+// that follows the footer (a PNG chunk CRC, a ZIP archive comment)
+constexpr Size FOOTER_TAIL = 64 * 1024;
+
+// Files queued for extraction before the scan waits for the writers
+constexpr size_t MAX_PENDING_SAVES = 1024;
+
+// Checkpoint work unit of metadata recovery; chunk i is unit i + 1
+constexpr size_t METADATA_UNIT = 0;
+
 RecoveryEngine::RecoveryEngine(const ScanConfig& config)
     : config_(config)
-    , disk_scanner_(std::make_unique<DiskScanner>(config.device_path))
+    , disk_scanner_(std::make_unique<DiskScanner>(config.device_path, config))
     , is_running_(false)
     , should_stop_(false)
-    , current_progress_(0.0) {
+    , current_progress_(0.0)
+    , uniform_bytes_skipped_(0)
+    , span_bytes_read_(0)
+    , failed_chunks_(0)
+    , header_alignment_(1)
+    , recovered_count_(0)
+    , saved_count_(0)
+    , tuned_workers_(0)
+    , pending_saves_(0)
+    , bytes_extracted_(0) {
     
     initializeDefaultModules();
 }
@@ -38,7 +66,6 @@ RecoveryStatus RecoveryEngine::startRecovery() {
     
     LOG_INFO("Starting file recovery for device: " + config_.device_path);
     is_running_ = true;
-    should_stop_ = false;
     current_progress_ = 0.0;
     
     // Initialize disk scanner
@@ -57,52 +84,134 @@ RecoveryStatus RecoveryEngine::startRecovery() {
         return RecoveryStatus::INSUFFICIENT_SPACE;
     }
     
+    // Only the carvers for the requested types run on the chunks
+    if (!buildScanPlan() && config_.use_signature_recovery) {
+        LOG_ERROR("No carver supports the requested file types");
+        is_running_ = false;
+        return RecoveryStatus::FAILED;
+    }
+    header_alignment_ = resolveHeaderAlignment();
+    
+    // Scanning and extraction are separate stages with their own workers,
+    // so files are written while the scan is still reading the device
+    size_t num_threads = config_.num_threads > 0 ? config_.num_threads : getOptimalThreadCount();
+    if (shared_scheduler_) {
+        // Batch runs share their workers with the other engines
+        node_workers_.clear();
+        thread_pool_ = shared_scheduler_->scan_pool;
+        extraction_pool_ = shared_scheduler_->extraction_pool;
+        num_threads = thread_pool_->getThreadCount();
+    } else if (config_.numa_aware) {
+        // Placement depends on the current cpuset, so the pool is rebuilt per run
+        thread_pool_ = std::make_shared<ThreadPool>(planNumaWorkers());
+        num_threads = thread_pool_->getThreadCount();
+    } else if (!thread_pool_ || thread_pool_->getThreadCount() != num_threads) {
+        node_workers_.clear();
+        thread_pool_ = std::make_shared<ThreadPool>(num_threads);
+    }
+    if (!shared_scheduler_) {
+        size_t extraction_threads = config_.extraction_threads > 0 ? config_.extraction_threads
+                                                                   : std::max<size_t>(1, std::min<size_t>(4, num_threads / 2));
+        if (!extraction_pool_ || extraction_pool_->getThreadCount() != extraction_threads) {
+            extraction_pool_ = std::make_shared<ThreadPool>(extraction_threads);
+        }
+    }
+    scan_tasks_ = std::make_unique<TaskGroup>(*thread_pool_,
+                                              shared_scheduler_ ? shared_scheduler_->scan_queue : nullptr);
+    extraction_tasks_ = std::make_unique<TaskGroup>(*extraction_pool_,
+                                                    shared_scheduler_ ? shared_scheduler_->extraction_queue : nullptr);
+    
+    // The pool keeps every worker; the tuner decides how many of them carve
+    if (config_.auto_tune) {
+        tuneScan(num_threads);
+    } else {
+        tuner_.reset();
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(results_mutex_);
+        recovered_files_.clear();
+        seen_files_.clear();
+    }
+    recovered_count_ = 0;
+    saved_count_ = 0;
+    bytes_extracted_ = 0;
+    failed_chunks_ = 0;
+    span_bytes_read_ = 0;
+    
+    if (!openCheckpoint()) {
+        is_running_ = false;
+        return RecoveryStatus::FAILED;
+    }
+    
     updateProgress(5.0, "Initialization complete, starting recovery...");
     
     RecoveryStatus status = RecoveryStatus::SUCCESS;
     
     try {
-        // Phase 1: Metadata-based recovery (if enabled)
-        if (config_.use_metadata_recovery) {
+        // Results are saved by the extraction stage as they are emitted, so
+        // files appear in the output directory while the scan is still running
+        
+        // Phase 1: Metadata-based recovery (if enabled and not done by an earlier run)
+        if (config_.use_metadata_recovery && !should_stop_ && !(checkpoint_ && checkpoint_->isMetadataDone())) {
             updateProgress(10.0, "Performing metadata-based recovery...");
-            auto metadata_files = performMetadataRecovery();
-            
-            std::lock_guard<std::mutex> lock(results_mutex_);
-            recovered_files_.insert(recovered_files_.end(), 
-                                  metadata_files.begin(), metadata_files.end());
-            
+            for (const auto& file : performMetadataRecovery()) {
+                emitFile(file, METADATA_UNIT);
+            }
             updateProgress(30.0, "Metadata recovery complete");
         }
+        finishUnitWork(METADATA_UNIT);
         
         // Phase 2: Signature-based recovery (if enabled)
         if (config_.use_signature_recovery && !should_stop_) {
             updateProgress(35.0, "Performing signature-based recovery...");
-            auto signature_files = performSignatureRecovery();
-            
-            std::lock_guard<std::mutex> lock(results_mutex_);
-            recovered_files_.insert(recovered_files_.end(), 
-                                  signature_files.begin(), signature_files.end());
-            
+            performSignatureRecovery();
             updateProgress(80.0, "Signature recovery complete");
         }
         
-        // Phase 3: Post-processing
+        // Phase 3: Finish saving what is still queued
+        updateProgress(90.0, "Saving recovered files...");
+        auto drain_start = std::chrono::steady_clock::now();
+        scan_tasks_->wait();
+        extraction_tasks_->wait();
+        double drain_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - drain_start).count();
+        CopyStats copy_stats = disk_scanner_->getCopyStats();
+        LOG_INFO("Extraction: " + std::to_string(bytes_extracted_) + " bytes written by " +
+                 std::to_string(extraction_pool_->getThreadCount()) + " workers (" +
+                 std::to_string(copy_stats.copy_file_range_bytes) + " via copy_file_range, " +
+                 std::to_string(copy_stats.sendfile_bytes) + " via sendfile, " +
+                 std::to_string(copy_stats.buffered_bytes) + " buffered), finished " +
+                 std::to_string(static_cast<long long>(drain_ms)) + " ms after the scan");
+        
+        if (config_.keep_recovered_files) {
+            std::lock_guard<std::mutex> lock(results_mutex_);
+            std::sort(recovered_files_.begin(), recovered_files_.end(),
+                      [](const RecoveredFile& a, const RecoveredFile& b) {
+                          if (a.start_offset != b.start_offset) {
+                              return a.start_offset < b.start_offset;
+                          }
+                          return a.file_size < b.file_size;
+                      });
+        }
+        for (const auto& sink : result_sinks_) {
+            sink->onRecoveryFinished(recovered_count_);
+        }
+        
         if (!should_stop_) {
-            updateProgress(85.0, "Post-processing results...");
-            deduplicateFiles();
-            updateProgress(90.0, "Saving recovered files...");
+            LOG_INFO("Recovery complete. Saved " + std::to_string(saved_count_) + 
+                    " out of " + std::to_string(recovered_count_) + " files");
             
-            // Save all recovered files
-            size_t saved_count = 0;
-            for (const auto& file : recovered_files_) {
-                if (should_stop_) break;
-                if (saveRecoveredFile(file)) {
-                    saved_count++;
-                }
+            if (disk_scanner_->isDegradedMode()) {
+                DegradedReadStats degraded = disk_scanner_->getDegradedStats();
+                LOG_INFO("Degraded media: " + std::to_string(degraded.bad_bytes) + " bytes in bad sectors, " +
+                         std::to_string(degraded.skipped_bytes) + " bytes skipped past damaged zones, " +
+                         std::to_string(degraded.known_bad_bytes) + " known-bad bytes not retried, " +
+                         std::to_string(degraded.retry_reads) + " retry reads");
             }
             
-            LOG_INFO("Recovery complete. Saved " + std::to_string(saved_count) + 
-                    " out of " + std::to_string(recovered_files_.size()) + " files");
+            if (disk_scanner_->hasBlockCache()) {
+                LOG_INFO(disk_scanner_->getCacheStats().describe(disk_scanner_->getCacheBlockSize()));
+            }
         }
         
         updateProgress(100.0, "Recovery complete");
@@ -112,23 +221,39 @@ RecoveryStatus RecoveryEngine::startRecovery() {
         status = RecoveryStatus::FAILED;
     }
     
+    // Persist bad sectors even for interrupted runs so the next run skips them
+    disk_scanner_->saveBadBlockMap();
+    
+    // A finished run needs no checkpoint; an interrupted one keeps it for --resume
+    if (checkpoint_) {
+        // Saves still queued after a failure report to the checkpoint
+        scan_tasks_->wait();
+        extraction_tasks_->wait();
+        if (failed_chunks_ > 0) {
+            LOG_WARNING(std::to_string(failed_chunks_) + " chunks could not be read; resume to retry them");
+        }
+        if (should_stop_ || status != RecoveryStatus::SUCCESS || failed_chunks_ > 0) {
+            if (checkpoint_->save()) {
+                LOG_INFO("Checkpoint saved to " + checkpoint_->getPath() + " (" +
+                         std::to_string(checkpoint_->getCompletedBytes()) + " bytes scanned, " +
+                         std::to_string(checkpoint_->getResultCount()) + " files recorded)");
+            }
+        } else {
+            checkpoint_->remove();
+        }
+        checkpoint_.reset();
+    }
+    
     is_running_ = false;
     return status;
 }
 
 void RecoveryEngine::stopRecovery() {
+    // Kept for a run that has not started yet, so a stop racing
+    // startRecovery() is not lost
+    should_stop_ = true;
     if (is_running_) {
         LOG_INFO("Stopping recovery...");
-        should_stop_ = true;
-        
-        // Wait for worker threads to finish
-        for (auto& thread : worker_threads_) {
-            if (thread.joinable()) {
-                thread.join();
-            }
-        }
-        worker_threads_.clear();
-        
         is_running_ = false;
         LOG_INFO("Recovery stopped");
     }
@@ -142,6 +267,14 @@ void RecoveryEngine::addFileCarver(std::unique_ptr<FileCarver> carver) {
     file_carvers_.push_back(std::move(carver));
 }
 
+void RecoveryEngine::setSharedScheduler(const SharedScheduler& shared) {
+    shared_scheduler_ = std::make_unique<SharedScheduler>(shared);
+}
+
+void RecoveryEngine::addResultSink(std::unique_ptr<ResultSink> sink) {
+    result_sinks_.push_back(std::move(sink));
+}
+
 void RecoveryEngine::addFilesystemParser(std::unique_ptr<FilesystemParser> parser) {
     filesystem_parsers_.push_back(std::move(parser));
 }
@@ -151,12 +284,6 @@ void RecoveryEngine::setProgressCallback(std::function<void(double, const std::s
 }
 
 void RecoveryEngine::initializeDefaultModules() {
-    // Add default file carvers
-    file_carvers_.push_back(std::make_unique<JpegCarver>());
-    file_carvers_.push_back(std::make_unique<PdfCarver>());
-    file_carvers_.push_back(std::make_unique<PngCarver>());
-    file_carvers_.push_back(std::make_unique<ZipCarver>());
-    
     // Add default filesystem parsers
     filesystem_parsers_.push_back(std::make_unique<Ext4Parser>());
     filesystem_parsers_.push_back(std::make_unique<NtfsParser>());
@@ -171,7 +298,7 @@ std::vector<RecoveredFile> RecoveryEngine::performMetadataRecovery() {
     // Detect filesystem type
     FileSystemDetector detector;
     std::vector<Byte> buffer(8192);
-    auto bytes_read = disk_scanner_->readChunk(0, 8192, buffer.data()); // Read first 8KB for filesystem detection
+    auto bytes_read = disk_scanner_->readCached(0, 8192, buffer.data()); // Read first 8KB for filesystem detection
     
     if (bytes_read == 0) {
         LOG_ERROR("Failed to read data for filesystem detection");
@@ -203,7 +330,7 @@ std::vector<RecoveredFile> RecoveryEngine::performMetadataRecovery() {
     
     // Initialize parser with data
     std::vector<Byte> partition_data(std::min(disk_scanner_->getDeviceSize(), static_cast<Size>(100 * 1024 * 1024)));
-    auto partition_bytes_read = disk_scanner_->readChunk(0, partition_data.size(), partition_data.data());
+    auto partition_bytes_read = disk_scanner_->readCached(0, partition_data.size(), partition_data.data());
     
     if (partition_bytes_read == 0) {
         LOG_ERROR("Failed to read partition data");
@@ -226,97 +353,477 @@ std::vector<RecoveredFile> RecoveryEngine::performMetadataRecovery() {
     return recovered;
 }
 
-std::vector<RecoveredFile> RecoveryEngine::performSignatureRecovery() {
-    std::vector<RecoveredFile> recovered;
-    
+size_t RecoveryEngine::performSignatureRecovery() {
     Size device_size = disk_scanner_->getDeviceSize();
     Size chunk_size = config_.chunk_size;
-    size_t num_threads = config_.num_threads > 0 ? config_.num_threads : getOptimalThreadCount();
+    Size window_size = chunk_size + config_.chunk_overlap;
+    size_t num_threads = thread_pool_->getThreadCount();
+    bool mapped = disk_scanner_->hasMappedView();
+    
+    // Calculate chunk ranges over the data extents only; holes in sparse
+    // images read as zeros and cannot contain a file signature
+    std::vector<std::pair<Offset, Size>> ranges;
+    Size data_bytes = 0;
+    Size resumed_bytes = 0;
+    for (const auto& extent : disk_scanner_->getDataExtents()) {
+        Offset extent_end = extent.first + extent.second;
+        for (Offset chunk_start = extent.first; chunk_start < extent_end; chunk_start += chunk_size) {
+            // Chunks a resumed run already finished are not read again
+            Size owned = std::min<Size>(chunk_size, extent_end - chunk_start);
+            if (checkpoint_ && checkpoint_->isCompleted(chunk_start, owned)) {
+                resumed_bytes += owned;
+                continue;
+            }
+            // Each chunk is read with an overlap so files crossing its end are carved whole
+            ranges.emplace_back(chunk_start, std::min<Size>(window_size, extent_end - chunk_start));
+        }
+        data_bytes += extent.second;
+    }
+    size_t num_chunks = ranges.size();
+    Size skipped_bytes = device_size - data_bytes;
+    if (skipped_bytes > 0) {
+        LOG_INFO("Skipping " + std::to_string(skipped_bytes) + " bytes of holes in sparse image (" +
+                 std::to_string(data_bytes) + " bytes of data)");
+    }
+    if (resumed_bytes > 0) {
+        LOG_INFO("Skipping " + std::to_string(resumed_bytes) + " bytes scanned before the checkpoint");
+    }
+    if (num_chunks == 0 || scan_plan_.empty()) {
+        return 0;
+    }
+    
+    if (checkpoint_) {
+        std::lock_guard<std::mutex> lock(checkpoint_mutex_);
+        unit_pending_.resize(1 + num_chunks, 1);
+        unit_ranges_.clear();
+        for (const auto& range : ranges) {
+            unit_ranges_.emplace_back(range.first, std::min(range.second, chunk_size));
+        }
+    }
     
+    // The reader stays up to read_ahead_chunks ahead of the carvers, with
+    // one extra slot per carver for the chunk it is working on
+    size_t read_ahead = std::max<size_t>(1, config_.read_ahead_chunks);
+    size_t ring_slots = num_threads + read_ahead;
+    size_t max_batch = std::max<size_t>(1, config_.io_queue_depth);
+    ReadAheadPipeline pipeline(*disk_scanner_, ring_slots, max_batch);
+    pipeline.setIoScheduler(shared_scheduler_ ? shared_scheduler_->io.get() : nullptr);
+    if (tuner_) {
+        tuner_->startRun(tuned_workers_, static_cast<unsigned>(max_batch));
+    }
+    
+    // NUMA-aware scans give each node a contiguous share of the chunks,
+    // sized by its worker count, read into buffers on that node. A mapped
+    // view has no buffers to place and needs one sequential reader.
+    std::vector<PipelineLane> lanes;
+    std::vector<int> lane_nodes;
+    if (!node_workers_.empty() && !mapped) {
+        size_t assigned = 0;
+        size_t workers_before = 0;
+        for (const auto& node : node_workers_) {
+            workers_before += node.second;
+            size_t lane_end = num_chunks * workers_before / num_threads;
+            PipelineLane lane;
+            lane.first_range = assigned;
+            lane.range_count = lane_end - assigned;
+            lane.slots = node.second + read_ahead;
+            lane.numa_node = node.first;
+            lanes.push_back(lane);
+            lane_nodes.push_back(node.first);
+            assigned = lane_end;
+        }
+    } else {
+        PipelineLane lane;
+        lane.range_count = num_chunks;
+        lane.slots = ring_slots;
+        lanes.push_back(lane);
+        lane_nodes.push_back(-1);
+    }
+    
+    std::string io_mode = mapped ? std::string("mapped view") :
+                          disk_scanner_->getIoBackendName() +
+                          (disk_scanner_->isDirectIo() ? " + O_DIRECT" : "") +
+                          " (queue depth " + std::to_string(max_batch) + ")";
     LOG_INFO("Starting signature-based recovery with " + std::to_string(num_threads) + 
-             " threads, chunk size: " + std::to_string(chunk_size));
+             " threads, chunk size: " + std::to_string(chunk_size) +
+             " (+" + std::to_string(config_.chunk_overlap) + " overlap), I/O: " + io_mode +
+             ", read-ahead: " + std::to_string(ring_slots) + " slots" +
+             (header_alignment_ > 1 ? ", headers every " + std::to_string(header_alignment_) + " bytes" : std::string()) +
+             (lane_nodes.front() >= 0 ? ", " + std::to_string(lanes.size()) + " NUMA lanes" : std::string()));
+    
+    if (!pipeline.start(ranges, window_size, num_threads, lanes)) {
+        return 0;
+    }
     
-    // Calculate number of chunks
-    size_t num_chunks = (device_size + chunk_size - 1) / chunk_size;
     std::atomic<size_t> completed_chunks(0);
+    std::atomic<Size> processed_bytes(skipped_bytes + resumed_bytes);
+    std::atomic<Size> uniform_bytes(0);
+    std::atomic<size_t> candidates(0);
     
-    // Process chunks in parallel
-    std::vector<std::future<std::vector<RecoveredFile>>> futures;
+    // Chunks can finish out of order; the dedup watermark is the start of
+    // the first chunk that has not finished yet
+    std::vector<bool> chunk_done(num_chunks, false);
+    size_t first_unfinished = 0;
+    std::mutex watermark_mutex;
     
-    for (size_t i = 0; i < num_chunks && !should_stop_; ++i) {
-        Offset chunk_start = i * chunk_size;
-        Size current_chunk_size = std::min(chunk_size, device_size - chunk_start);
+    // One task per chunk. Each takes whichever chunk the reader has ready
+    // next, so a slow chunk only occupies its own worker while idle
+    // workers steal the tasks queued behind it.
+    auto carve_next_chunk = [&](size_t lane) {
+        ReadAheadPipeline::Chunk chunk;
+        if (!pipeline.next(chunk, lane)) {
+            return;
+        }
+        if (should_stop_) {
+            pipeline.release(chunk);
+            pipeline.stop();
+            return;
+        }
         
-        // Launch async task for this chunk
-        futures.push_back(std::async(std::launch::async, [this, chunk_start, current_chunk_size, &completed_chunks, num_chunks]() {
-            std::vector<RecoveredFile> chunk_results;
-            
-            // Read chunk data
-            std::vector<Byte> chunk_data(current_chunk_size);
-            Size bytes_read = disk_scanner_->readChunk(chunk_start, current_chunk_size, chunk_data.data());
-            
-            if (bytes_read > 0) {
-                // Apply all carvers to this chunk
-                for (const auto& carver : file_carvers_) {
-                    if (should_stop_) break;
-                    
-                    auto files = carver->carveFiles(chunk_data.data(), bytes_read, chunk_start);
-                    chunk_results.insert(chunk_results.end(), files.begin(), files.end());
+        // The chunk owns its first chunk_size bytes; the rest is overlap
+        // that the next chunk owns
+        Size owned = std::min(chunk.size, chunk_size);
+        Offset chunk_end = chunk.offset + owned;
+        Offset window_end = chunk.offset + chunk.size;
+        
+        std::vector<RecoveredFile> files;
+        std::vector<SignatureHits> hits;
+        if (chunk.error == 0 && config_.skip_uniform_blocks) {
+            // Carve only the parts that are not zeroed or wiped filler
+            Size carved = 0;
+            for (const auto& run : SimdUtils::findNonUniformRuns(chunk.data, chunk.size,
+                                                                 BLOCK_SIZE_4K, UNIFORM_SKIP_MIN_RUN)) {
+                auto run_files = carveChunk(chunk.data + run.first, run.second, chunk.offset + run.first, hits);
+                completeSpanningFiles(run_files, hits, run.second, chunk.offset + run.first,
+                                      chunk_end, window_end);
+                files.insert(files.end(), run_files.begin(), run_files.end());
+                if (run.first < owned) {
+                    carved += std::min(run.second, owned - run.first);
                 }
             }
+            uniform_bytes += owned - carved;
+        } else if (chunk.error == 0) {
+            files = carveChunk(chunk.data, chunk.size, chunk.offset, hits);
+            completeSpanningFiles(files, hits, chunk.size, chunk.offset, chunk_end, window_end);
+        } else {
+            LOG_WARNING("Failed to read chunk at offset " + std::to_string(chunk.offset) +
+                        ", leaving it for a resumed run");
+            failed_chunks_++;
+        }
+        pipeline.release(chunk);
+        
+        size_t index = std::lower_bound(ranges.begin(), ranges.end(), std::make_pair(chunk.offset, Size(0))) -
+                       ranges.begin();
+        candidates += files.size();
+        for (const auto& file : files) {
+            emitFile(file, index + 1);
+        }
+        // An unread chunk stays pending, so the checkpoint never records it
+        if (chunk.error == 0) {
+            finishUnitWork(index + 1);
+        }
+        
+        Offset watermark = device_size;
+        {
+            std::lock_guard<std::mutex> lock(watermark_mutex);
+            chunk_done[index] = true;
+            while (first_unfinished < num_chunks && chunk_done[first_unfinished]) {
+                first_unfinished++;
+            }
+            if (first_unfinished < num_chunks) {
+                watermark = ranges[first_unfinished].first;
+            }
+        }
+        pruneSeenFiles(watermark);
+        
+        // Update progress; skipped holes count as already processed
+        size_t completed = ++completed_chunks;
+        Size processed = processed_bytes += owned;
+        double progress = 35.0 + (45.0 * processed / device_size);
+        updateProgress(progress, "Scanning chunk " + std::to_string(completed) + "/" + std::to_string(num_chunks));
+        
+        if (tuner_ && tuner_->adjust(pipeline.getStats())) {
+            pipeline.setMaxBatch(tuner_->getIoDepth());
+        }
+    };
+    
+    // Submit through a pointer so each queued task stays allocation-free
+    ThreadPoolStats pool_before = thread_pool_->getStats();
+    size_t tasks_before = scan_tasks_->getExecutedCount();
+    // Each lane's tasks are queued on its node's workers
+    auto* carve_task = &carve_next_chunk;
+    if (tuner_) {
+        // Only as many tasks are queued as the tuner lets carve at once, and
+        // each finished task queues the next, so parked workers stay free
+        // for other work on the pool (other images in batch mode)
+        std::vector<size_t> unqueued;
+        for (const auto& lane : lanes) {
+            unqueued.push_back(lane.range_count);
+        }
+        std::mutex queue_mutex;
+        std::function<void(size_t)> queue_tasks = [&](size_t lane) {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            while (true) {
+                if (unqueued[lane] == 0) {
+                    auto other = std::find_if(unqueued.begin(), unqueued.end(), [](size_t n) { return n > 0; });
+                    if (other == unqueued.end()) {
+                        break;
+                    }
+                    lane = other - unqueued.begin();
+                }
+                if (!tuner_->tryBeginCarve()) {
+                    break;
+                }
+                unqueued[lane]--;
+                scan_tasks_->submit([this, carve_task, &queue_tasks, lane]() {
+                    (*carve_task)(lane);
+                    tuner_->endCarve();
+                    queue_tasks(lane);
+                }, lane_nodes[lane]);
+            }
+        };
+        queue_tasks(0);
+        scan_tasks_->wait();
+    } else {
+        for (size_t lane = 0; lane < lanes.size(); ++lane) {
+            for (size_t i = 0; i < lanes[lane].range_count; ++i) {
+                scan_tasks_->submit([carve_task, lane]() { (*carve_task)(lane); }, lane_nodes[lane]);
+            }
+        }
+        scan_tasks_->wait();
+    }
+    pipeline.join();
+    disk_scanner_->adviseMappedWindow(device_size, device_size);
+    
+    pipeline_stats_ = pipeline.getStats();
+    LOG_INFO(pipeline_stats_.describe());
+    
+    ThreadPoolStats pool_after = thread_pool_->getStats();
+    LOG_INFO("Carve tasks: " + std::to_string(scan_tasks_->getExecutedCount() - tasks_before) +
+             " run on " + std::to_string(num_threads) + (shared_scheduler_ ? " shared" : "") + " workers, " +
+             std::to_string(pool_after.tasks_stolen - pool_before.tasks_stolen) + " stolen");
+    if (tuner_) {
+        LOG_INFO("Auto-tune: " + std::to_string(tuner_->getAdjustmentCount()) + " adjustments, finished with " +
+                 std::to_string(tuner_->getActiveWorkers()) + " workers, I/O depth " +
+                 std::to_string(tuner_->getIoDepth()));
+    }
+    
+    uniform_bytes_skipped_ = uniform_bytes;
+    if (config_.skip_uniform_blocks) {
+        LOG_INFO("Skipped " + std::to_string(uniform_bytes_skipped_) + " bytes of uniform blocks (" +
+                 SimdUtils::getSimdLevelName(SimdUtils::getSimdLevel()) + " detector)");
+    }
+    
+    LOG_INFO("Signature recovery found " + std::to_string(candidates) + " potential files");
+    return candidates;
+}
+
+bool RecoveryEngine::buildScanPlan() {
+    std::vector<std::string> unknown_types;
+    scan_plan_ = CarverRegistry::instance().createPlan(config_.target_file_types, &unknown_types);
+    for (const auto& type : unknown_types) {
+        // A carver added to this engine may still handle it
+        bool added = std::any_of(file_carvers_.begin(), file_carvers_.end(), [&type](const auto& carver) {
+            return CarverRegistry::matchesTypes(*carver, {type});
+        });
+        if (!added) {
+            LOG_WARNING("No carver for file type: " + type);
+        }
+    }
+    for (const auto& carver : file_carvers_) {
+        if (CarverRegistry::matchesTypes(*carver, config_.target_file_types)) {
+            scan_plan_.addCarver("custom", *carver);
+        }
+    }
+    
+    LOG_INFO("Scan plan: " + scan_plan_.describe());
+    return !scan_plan_.empty();
+}
+
+Size RecoveryEngine::resolveHeaderAlignment() {
+    if (!config_.align_headers_to_clusters) {
+        return std::max<Size>(1, config_.header_alignment);
+    }
+    
+    FileSystemDetector detector;
+    std::vector<Byte> buffer(8192);
+    Size bytes_read = disk_scanner_->readCached(0, buffer.size(), buffer.data());
+    auto fs_info = detector.detect_from_data(buffer.data(), bytes_read);
+    if (!fs_info.is_valid || fs_info.cluster_size == 0) {
+        LOG_WARNING("No filesystem to take the cluster size from, searching headers at sector boundaries");
+        return SECTOR_SIZE;
+    }
+    
+    bool fat = fs_info.type == FileSystemType::FAT12 || fs_info.type == FileSystemType::FAT16 ||
+               fs_info.type == FileSystemType::FAT32 || fs_info.type == FileSystemType::EXFAT;
+    Size alignment = fat ? SECTOR_SIZE : fs_info.cluster_size;
+    LOG_INFO("Searching headers every " + std::to_string(alignment) + " bytes (" + fs_info.name +
+             ", " + std::to_string(fs_info.cluster_size) + " byte clusters)");
+    return alignment;
+}
+
+std::vector<RecoveredFile> RecoveryEngine::carveChunk(const Byte* data, Size size, Offset base_offset,
+                                                      std::vector<SignatureHits>& hits) {
+    std::vector<RecoveredFile> chunk_results;
+    
+    // One pass finds the headers and footers of every planned carver;
+    // aligned scans only look for headers at the offsets a filesystem
+    // would start a file at
+    if (header_alignment_ > 1) {
+        scan_plan_.findAlignedSignatures(data, size, base_offset, header_alignment_, hits);
+    } else {
+        scan_plan_.findSignatures(data, size, hits);
+    }
+    
+    if (size == 0) {
+        return chunk_results;
+    }
+    
+    const auto& stages = scan_plan_.getStages();
+    for (size_t i = 0; i < stages.size(); ++i) {
+        if (should_stop_) break;
+        
+        auto files = stages[i].carver->carveFilesAt(data, size, base_offset, hits[i]);
+        chunk_results.insert(chunk_results.end(), files.begin(), files.end());
+    }
+    
+    return chunk_results;
+}
+
+void RecoveryEngine::completeSpanningFiles(std::vector<RecoveredFile>& files,
+                                           const std::vector<SignatureHits>& hits, Size size,
+                                           Offset base_offset, Offset chunk_end, Offset window_end) {
+    files.erase(std::remove_if(files.begin(), files.end(),
+                               [chunk_end](const RecoveredFile& file) { return file.start_offset >= chunk_end; }),
+                files.end());
+    
+    // Data ending at uniform filler inside the window was not cut off by
+    // the read, and a window reaching the end of the device cut nothing off
+    if (base_offset + size < window_end || window_end >= disk_scanner_->getDeviceSize() ||
+        chunk_end <= base_offset) {
+        return;
+    }
+    Size owned = std::min<Size>(size, chunk_end - base_offset);
+    
+    const auto& stages = scan_plan_.getStages();
+    for (size_t i = 0; i < stages.size(); ++i) {
+        if (should_stop_) break;
+        if (stages[i].footers.empty()) {
+            continue;
+        }
+        
+        const auto& headers = hits[i].headers;
+        const auto& footer_ends = hits[i].footer_ends;
+        for (auto header = headers.begin(); header != headers.end() && *header < owned; ++header) {
+            RecoveredFile file;
+            file.start_offset = base_offset + *header;
+            if (file.start_offset % header_alignment_ != 0) {
+                continue;
+            }
             
-            // Update progress
-            size_t completed = ++completed_chunks;
-            double progress = 35.0 + (45.0 * completed / num_chunks);
-            updateProgress(progress, "Scanning chunk " + std::to_string(completed) + "/" + std::to_string(num_chunks));
+            // A footer before the carver's next header lets it end the file
+            // in the window; a later file of the same type inside the window
+            // does not, since it may be embedded in this one
+            Offset next_header = std::next(header) != headers.end() ? *std::next(header) : size;
+            auto footer = std::upper_bound(footer_ends.begin(), footer_ends.end(), *header);
+            if (footer != footer_ends.end() && *footer <= next_header) {
+                continue;
+            }
             
-            return chunk_results;
-        }));
+            if (extendSpanningFile(file, i, size - *header)) {
+                auto existing = std::find_if(files.begin(), files.end(), [&file](const RecoveredFile& other) {
+                    return other.start_offset == file.start_offset && other.file_type == file.file_type;
+                });
+                if (existing != files.end()) {
+                    *existing = file;
+                } else {
+                    files.push_back(file);
+                }
+            }
+        }
+    }
+}
+
+bool RecoveryEngine::extendSpanningFile(RecoveredFile& file, size_t stage, Size seen) {
+    FileCarver& carver = *scan_plan_.getStages()[stage].carver;
+    Size limit = std::min({carver.getMaxFileSize(), config_.max_span_extension,
+                           disk_scanner_->getDeviceSize() - file.start_offset});
+    
+    // Search only the bytes past what the carver has seen, backing up a
+    // little so a footer split across two reads is still found
+    Size span = 0;
+    std::vector<Byte> window(std::min(config_.chunk_size, limit));
+    std::vector<SignatureHits> hits;
+    while (seen < limit && span == 0 && !should_stop_) {
+        Size from = seen > FOOTER_SEARCH_BACK ? seen - FOOTER_SEARCH_BACK : 0;
+        Size length = std::min<Size>(window.size(), limit - from);
+        Size bytes_read = disk_scanner_->readChunk(file.start_offset + from, length, window.data());
+        span_bytes_read_ += bytes_read;
+        if (from + bytes_read <= seen) {
+            break;
+        }
         
-        // Limit number of concurrent tasks
-        if (futures.size() >= num_threads) {
-            // Wait for oldest task to complete
-            auto chunk_results = futures.front().get();
-            futures.erase(futures.begin());
-            
-            // Add results
-            recovered.insert(recovered.end(), chunk_results.begin(), chunk_results.end());
+        scan_plan_.findFooters(window.data(), bytes_read, hits);
+        const auto& footer_ends = hits[stage].footer_ends;
+        if (std::upper_bound(footer_ends.begin(), footer_ends.end(), seen - from) != footer_ends.end()) {
+            span = std::min(from + bytes_read + FOOTER_TAIL, limit);
         }
+        seen = from + bytes_read;
+        if (bytes_read < length) {
+            break;
+        }
+    }
+    if (span == 0) {
+        // No footer within reach: keep what the chunk carved
+        return false;
     }
+    window = std::vector<Byte>();
     
-    // Wait for remaining tasks
-    for (auto& future : futures) {
-        auto chunk_results = future.get();
-        recovered.insert(recovered.end(), chunk_results.begin(), chunk_results.end());
+    // One read from the header to just past the window holding the footer
+    std::lock_guard<std::mutex> lock(span_mutex_);
+    std::vector<Byte> buffer;
+    const Byte* data = disk_scanner_->getMappedView(file.start_offset, span);
+    if (!data) {
+        buffer.resize(span);
+        span = disk_scanner_->readChunk(file.start_offset, span, buffer.data());
+        span_bytes_read_ += span;
+        data = buffer.data();
     }
     
-    LOG_INFO("Signature recovery found " + std::to_string(recovered.size()) + " potential files");
-    return recovered;
+    auto carved = carver.carveFiles(data, span, file.start_offset);
+    auto it = std::find_if(carved.begin(), carved.end(), [&file](const RecoveredFile& candidate) {
+        return candidate.start_offset == file.start_offset;
+    });
+    if (it == carved.end() || it->file_size > span) {
+        return false;
+    }
+    
+    file = *it;
+    LOG_DEBUG("Carved " + file.filename + " across chunk boundary: " +
+              std::to_string(file.file_size) + " bytes");
+    return true;
 }
 
 bool RecoveryEngine::saveRecoveredFile(const RecoveredFile& file) {
     try {
         std::filesystem::path output_path = std::filesystem::path(config_.output_directory) / file.filename;
         
-        // Read file data from disk
-        std::vector<Byte> file_data(file.file_size);
-        Size bytes_read = disk_scanner_->readChunk(file.start_offset, file.file_size, file_data.data());
-        
-        if (bytes_read != file.file_size) {
-            LOG_WARNING("Could not read complete file: " + file.filename);
+        int output_fd = ::open(output_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (output_fd < 0) {
+            LOG_ERROR("Failed to create output file: " + output_path.string());
             return false;
         }
         
-        // Write to output file
-        std::ofstream output(output_path, std::ios::binary);
-        if (!output) {
-            LOG_ERROR("Failed to create output file: " + output_path.string());
+        // Kernel-side copy where possible, fixed-size buffer otherwise
+        Size copied = disk_scanner_->copyToFd(file.start_offset, file.file_size, output_fd);
+        bytes_extracted_ += copied;
+        bool closed = ::close(output_fd) == 0;
+        if (copied != file.file_size || !closed) {
+            LOG_WARNING("Could not copy complete file: " + file.filename);
+            std::filesystem::remove(output_path);
             return false;
         }
         
-        output.write(reinterpret_cast<const char*>(file_data.data()), file_data.size());
-        output.close();
-        
         if (config_.verbose_logging) {
             LOG_INFO("Saved: " + file.filename + " (" + std::to_string(file.file_size) + " bytes, confidence: " + 
                     std::to_string(file.confidence_score) + ")");
@@ -330,28 +837,136 @@ bool RecoveryEngine::saveRecoveredFile(const RecoveredFile& file) {
     }
 }
 
-void RecoveryEngine::deduplicateFiles() {
-    // Sort by start offset and remove duplicates with same offset/size
-    std::sort(recovered_files_.begin(), recovered_files_.end(), 
-              [](const RecoveredFile& a, const RecoveredFile& b) {
-                  if (a.start_offset != b.start_offset) {
-                      return a.start_offset < b.start_offset;
-                  }
-                  return a.file_size < b.file_size;
-              });
+bool RecoveryEngine::emitFile(const RecoveredFile& file, size_t unit) {
+    {
+        // Keys are (offset, size), matching what the old end-of-run pass removed
+        std::lock_guard<std::mutex> lock(results_mutex_);
+        if (!seen_files_.emplace(file.start_offset, file.file_size).second) {
+            return false;
+        }
+        if (config_.keep_recovered_files) {
+            recovered_files_.push_back(file);
+        }
+    }
+    recovered_count_++;
     
-    auto it = std::unique(recovered_files_.begin(), recovered_files_.end(),
-                         [](const RecoveredFile& a, const RecoveredFile& b) {
-                             return a.start_offset == b.start_offset && a.file_size == b.file_size;
-                         });
+    if (checkpoint_) {
+        std::lock_guard<std::mutex> lock(checkpoint_mutex_);
+        unit_pending_[unit]++;
+    }
     
-    size_t original_count = recovered_files_.size();
-    recovered_files_.erase(it, recovered_files_.end());
+    {
+        std::unique_lock<std::mutex> lock(extraction_mutex_);
+        extraction_cv_.wait(lock, [this]() { return pending_saves_ < MAX_PENDING_SAVES; });
+        pending_saves_++;
+    }
     
-    if (original_count != recovered_files_.size()) {
-        LOG_INFO("Removed " + std::to_string(original_count - recovered_files_.size()) + 
-                " duplicate files");
+    extraction_tasks_->submit([this, file, unit]() {
+        bool saved = !should_stop_ && saveRecoveredFile(file);
+        if (saved) {
+            saved_count_++;
+        }
+        for (const auto& sink : result_sinks_) {
+            sink->onFileRecovered(file, saved);
+        }
+        if (checkpoint_ && !should_stop_) {
+            checkpoint_->recordResult(file, saved, unit == METADATA_UNIT);
+        }
+        finishUnitWork(unit);
+        
+        {
+            std::lock_guard<std::mutex> lock(extraction_mutex_);
+            pending_saves_--;
+        }
+        extraction_cv_.notify_one();
+    });
+    return true;
+}
+
+bool RecoveryEngine::openCheckpoint() {
+    checkpoint_.reset();
+    {
+        std::lock_guard<std::mutex> lock(checkpoint_mutex_);
+        unit_pending_.assign(1, 1);
+        unit_ranges_.clear();
+        last_checkpoint_ = std::chrono::steady_clock::now();
     }
+    
+    const std::string& path = config_.checkpoint_path;
+    if (path.empty()) {
+        if (config_.resume) {
+            LOG_ERROR("Cannot resume: no checkpoint path configured");
+            return false;
+        }
+        return true;
+    }
+    
+    auto checkpoint = std::make_unique<ScanCheckpoint>(
+        path, ScanCheckpoint::hashConfig(config_, disk_scanner_->getDeviceSize(), header_alignment_),
+        config_.chunk_size);
+    
+    if (config_.resume && std::filesystem::exists(path)) {
+        if (!checkpoint->load()) {
+            LOG_ERROR("Cannot resume from checkpoint: " + path);
+            return false;
+        }
+        
+        // Metadata results inside chunks still to be scanned must keep
+        // deduplicating the carved copies of the same files
+        std::lock_guard<std::mutex> lock(results_mutex_);
+        checkpoint->forEachResult([&](const RecoveredFile& file, bool, bool from_metadata) {
+            if (config_.keep_recovered_files) {
+                recovered_files_.push_back(file);
+            }
+            if (from_metadata && !checkpoint->isCompleted(file.start_offset, 1)) {
+                seen_files_.emplace(file.start_offset, file.file_size);
+            }
+        });
+        recovered_count_ = checkpoint->getResultCount();
+        saved_count_ = checkpoint->getSavedCount();
+        LOG_INFO("Resuming from checkpoint " + path + ": " + std::to_string(checkpoint->getCompletedBytes()) +
+                 " bytes already scanned, " + std::to_string(recovered_count_) + " files already recovered");
+    } else {
+        if (config_.resume) {
+            LOG_WARNING("No checkpoint at " + path + ", starting a new scan");
+        }
+        if (!checkpoint->create()) {
+            LOG_WARNING("Continuing without checkpoints");
+            return true;
+        }
+    }
+    
+    checkpoint_ = std::move(checkpoint);
+    return true;
+}
+
+void RecoveryEngine::finishUnitWork(size_t unit) {
+    if (!checkpoint_) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(checkpoint_mutex_);
+    if (--unit_pending_[unit] > 0 || should_stop_) {
+        return;
+    }
+    
+    if (unit == METADATA_UNIT) {
+        checkpoint_->markMetadataDone();
+    } else {
+        checkpoint_->markCompleted(unit_ranges_[unit - 1].first, unit_ranges_[unit - 1].second);
+    }
+    
+    auto now = std::chrono::steady_clock::now();
+    if (config_.checkpoint_interval > 0 &&
+        now - last_checkpoint_ >= std::chrono::seconds(config_.checkpoint_interval)) {
+        checkpoint_->save();
+        last_checkpoint_ = now;
+    }
+}
+
+void RecoveryEngine::pruneSeenFiles(Offset watermark) {
+    std::lock_guard<std::mutex> lock(results_mutex_);
+    seen_files_.erase(seen_files_.begin(), seen_files_.lower_bound(std::make_pair(watermark, Size(0))));
 }
 
 void RecoveryEngine::updateProgress(double progress, const std::string& status_message) {
@@ -366,6 +981,61 @@ void RecoveryEngine::updateProgress(double progress, const std::string& status_m
     }
 }
 
+std::vector<WorkerPlacement> RecoveryEngine::planNumaWorkers() {
+    std::vector<NumaNode> nodes = CpuTopology::detectNodes();
+    std::vector<WorkerPlacement> placement;
+    node_workers_.clear();
+    
+    std::string layout;
+    for (size_t n = 0; n < nodes.size(); ++n) {
+        size_t workers = nodes[n].cpus.size();
+        if (config_.threads_per_node > 0) {
+            workers = config_.threads_per_node;
+        } else if (config_.num_threads > 0) {
+            workers = config_.num_threads / nodes.size() + (n < config_.num_threads % nodes.size() ? 1 : 0);
+        }
+        if (workers == 0) {
+            continue;
+        }
+        
+        // More workers than cores share the node's cores round-robin
+        for (size_t i = 0; i < workers; ++i) {
+            WorkerPlacement worker;
+            worker.node = nodes[n].id;
+            worker.cpus.push_back(nodes[n].cpus[i % nodes[n].cpus.size()]);
+            placement.push_back(worker);
+        }
+        node_workers_.emplace_back(nodes[n].id, workers);
+        layout += (layout.empty() ? "" : ", ") + std::string("node ") + std::to_string(nodes[n].id) + ": " +
+                  std::to_string(workers) + " workers on " + std::to_string(nodes[n].cpus.size()) + " cores";
+    }
+    
+    LOG_INFO("NUMA-aware scan workers: " + layout);
+    return placement;
+}
+
+void RecoveryEngine::tuneScan(size_t max_workers) {
+    tuner_ = std::make_unique<ScanTuner>(*disk_scanner_, max_workers);
+    
+    Size fixed_chunk_size = 0;
+    if (config_.resume && !config_.checkpoint_path.empty()) {
+        fixed_chunk_size = ScanCheckpoint::readChunkSize(config_.checkpoint_path);
+    }
+    
+    TuningResult tuning = tuner_->calibrate(
+        [this](const Byte* data, Size size, Offset offset) {
+            std::vector<SignatureHits> hits;
+            carveChunk(data, size, offset, hits);
+        },
+        fixed_chunk_size);
+    LOG_INFO("Auto-tune calibration: " + tuning.describe());
+    
+    config_.chunk_size = tuning.chunk_size;
+    config_.io_queue_depth = tuning.io_depth;
+    disk_scanner_->setIoQueueDepth(tuning.io_depth);
+    tuned_workers_ = tuning.workers;
+}
+
 size_t RecoveryEngine::getOptimalThreadCount() const {
     size_t hardware_threads = std::thread::hardware_concurrency();
     if (hardware_threads == 0) {
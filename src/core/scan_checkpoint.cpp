@@ -0,0 +1,436 @@
+#include "core/scan_checkpoint.h"
+#include "utils/logger.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace FileRecovery {
+
+namespace {
+
+// FNV-1a 64-bit parameters
+constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+// Journal line: "<m|s> offset size saved confidence type filename"
+bool parseRecord(const std::string& line, RecoveredFile& file, bool& saved, bool& from_metadata) {
+    std::istringstream fields(line);
+    std::string source;
+    int saved_flag = 0;
+    if (!(fields >> source >> file.start_offset >> file.file_size >> saved_flag >>
+          file.confidence_score >> file.file_type)) {
+        return false;
+    }
+    if (source != "m" && source != "s") {
+        return false;
+    }
+    std::getline(fields >> std::ws, file.filename);
+    if (file.file_type == "-") {
+        file.file_type.clear();
+    }
+    saved = saved_flag != 0;
+    from_metadata = source == "m";
+    return true;
+}
+
+bool writeAll(int fd, const std::string& data) {
+    size_t done = 0;
+    while (done < data.size()) {
+        ssize_t n = ::write(fd, data.data() + done, data.size() - done);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+ScanCheckpoint::ScanCheckpoint(const std::string& path, uint64_t config_hash, Size chunk_size)
+    : path_(path)
+    , journal_path_(path + ".results")
+    , config_hash_(config_hash)
+    , chunk_size_(chunk_size)
+    , metadata_done_(false)
+    , journal_fd_(-1)
+    , journal_bytes_(0)
+    , result_count_(0)
+    , saved_count_(0) {
+}
+
+ScanCheckpoint::~ScanCheckpoint() {
+    if (journal_fd_ >= 0) {
+        ::close(journal_fd_);
+    }
+}
+
+uint64_t ScanCheckpoint::hashConfig(const ScanConfig& config, Size device_size, Size header_alignment) {
+    // Everything that changes the chunk layout or what a chunk yields. The
+    // resolved alignment is used, so --align auto matches an explicit
+    // --align of the same cluster size.
+    std::ostringstream key;
+    key << config.device_path << '|' << device_size << '|' << config.chunk_size << '|'
+        << config.chunk_overlap << '|' << config.use_metadata_recovery << '|'
+        << config.use_signature_recovery << '|' << config.skip_uniform_blocks << '|'
+        << header_alignment << '|' << config.max_span_extension;
+    for (const auto& type : config.target_file_types) {
+        key << '|' << type;
+    }
+
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (unsigned char c : key.str()) {
+        hash = (hash ^ c) * FNV_PRIME;
+    }
+    return hash;
+}
+
+Size ScanCheckpoint::readChunkSize(const std::string& path) {
+    std::ifstream input(path);
+    std::string line;
+    while (std::getline(input, line) && !line.empty() && line[0] == '#') {
+        std::istringstream fields(line);
+        std::string hash, key;
+        Size chunk_size = 0;
+        fields >> hash >> key;
+        if (key == "chunk_size" && fields >> chunk_size) {
+            return chunk_size;
+        }
+    }
+    return 0;
+}
+
+bool ScanCheckpoint::create() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    completed_.clear();
+    metadata_done_ = false;
+    result_count_ = 0;
+    saved_count_ = 0;
+    journal_bytes_ = 0;
+    return openJournal(true) && writeCheckpointFile();
+}
+
+bool ScanCheckpoint::load() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ifstream input(path_);
+    if (!input) {
+        LOG_ERROR("Failed to open checkpoint: " + path_);
+        return false;
+    }
+
+    std::map<Offset, Offset> loaded;
+    bool hash_checked = false;
+    bool metadata_done = false;
+    Size journal_bytes = 0;
+    std::string line;
+    while (std::getline(input, line)) {
+        if (line.empty()) {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        if (line[0] == '#') {
+            std::string hash, key;
+            fields >> hash >> key;
+            if (key == "config_hash") {
+                uint64_t recorded = 0;
+                if (!(fields >> std::hex >> recorded) || recorded != config_hash_) {
+                    LOG_ERROR("Checkpoint " + path_ + " was written with different scan settings");
+                    return false;
+                }
+                hash_checked = true;
+            } else if (key == "journal_bytes") {
+                fields >> journal_bytes;
+            } else if (key == "metadata_done") {
+                int done = 0;
+                fields >> done;
+                metadata_done = done != 0;
+            }
+            continue;
+        }
+
+        Offset offset = 0;
+        Size size = 0;
+        if (!(fields >> offset >> size) || size == 0) {
+            LOG_WARNING("Skipping malformed checkpoint entry: " + line);
+            continue;
+        }
+        loaded[offset] = offset + size;
+    }
+
+    if (!hash_checked) {
+        LOG_ERROR("Checkpoint " + path_ + " has no config_hash header");
+        return false;
+    }
+
+    completed_.clear();
+    for (const auto& range : loaded) {
+        // Ranges were written merged; a hand-edited file may still overlap
+        if (!completed_.empty() && std::prev(completed_.end())->second >= range.first) {
+            auto last = std::prev(completed_.end());
+            last->second = std::max(last->second, range.second);
+        } else {
+            completed_.insert(range);
+        }
+    }
+    metadata_done_ = metadata_done;
+    journal_bytes_ = journal_bytes;
+
+    // Results past the committed length or from unfinished work are
+    // produced again by the resumed scan
+    if (!compactJournal() || !openJournal(false)) {
+        return false;
+    }
+    return writeCheckpointFile();
+}
+
+bool ScanCheckpoint::save() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The checkpoint must never refer to journal bytes that are not on disk
+    if (journal_fd_ >= 0 && fdatasync(journal_fd_) != 0) {
+        LOG_WARNING("Failed to sync checkpoint journal: " + std::string(strerror(errno)));
+    }
+    return writeCheckpointFile();
+}
+
+void ScanCheckpoint::remove() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (journal_fd_ >= 0) {
+        ::close(journal_fd_);
+        journal_fd_ = -1;
+    }
+    std::remove(path_.c_str());
+    std::remove(journal_path_.c_str());
+}
+
+void ScanCheckpoint::markCompleted(Offset offset, Size size) {
+    if (size == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Offset start = offset;
+    Offset end = offset + size;
+
+    // Absorb the range that starts at or before us if it touches us
+    auto it = completed_.upper_bound(start);
+    if (it != completed_.begin()) {
+        auto prev = std::prev(it);
+        if (prev->second >= start) {
+            if (prev->second >= end) {
+                return;  // Already covered
+            }
+            start = prev->first;
+            it = prev;
+        }
+    }
+
+    // Absorb every range that starts inside or right after us
+    while (it != completed_.end() && it->first <= end) {
+        end = std::max(end, it->second);
+        it = completed_.erase(it);
+    }
+
+    completed_[start] = end;
+}
+
+bool ScanCheckpoint::isCompleted(Offset offset, Size size) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = completed_.upper_bound(offset);
+    if (it == completed_.begin()) {
+        return false;
+    }
+    --it;
+    return it->second >= offset + std::max<Size>(size, 1);
+}
+
+Size ScanCheckpoint::getCompletedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Size total = 0;
+    for (const auto& range : completed_) {
+        total += range.second - range.first;
+    }
+    return total;
+}
+
+void ScanCheckpoint::markMetadataDone() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    metadata_done_ = true;
+}
+
+bool ScanCheckpoint::isMetadataDone() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return metadata_done_;
+}
+
+bool ScanCheckpoint::recordResult(const RecoveredFile& file, bool saved, bool from_metadata) {
+    std::ostringstream line;
+    line << (from_metadata ? 'm' : 's') << ' ' << file.start_offset << ' ' << file.file_size << ' '
+         << (saved ? 1 : 0) << ' ' << file.confidence_score << ' '
+         << (file.file_type.empty() ? std::string("-") : file.file_type) << ' ' << file.filename << '\n';
+    std::string record = line.str();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (journal_fd_ < 0 || !writeAll(journal_fd_, record)) {
+        LOG_WARNING("Failed to append to checkpoint journal: " + journal_path_);
+        return false;
+    }
+    journal_bytes_ += record.size();
+    result_count_++;
+    if (saved) {
+        saved_count_++;
+    }
+    return true;
+}
+
+bool ScanCheckpoint::forEachResult(const std::function<void(const RecoveredFile&, bool, bool)>& callback) const {
+    Size limit;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        limit = journal_bytes_;
+    }
+
+    std::ifstream input(journal_path_);
+    if (!input) {
+        return limit == 0;
+    }
+
+    Size consumed = 0;
+    std::string line;
+    while (consumed < limit && std::getline(input, line)) {
+        consumed += line.size() + 1;
+        RecoveredFile file;
+        bool saved = false;
+        bool from_metadata = false;
+        if (parseRecord(line, file, saved, from_metadata)) {
+            callback(file, saved, from_metadata);
+        }
+    }
+    return true;
+}
+
+size_t ScanCheckpoint::getResultCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return result_count_;
+}
+
+size_t ScanCheckpoint::getSavedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return saved_count_;
+}
+
+bool ScanCheckpoint::openJournal(bool truncate) {
+    if (journal_fd_ >= 0) {
+        ::close(journal_fd_);
+    }
+    int flags = O_WRONLY | O_CREAT | O_APPEND | (truncate ? O_TRUNC : 0);
+    journal_fd_ = ::open(journal_path_.c_str(), flags, 0644);
+    if (journal_fd_ < 0) {
+        LOG_ERROR("Failed to open checkpoint journal: " + journal_path_ + " - " + std::string(strerror(errno)));
+        return false;
+    }
+    return true;
+}
+
+bool ScanCheckpoint::compactJournal() {
+    std::string temp_path = journal_path_ + ".tmp";
+    Size kept_bytes = 0;
+    result_count_ = 0;
+    saved_count_ = 0;
+
+    {
+        std::ifstream input(journal_path_);
+        std::ofstream output(temp_path, std::ios::trunc);
+        if (!output) {
+            LOG_ERROR("Failed to write checkpoint journal: " + temp_path);
+            return false;
+        }
+
+        Size consumed = 0;
+        std::string line;
+        while (input && consumed < journal_bytes_ && std::getline(input, line)) {
+            consumed += line.size() + 1;
+            RecoveredFile file;
+            bool saved = false;
+            bool from_metadata = false;
+            if (!parseRecord(line, file, saved, from_metadata)) {
+                continue;
+            }
+
+            bool keep;
+            if (from_metadata) {
+                keep = metadata_done_;
+            } else {
+                // A carved file belongs to the chunk its header lies in
+                auto it = completed_.upper_bound(file.start_offset);
+                keep = it != completed_.begin() && std::prev(it)->second > file.start_offset;
+            }
+            if (!keep) {
+                continue;
+            }
+
+            output << line << '\n';
+            kept_bytes += line.size() + 1;
+            result_count_++;
+            if (saved) {
+                saved_count_++;
+            }
+        }
+
+        if (!output.flush()) {
+            LOG_ERROR("Failed to write checkpoint journal: " + temp_path);
+            return false;
+        }
+    }
+
+    if (std::rename(temp_path.c_str(), journal_path_.c_str()) != 0) {
+        LOG_ERROR("Failed to replace checkpoint journal: " + journal_path_);
+        std::remove(temp_path.c_str());
+        return false;
+    }
+    journal_bytes_ = kept_bytes;
+    return true;
+}
+
+bool ScanCheckpoint::writeCheckpointFile() {
+    std::string temp_path = path_ + ".tmp";
+
+    {
+        std::ofstream output(temp_path, std::ios::trunc);
+        if (!output) {
+            LOG_ERROR("Failed to write checkpoint: " + temp_path);
+            return false;
+        }
+        output << "# filerec scan checkpoint: completed offset length\n";
+        output << "# config_hash " << std::hex << config_hash_ << std::dec << "\n";
+        output << "# journal_bytes " << journal_bytes_ << "\n";
+        output << "# metadata_done " << (metadata_done_ ? 1 : 0) << "\n";
+        if (chunk_size_ > 0) {
+            output << "# chunk_size " << chunk_size_ << "\n";
+        }
+        for (const auto& range : completed_) {
+            output << range.first << " " << (range.second - range.first) << "\n";
+        }
+        if (!output.flush()) {
+            LOG_ERROR("Failed to write checkpoint: " + temp_path);
+            return false;
+        }
+    }
+
+    if (std::rename(temp_path.c_str(), path_.c_str()) != 0) {
+        LOG_ERROR("Failed to replace checkpoint: " + path_);
+        std::remove(temp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace FileRecovery
@@ -0,0 +1,41 @@
+#include "core/scan_scheduler.h"
+#include <algorithm>
+
+namespace FileRecovery {
+
+IoScheduler::IoScheduler(size_t slots)
+    : slots_(std::max<size_t>(1, slots))
+    , next_ticket_(0)
+    , now_serving_(0)
+    , in_use_(0) {
+}
+
+void IoScheduler::acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t ticket = next_ticket_++;
+    cv_.wait(lock, [this, ticket]() { return ticket == now_serving_ && in_use_ < slots_; });
+    now_serving_++;
+    in_use_++;
+    // The next ticket may fit into a slot that is still free
+    cv_.notify_all();
+}
+
+void IoScheduler::release() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        in_use_--;
+    }
+    cv_.notify_all();
+}
+
+SharedScheduler SharedScheduler::create(size_t scan_threads, size_t extraction_threads, size_t io_slots) {
+    SharedScheduler shared;
+    shared.scan_pool = std::make_shared<ThreadPool>(scan_threads);
+    shared.scan_queue = std::make_shared<FairTaskQueue>(*shared.scan_pool);
+    shared.extraction_pool = std::make_shared<ThreadPool>(extraction_threads);
+    shared.extraction_queue = std::make_shared<FairTaskQueue>(*shared.extraction_pool);
+    shared.io = std::make_shared<IoScheduler>(io_slots);
+    return shared;
+}
+
+} // namespace FileRecovery
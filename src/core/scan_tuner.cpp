@@ -0,0 +1,224 @@
+#include "core/scan_tuner.h"
+#include "core/disk_scanner.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+namespace FileRecovery {
+
+// Chunk sizes tried by calibration, smallest first
+constexpr Size CANDIDATE_CHUNK_SIZES[] = {256 * 1024, 1024 * 1024, 4 * 1024 * 1024, 16 * 1024 * 1024};
+
+// Regions read per candidate chunk size
+constexpr size_t CALIBRATION_SAMPLES = 3;
+
+// Largest share of the device calibration may read
+constexpr Size CALIBRATION_DEVICE_FRACTION = 8;
+
+// A smaller chunk wins if it reaches this share of the best throughput;
+// smaller chunks balance better over the workers
+constexpr double CHUNK_SIZE_TOLERANCE = 0.9;
+
+// Extra carvers beyond what the measured rates call for
+constexpr double WORKER_HEADROOM = 1.25;
+
+// Largest number of reads the pipeline is allowed to batch
+constexpr unsigned MAX_IO_DEPTH = 64;
+
+// Minimum time between two in-run adjustments
+constexpr std::chrono::milliseconds ADJUST_INTERVAL(1000);
+
+// Stall fraction above which a stage counts as the bottleneck
+constexpr double STALL_THRESHOLD = 0.5;
+
+std::string TuningResult::describe() const {
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(1);
+    if (calibrated) {
+        ss << "read " << read_mbps << " MB/s, carve " << std::setprecision(2) << carve_ns_per_byte
+           << " ns/byte";
+    } else {
+        ss << "device too small to sample";
+    }
+    ss << " -> chunk size " << chunk_size << ", I/O depth " << io_depth << ", " << workers << " workers";
+    return ss.str();
+}
+
+ScanTuner::ScanTuner(DiskScanner& scanner, size_t max_workers)
+    : scanner_(scanner)
+    , max_workers_(std::max<size_t>(1, max_workers))
+    , active_workers_(max_workers_)
+    , carving_(0)
+    , io_depth_(1)
+    , adjustments_(0)
+    , last_adjust_(std::chrono::steady_clock::now()) {
+}
+
+TuningResult ScanTuner::calibrate(const CarveFunction& carve, Size fixed_chunk_size) {
+    TuningResult result;
+    Size device_size = scanner_.getDeviceSize();
+    Size budget = device_size / CALIBRATION_DEVICE_FRACTION;
+
+    std::vector<Size> candidates;
+    if (fixed_chunk_size > 0) {
+        candidates.push_back(fixed_chunk_size);
+    } else {
+        // Drop the largest sizes until the samples fit the budget
+        Size sampled = 0;
+        for (Size size : CANDIDATE_CHUNK_SIZES) {
+            if (sampled + size * CALIBRATION_SAMPLES > budget) {
+                break;
+            }
+            sampled += size * CALIBRATION_SAMPLES;
+            candidates.push_back(size);
+        }
+    }
+    if (fixed_chunk_size > 0) {
+        result.chunk_size = fixed_chunk_size;
+    }
+    if (candidates.empty() || candidates.front() * (CALIBRATION_SAMPLES + 1) > device_size) {
+        result.workers = max_workers_;
+        result.io_depth = static_cast<unsigned>(std::min<size_t>(max_workers_ + 1, MAX_IO_DEPTH));
+        return result;
+    }
+
+    // Every sample gets its own region so no read is served from the page
+    // cache filled by an earlier one
+    size_t regions = candidates.size() * CALIBRATION_SAMPLES;
+    std::vector<Byte> buffer(candidates.back());
+    std::vector<double> throughput;
+    for (size_t c = 0; c < candidates.size(); ++c) {
+        Size size = candidates[c];
+        double bytes = 0.0;
+        double seconds = 0.0;
+        for (size_t s = 0; s < CALIBRATION_SAMPLES; ++s) {
+            size_t region = c * CALIBRATION_SAMPLES + s;
+            Offset offset = (device_size - size) / (regions + 1) * (region + 1);
+            offset &= ~static_cast<Offset>(BLOCK_SIZE_4K - 1);
+            auto start = std::chrono::steady_clock::now();
+            Size got = scanner_.readChunk(offset, size, buffer.data());
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            bytes += got;
+        }
+        throughput.push_back(seconds > 0.0 ? bytes / seconds : 0.0);
+    }
+
+    double best = *std::max_element(throughput.begin(), throughput.end());
+    size_t chosen = 0;
+    while (chosen + 1 < candidates.size() && throughput[chosen] < best * CHUNK_SIZE_TOLERANCE) {
+        chosen++;
+    }
+    result.chunk_size = candidates[chosen];
+    result.read_mbps = throughput[chosen] / (1024.0 * 1024.0);
+
+    // Time the carvers on a sampled region of the chosen size
+    Offset carve_offset = ((device_size - result.chunk_size) / 2) & ~static_cast<Offset>(BLOCK_SIZE_4K - 1);
+    Size carve_size = scanner_.readChunk(carve_offset, result.chunk_size, buffer.data());
+    if (carve_size > 0) {
+        auto start = std::chrono::steady_clock::now();
+        carve(buffer.data(), carve_size, carve_offset);
+        double nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        result.carve_ns_per_byte = nanoseconds / carve_size;
+    }
+
+    // Carvers needed to consume what the device delivers
+    double needed = throughput[chosen] * result.carve_ns_per_byte / 1e9 * WORKER_HEADROOM;
+    result.workers = std::min(max_workers_, std::max<size_t>(1, static_cast<size_t>(std::ceil(needed))));
+
+    // One read in flight per worker plus one; a device that only reached
+    // its best rate with the largest chunks is latency-bound and gets
+    // twice that to hide the latency
+    unsigned depth = static_cast<unsigned>(result.workers + 1);
+    if (fixed_chunk_size == 0 && chosen + 1 == candidates.size() && candidates.size() > 1) {
+        depth *= 2;
+    }
+    result.io_depth = std::min(depth, MAX_IO_DEPTH);
+    result.calibrated = true;
+    return result;
+}
+
+void ScanTuner::startRun(size_t workers, unsigned io_depth) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    active_workers_ = std::min(max_workers_, std::max<size_t>(1, workers));
+    io_depth_ = std::max(1u, io_depth);
+    carving_ = 0;
+    adjustments_ = 0;
+    last_stats_ = PipelineStats();
+    last_adjust_ = std::chrono::steady_clock::now();
+}
+
+bool ScanTuner::adjust(const PipelineStats& stats) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_adjust_ < ADJUST_INTERVAL) {
+        return false;
+    }
+
+    double window = std::chrono::duration<double, std::nano>(now - last_adjust_).count();
+    double reader = (stats.reader_stall - last_stats_.reader_stall).count() / window;
+    double consumer = (stats.consumer_stall - last_stats_.consumer_stall).count() / (window * active_workers_);
+    double mbps = (stats.bytes_read - last_stats_.bytes_read) / (1024.0 * 1024.0) / (window / 1e9);
+    last_stats_ = stats;
+    last_adjust_ = now;
+
+    bool changed = false;
+    if (reader > STALL_THRESHOLD && active_workers_ < max_workers_) {
+        // Reads are waiting for carvers
+        active_workers_++;
+        changed = true;
+    } else if (consumer > STALL_THRESHOLD) {
+        // Carvers are waiting for reads
+        if (active_workers_ > 1) {
+            active_workers_--;
+            changed = true;
+        }
+        if (io_depth_ < MAX_IO_DEPTH) {
+            io_depth_ = std::min(io_depth_ * 2, MAX_IO_DEPTH);
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        adjustments_++;
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(1) << "Auto-tune: " << mbps << " MB/s, reader blocked "
+           << reader * 100.0 << "%, carvers starved " << consumer * 100.0 << "% -> " << active_workers_
+           << " workers, I/O depth " << io_depth_;
+        LOG_INFO(ss.str());
+    }
+    return changed;
+}
+
+bool ScanTuner::tryBeginCarve() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (carving_ >= active_workers_) {
+        return false;
+    }
+    carving_++;
+    return true;
+}
+
+void ScanTuner::endCarve() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    carving_--;
+}
+
+size_t ScanTuner::getActiveWorkers() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return active_workers_;
+}
+
+unsigned ScanTuner::getIoDepth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return io_depth_;
+}
+
+size_t ScanTuner::getAdjustmentCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return adjustments_;
+}
+
+} // namespace FileRecovery
@@ -0,0 +1,127 @@
+#include "core/segmented_image.h"
+#include "core/io_backend.h"
+#include "utils/logger.h"
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+namespace FileRecovery {
+
+SegmentedImage::~SegmentedImage() {
+    closeAll();
+}
+
+std::vector<std::string> SegmentedImage::findSegments(const std::string& first_path) {
+    std::vector<std::string> paths;
+
+    size_t dot = first_path.find_last_of('.');
+    if (dot == std::string::npos || dot + 1 >= first_path.size() ||
+        first_path.find('/', dot) != std::string::npos) {
+        return paths;
+    }
+
+    std::string digits = first_path.substr(dot + 1);
+    if (!std::all_of(digits.begin(), digits.end(), [](unsigned char c) { return std::isdigit(c); })) {
+        return paths;
+    }
+
+    std::string base = first_path.substr(0, dot + 1);
+    unsigned long number = std::stoul(digits);
+    struct stat st;
+    while (true) {
+        std::ostringstream name;
+        name << base << std::setw(digits.size()) << std::setfill('0') << number;
+        if (stat(name.str().c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+            break;
+        }
+        paths.push_back(name.str());
+        number++;
+    }
+
+    return paths;
+}
+
+bool SegmentedImage::open(const std::vector<std::string>& paths) {
+    closeAll();
+
+    for (const auto& path : paths) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_LARGEFILE);
+        if (fd < 0) {
+            LOG_ERROR("Failed to open image segment: " + path + " - " + std::string(strerror(errno)));
+            closeAll();
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            LOG_ERROR("Failed to stat image segment: " + path);
+            ::close(fd);
+            closeAll();
+            return false;
+        }
+
+        segments_.push_back(Segment{path, fd, total_size_, static_cast<Size>(st.st_size)});
+        total_size_ += static_cast<Size>(st.st_size);
+    }
+
+    return !segments_.empty();
+}
+
+std::vector<SegmentedImage::Piece> SegmentedImage::split(Offset offset, Size size) const {
+    std::vector<Piece> pieces;
+    if (offset >= total_size_) {
+        return pieces;
+    }
+    size = std::min(size, total_size_ - offset);
+
+    // First segment whose range contains offset
+    auto it = std::upper_bound(segments_.begin(), segments_.end(), offset,
+                               [](Offset value, const Segment& segment) { return value < segment.start; });
+    --it;
+
+    Size done = 0;
+    for (; it != segments_.end() && done < size; ++it) {
+        if (it->size == 0) {
+            continue;
+        }
+        Offset pos = offset + done;
+        Size length = std::min<Size>(it->start + it->size - pos, size - done);
+        pieces.push_back(Piece{it->fd, pos - it->start, length, done});
+        done += length;
+    }
+
+    return pieces;
+}
+
+Size SegmentedImage::read(Offset offset, Size size, Byte* buffer, int* error) const {
+    if (error) {
+        *error = 0;
+    }
+
+    Size total = 0;
+    for (const auto& piece : split(offset, size)) {
+        Size got = preadFully(piece.fd, piece.file_offset, piece.size, buffer + piece.buffer_offset, error);
+        total += got;
+        if (got < piece.size) {
+            break;
+        }
+    }
+    return total;
+}
+
+void SegmentedImage::closeAll() {
+    for (auto& segment : segments_) {
+        if (segment.fd >= 0) {
+            ::close(segment.fd);
+        }
+    }
+    segments_.clear();
+    total_size_ = 0;
+}
+
+} // namespace FileRecovery
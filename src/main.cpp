@@ -5,15 +5,49 @@
 #include <getopt.h>
 #include <signal.h>
 #include <atomic>
+#include <algorithm>
+#include <filesystem>
+#include <thread>
+#include <chrono>
 
 #include "core/recovery_engine.h"
+#include "core/batch_recovery.h"
 #include "utils/logger.h"
+#include "utils/file_utils.h"
 #include "utils/types.h"
 
 using namespace FileRecovery;
 
+// Long-only option identifiers (outside the range of short option characters)
+enum LongOption {
+    OPT_IO_BACKEND = 256,
+    OPT_IO_DEPTH,
+    OPT_DIRECT_IO,
+    OPT_MMAP,
+    OPT_READ_AHEAD,
+    OPT_CACHE_SIZE,
+    OPT_CACHE_BLOCK,
+    OPT_NO_SKIP_UNIFORM,
+    OPT_DEGRADED,
+    OPT_BAD_BLOCK_MAP,
+    OPT_CHUNK_OVERLAP,
+    OPT_MAX_SPAN,
+    OPT_EXTRACT_THREADS,
+    OPT_RESUME,
+    OPT_CHECKPOINT_INTERVAL,
+    OPT_NUMA,
+    OPT_THREADS_PER_NODE,
+    OPT_AUTO_TUNE,
+    OPT_BATCH,
+    OPT_BATCH_JOBS,
+    OPT_ALIGN
+};
+
 // Global flag for signal handling
 std::atomic<bool> g_interrupt_received(false);
+
+// How often batch mode checks the flag
+constexpr int INTERRUPT_POLL_MS = 100;
 RecoveryEngine* g_recovery_engine = nullptr;
 
 void signalHandler(int signal) {
@@ -23,29 +57,55 @@ void signalHandler(int signal) {
         if (g_recovery_engine) {
             g_recovery_engine->stopRecovery();
         }
+        // Batch mode stops from its watcher thread: BatchRecovery::stop()
+        // takes a lock, which a signal handler must not
     }
 }
 
 void printUsage(const char* program_name) {
     std::cout << "Advanced File Recovery Tool v1.0.0\n\n";
-    std::cout << "Usage: " << program_name << " [OPTIONS] DEVICE OUTPUT_DIR\n\n";
+    std::cout << "Usage: " << program_name << " [OPTIONS] DEVICE OUTPUT_DIR\n";
+    std::cout << "       " << program_name << " [OPTIONS] --batch MANIFEST\n\n";
     std::cout << "Arguments:\n";
     std::cout << "  DEVICE      Device or image file to scan (e.g., /dev/sda1, disk.img)\n";
-    std::cout << "  OUTPUT_DIR  Directory to save recovered files\n\n";
+    std::cout << "  OUTPUT_DIR  Directory to save recovered files\n";
+    std::cout << "  MANIFEST    File with one \"DEVICE OUTPUT_DIR\" pair per line (tab-separated if paths have spaces)\n\n";
     std::cout << "Options:\n";
     std::cout << "  -h, --help              Show this help message\n";
     std::cout << "  -v, --verbose           Enable verbose logging\n";
     std::cout << "  -t, --threads NUM       Number of threads to use (default: auto)\n";
+    std::cout << "  --extract-threads NUM   Threads writing recovered files during the scan (default: auto)\n";
+    std::cout << "  --numa                  Pin scan workers to cores and keep each NUMA node's chunks in its memory\n";
+    std::cout << "  --threads-per-node NUM  Scan workers per NUMA node with --numa (default: one per core)\n";
     std::cout << "  -c, --chunk-size SIZE   Chunk size in MB (default: 1)\n";
+    std::cout << "  --auto-tune             Measure the device and pick chunk size, I/O depth and workers\n";
+    std::cout << "  --chunk-overlap KB      Bytes read past each chunk for files crossing its end (default: 64)\n";
+    std::cout << "  --max-span MB           Furthest a file is followed past its chunk, 0 = not at all (default: 64)\n";
     std::cout << "  -f, --file-types TYPES  Comma-separated list of file types (default: all)\n";
     std::cout << "  -m, --metadata-only     Use only metadata-based recovery\n";
     std::cout << "  -s, --signature-only    Use only signature-based recovery\n";
     std::cout << "  -l, --log-file FILE     Log file path (default: recovery.log)\n";
-    std::cout << "  --read-only             Verify device is mounted read-only (safety check)\n\n";
+    std::cout << "  --read-only             Verify device is mounted read-only (safety check)\n";
+    std::cout << "  --io-backend TYPE       Read backend: sync or io_uring (default: sync)\n";
+    std::cout << "  --io-depth NUM          Reads kept in flight by the backend (default: 32)\n";
+    std::cout << "  --direct-io             Bypass the page cache with O_DIRECT reads\n";
+    std::cout << "  --mmap                  Scan image files through one zero-copy memory mapping\n";
+    std::cout << "  --read-ahead NUM        Chunks read ahead of the carvers (default: 4)\n";
+    std::cout << "  --cache-size MB         Block cache for metadata and extraction reads, 0 disables (default: 64)\n";
+    std::cout << "  --cache-block KB        Block cache block size (default: 64)\n";
+    std::cout << "  --no-skip-uniform       Carve zeroed/wiped regions instead of skipping them\n";
+    std::cout << "  --align BYTES|auto      Search headers only at multiples of BYTES, or of the cluster size\n";
+    std::cout << "  --degraded              Tolerate bad sectors: retry per sector, zero-fill failures\n";
+    std::cout << "  --bad-block-map FILE    Load/save unreadable ranges across runs (implies --degraded)\n";
+    std::cout << "  --resume                Continue an interrupted scan from OUTPUT_DIR/.filerec.checkpoint\n";
+    std::cout << "  --checkpoint-interval SEC  Seconds between checkpoint writes, 0 = only on exit (default: 30)\n";
+    std::cout << "  --batch MANIFEST        Scan every image in MANIFEST on shared workers, summary in MANIFEST.summary.tsv\n";
+    std::cout << "  --batch-jobs NUM        Images scanned at once with --batch (default: one per 4 threads)\n\n";
     std::cout << "Examples:\n";
     std::cout << "  " << program_name << " /dev/sda1 ./recovered\n";
     std::cout << "  " << program_name << " -v -t 4 -f jpg,pdf disk.img ./output\n";
-    std::cout << "  " << program_name << " --signature-only /dev/sdb1 ./photos\n\n";
+    std::cout << "  " << program_name << " --signature-only /dev/sdb1 ./photos\n";
+    std::cout << "  " << program_name << " -t 16 --batch case42.manifest\n\n";
     std::cout << "Safety Notes:\n";
     std::cout << "  - Always use read-only access to prevent data corruption\n";
     std::cout << "  - Consider creating a disk image first with: dd if=/dev/sdX of=image.img\n";
@@ -87,6 +147,63 @@ std::vector<std::string> parseFileTypes(const std::string& types_str) {
     return types;
 }
 
+int runBatch(const ScanConfig& config, const std::string& manifest, size_t max_active) {
+    LOG_INFO("Starting Advanced File Recovery Tool in batch mode");
+    LOG_INFO("Manifest: " + manifest);
+    
+    std::vector<BatchJob> jobs;
+    if (!BatchRecovery::loadManifest(manifest, jobs)) {
+        std::cerr << "Error: Could not read batch manifest: " << manifest << "\n";
+        return 1;
+    }
+    
+    try {
+        BatchRecovery batch(config, jobs, max_active);
+        batch.setProgressCallback([](const BatchResult& result, size_t done, size_t total) {
+            std::cout << "[" << done << "/" << total << "] " << result.job.device_path << ": "
+                      << BatchRecovery::statusName(result.status) << ", " << result.files_saved
+                      << " files saved to " << result.job.output_directory << std::endl;
+        });
+        
+        std::cout << "Starting batch recovery of " << jobs.size() << " images...\n";
+        std::atomic<bool> batch_done(false);
+        std::thread interrupt_watcher([&batch, &batch_done]() {
+            while (!batch_done) {
+                if (g_interrupt_received) {
+                    batch.stop();
+                    return;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(INTERRUPT_POLL_MS));
+            }
+        });
+        RecoveryStatus status = batch.run();
+        batch_done = true;
+        interrupt_watcher.join();
+        
+        std::string summary_path = manifest + ".summary.tsv";
+        if (batch.writeSummary(summary_path)) {
+            std::cout << "Summary written to " << summary_path << "\n";
+        }
+        
+        if (g_interrupt_received) {
+            std::cout << "Batch was interrupted by user.\n";
+            std::cout << "Run again with --resume to continue each image from its checkpoint.\n";
+            return 130;
+        }
+        if (status != RecoveryStatus::SUCCESS) {
+            std::cerr << "Some images failed. Check the summary and log file for details.\n";
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        LOG_CRITICAL("Unhandled exception: " + std::string(e.what()));
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    LOG_INFO("File recovery tool finished");
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     // Set up signal handlers
     signal(SIGINT, signalHandler);
@@ -96,6 +213,8 @@ int main(int argc, char* argv[]) {
     ScanConfig config;
     std::string log_file = "recovery.log";
     bool read_only_check = false;
+    std::string batch_manifest;
+    size_t batch_jobs = 0;
     
     static struct option long_options[] = {
         {"help", no_argument, 0, 'h'},
@@ -107,6 +226,27 @@ int main(int argc, char* argv[]) {
         {"signature-only", no_argument, 0, 's'},
         {"log-file", required_argument, 0, 'l'},
         {"read-only", no_argument, 0, 'r'},
+        {"io-backend", required_argument, 0, OPT_IO_BACKEND},
+        {"io-depth", required_argument, 0, OPT_IO_DEPTH},
+        {"direct-io", no_argument, 0, OPT_DIRECT_IO},
+        {"mmap", no_argument, 0, OPT_MMAP},
+        {"read-ahead", required_argument, 0, OPT_READ_AHEAD},
+        {"cache-size", required_argument, 0, OPT_CACHE_SIZE},
+        {"cache-block", required_argument, 0, OPT_CACHE_BLOCK},
+        {"no-skip-uniform", no_argument, 0, OPT_NO_SKIP_UNIFORM},
+        {"align", required_argument, 0, OPT_ALIGN},
+        {"degraded", no_argument, 0, OPT_DEGRADED},
+        {"bad-block-map", required_argument, 0, OPT_BAD_BLOCK_MAP},
+        {"chunk-overlap", required_argument, 0, OPT_CHUNK_OVERLAP},
+        {"max-span", required_argument, 0, OPT_MAX_SPAN},
+        {"extract-threads", required_argument, 0, OPT_EXTRACT_THREADS},
+        {"resume", no_argument, 0, OPT_RESUME},
+        {"numa", no_argument, 0, OPT_NUMA},
+        {"threads-per-node", required_argument, 0, OPT_THREADS_PER_NODE},
+        {"auto-tune", no_argument, 0, OPT_AUTO_TUNE},
+        {"batch", required_argument, 0, OPT_BATCH},
+        {"batch-jobs", required_argument, 0, OPT_BATCH_JOBS},
+        {"checkpoint-interval", required_argument, 0, OPT_CHECKPOINT_INTERVAL},
         {0, 0, 0, 0}
     };
     
@@ -153,6 +293,105 @@ int main(int argc, char* argv[]) {
                 read_only_check = true;
                 break;
                 
+            case OPT_IO_BACKEND: {
+                std::string backend = optarg;
+                if (backend == "sync") {
+                    config.io_backend = IoBackendType::SYNC;
+                } else if (backend == "io_uring" || backend == "uring") {
+                    config.io_backend = IoBackendType::IO_URING;
+                } else {
+                    std::cerr << "Unknown I/O backend: " << backend << " (expected sync or io_uring)\n";
+                    return 1;
+                }
+                break;
+            }
+                
+            case OPT_IO_DEPTH:
+                config.io_queue_depth = std::max(1ul, std::stoul(optarg));
+                break;
+                
+            case OPT_DIRECT_IO:
+                config.direct_io = true;
+                break;
+                
+            case OPT_MMAP:
+                config.use_mmap = true;
+                break;
+                
+            case OPT_READ_AHEAD:
+                config.read_ahead_chunks = std::max(1ul, std::stoul(optarg));
+                break;
+                
+            case OPT_CACHE_SIZE:
+                config.cache_size = std::stoull(optarg) * 1024 * 1024;
+                break;
+                
+            case OPT_CACHE_BLOCK:
+                config.cache_block_size = std::max(4ull, std::stoull(optarg)) * 1024;
+                break;
+                
+            case OPT_NO_SKIP_UNIFORM:
+                config.skip_uniform_blocks = false;
+                break;
+                
+            case OPT_ALIGN:
+                if (std::string(optarg) == "auto") {
+                    config.align_headers_to_clusters = true;
+                } else {
+                    config.header_alignment = std::stoull(optarg);
+                }
+                break;
+                
+            case OPT_DEGRADED:
+                config.degraded_mode = true;
+                break;
+                
+            case OPT_BAD_BLOCK_MAP:
+                config.degraded_mode = true;
+                config.bad_block_map_path = optarg;
+                break;
+                
+            case OPT_CHUNK_OVERLAP:
+                config.chunk_overlap = std::stoull(optarg) * 1024;
+                break;
+                
+            case OPT_MAX_SPAN:
+                config.max_span_extension = std::stoull(optarg) * 1024 * 1024;
+                break;
+                
+            case OPT_EXTRACT_THREADS:
+                config.extraction_threads = std::stoul(optarg);
+                break;
+                
+            case OPT_RESUME:
+                config.resume = true;
+                break;
+                
+            case OPT_CHECKPOINT_INTERVAL:
+                config.checkpoint_interval = std::stoul(optarg);
+                break;
+                
+            case OPT_NUMA:
+                config.numa_aware = true;
+                break;
+                
+            case OPT_THREADS_PER_NODE:
+                config.numa_aware = true;
+                config.threads_per_node = std::stoul(optarg);
+                break;
+                
+            case OPT_AUTO_TUNE:
+                config.auto_tune = true;
+                break;
+                
+            case OPT_BATCH:
+                batch_manifest = optarg;
+                break;
+                
+            case OPT_BATCH_JOBS:
+                batch_jobs = std::stoul(optarg);
+                break;
+                
             default:
                 std::cerr << "Unknown option. Use --help for usage information.\n";
                 return 1;
@@ -160,6 +399,16 @@ int main(int argc, char* argv[]) {
     }
     
     // Check for required arguments
+    if (!batch_manifest.empty()) {
+        if (optind != argc) {
+            std::cerr << "Error: --batch takes the devices from the manifest, not the command line.\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+        Logger::getInstance().initialize(log_file, config.verbose_logging ? Logger::Level::DEBUG : Logger::Level::INFO);
+        Logger::getInstance().setConsoleOutput(true);
+        return runBatch(config, batch_manifest, batch_jobs);
+    }
     if (optind + 2 != argc) {
         std::cerr << "Error: Missing required arguments.\n";
         printUsage(argv[0]);
@@ -168,6 +417,7 @@ int main(int argc, char* argv[]) {
     
     config.device_path = argv[optind];
     config.output_directory = argv[optind + 1];
+    config.checkpoint_path = (std::filesystem::path(config.output_directory) / ".filerec.checkpoint").string();
     
     // Initialize logging
     Logger::getInstance().initialize(log_file, config.verbose_logging ? Logger::Level::DEBUG : Logger::Level::INFO);
@@ -214,6 +464,10 @@ int main(int argc, char* argv[]) {
             case RecoveryStatus::SUCCESS:
                 std::cout << "\nRecovery completed successfully!\n";
                 std::cout << "Files recovered: " << engine.getRecoveredFileCount() << "\n";
+                if (engine.getUniformBytesSkipped() > 0) {
+                    std::cout << "Uniform blocks skipped: "
+                              << FileUtils::formatFileSize(engine.getUniformBytesSkipped()) << "\n";
+                }
                 std::cout << "Output directory: " << config.output_directory << "\n";
                 break;
                 
@@ -242,6 +496,7 @@ int main(int argc, char* argv[]) {
         
         if (g_interrupt_received) {
             std::cout << "Recovery was interrupted by user.\n";
+            std::cout << "Run again with --resume to continue from the checkpoint.\n";
             return 130; // Standard exit code for SIGINT
         }
         
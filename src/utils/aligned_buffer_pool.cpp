@@ -0,0 +1,60 @@
+#include "utils/aligned_buffer_pool.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace FileRecovery {
+
+AlignedBufferPool::AlignedBufferPool(Size alignment, size_t max_cached)
+    : alignment_(alignment)
+    , max_cached_(max_cached)
+    , reuse_count_(0) {
+}
+
+AlignedBufferPool::~AlignedBufferPool() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : idle_) {
+        std::free(entry.second);
+    }
+    idle_.clear();
+}
+
+AlignedBufferPool::Buffer AlignedBufferPool::acquire(Size size) {
+    Size capacity = alignUp(std::max<Size>(size, 1));
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Smallest idle buffer that is large enough
+        auto it = idle_.lower_bound(capacity);
+        if (it != idle_.end()) {
+            Buffer buffer(this, it->second, it->first);
+            idle_.erase(it);
+            reuse_count_++;
+            return buffer;
+        }
+    }
+
+    void* memory = nullptr;
+    if (posix_memalign(&memory, alignment_, capacity) != 0) {
+        LOG_ERROR("Failed to allocate aligned buffer of " + std::to_string(capacity) + " bytes");
+        return Buffer();
+    }
+
+    return Buffer(this, static_cast<Byte*>(memory), capacity);
+}
+
+size_t AlignedBufferPool::getReuseCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return reuse_count_;
+}
+
+void AlignedBufferPool::release(Byte* data, Size capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (idle_.size() < max_cached_) {
+        idle_.emplace(capacity, data);
+    } else {
+        std::free(data);
+    }
+}
+
+} // namespace FileRecovery
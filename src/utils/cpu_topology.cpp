@@ -0,0 +1,166 @@
+#include "utils/cpu_topology.h"
+#include "utils/logger.h"
+#include <pthread.h>
+#include <sched.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#ifdef USE_NUMA
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace FileRecovery {
+
+// sysfs directory listing the NUMA nodes
+constexpr const char* SYSFS_NODE_DIR = "/sys/devices/system/node";
+
+// Bits in the node mask passed to mbind()
+constexpr unsigned long NODE_MASK_BITS = sizeof(unsigned long) * 8;
+
+namespace {
+
+// CPUs the scheduler allows this process to run on
+std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+    if (cpus.empty()) {
+        cpus.push_back(0);
+    }
+    return cpus;
+}
+
+} // namespace
+
+std::vector<NumaNode> CpuTopology::detectNodes() {
+    std::vector<int> allowed = allowedCpus();
+    std::vector<NumaNode> nodes;
+
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(SYSFS_NODE_DIR, ec)) {
+        std::string name = entry.path().filename().string();
+        if (name.compare(0, 4, "node") != 0 || name.size() == 4 ||
+            !std::all_of(name.begin() + 4, name.end(), [](unsigned char c) { return std::isdigit(c); })) {
+            continue;
+        }
+
+        std::ifstream cpulist(entry.path() / "cpulist");
+        std::string list;
+        if (!std::getline(cpulist, list)) {
+            continue;
+        }
+
+        NumaNode node;
+        node.id = std::stoi(name.substr(4));
+        for (int cpu : parseCpuList(list)) {
+            if (std::binary_search(allowed.begin(), allowed.end(), cpu)) {
+                node.cpus.push_back(cpu);
+            }
+        }
+        // Memory-only nodes and nodes outside our cpuset cannot run workers
+        if (!node.cpus.empty()) {
+            nodes.push_back(node);
+        }
+    }
+
+    if (nodes.empty()) {
+        NumaNode node;
+        node.cpus = allowed;
+        nodes.push_back(node);
+    }
+
+    std::sort(nodes.begin(), nodes.end(), [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+    return nodes;
+}
+
+std::vector<int> CpuTopology::parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string item;
+
+    while (std::getline(ss, item, ',')) {
+        item.erase(0, item.find_first_not_of(" \t\n"));
+        item.erase(item.find_last_not_of(" \t\n") + 1);
+        if (item.empty()) {
+            continue;
+        }
+
+        try {
+            size_t dash = item.find('-');
+            int first = std::stoi(item.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            LOG_WARNING("Ignoring malformed CPU list entry: " + item);
+        }
+    }
+
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+bool CpuTopology::pinCurrentThread(const std::vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    if (CPU_COUNT(&set) == 0) {
+        return false;
+    }
+
+    int result = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (result != 0) {
+        LOG_DEBUG("Failed to pin thread: " + std::string(strerror(result)));
+        return false;
+    }
+    return true;
+}
+
+#ifdef USE_NUMA
+
+bool CpuTopology::bindMemory(void* address, Size size, int node) {
+    if (node < 0 || static_cast<unsigned long>(node) >= NODE_MASK_BITS || size == 0) {
+        return false;
+    }
+
+    unsigned long mask = 1UL << node;
+    long result = syscall(SYS_mbind, address, size, MPOL_BIND, &mask, NODE_MASK_BITS, MPOL_MF_MOVE);
+    if (result != 0) {
+        LOG_DEBUG("mbind to node " + std::to_string(node) + " failed: " + std::string(strerror(errno)));
+        return false;
+    }
+    return true;
+}
+
+#else // !USE_NUMA
+
+bool CpuTopology::bindMemory(void* address, Size size, int node) {
+    (void)address;
+    (void)size;
+    (void)node;
+    return false;
+}
+
+#endif // USE_NUMA
+
+} // namespace FileRecovery
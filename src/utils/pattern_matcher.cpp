@@ -0,0 +1,192 @@
+#include "utils/pattern_matcher.h"
+#include "utils/simd_utils.h"
+#include <algorithm>
+#include <queue>
+
+namespace FileRecovery {
+
+// Transition table row width, one entry per byte value
+constexpr size_t ALPHABET_SIZE = 256;
+
+// Set in a transition whose target state ends at least one pattern, so
+// the scan loop only looks up outputs when there are some
+constexpr uint32_t OUTPUT_FLAG = 0x80000000u;
+
+MultiPatternMatcher::MultiPatternMatcher()
+    : tag_count_(0) {
+    build();
+}
+
+void MultiPatternMatcher::addPattern(const std::vector<Byte>& pattern, size_t tag) {
+    if (pattern.empty()) {
+        return;
+    }
+    patterns_.push_back({pattern, tag});
+    tag_count_ = std::max(tag_count_, tag + 1);
+}
+
+void MultiPatternMatcher::build() {
+    // Trie of all patterns; 0 marks a missing edge since the root is never a child
+    std::vector<std::vector<uint32_t>> children(1, std::vector<uint32_t>(ALPHABET_SIZE, 0));
+    std::vector<std::vector<Output>> state_outputs(1);
+    depths_.assign(1, 0);
+    for (const auto& pattern : patterns_) {
+        uint32_t state = 0;
+        for (Byte byte : pattern.bytes) {
+            if (children[state][byte] == 0) {
+                children[state][byte] = static_cast<uint32_t>(children.size());
+                children.emplace_back(ALPHABET_SIZE, 0);
+                state_outputs.emplace_back();
+                depths_.push_back(depths_[state] + 1);
+            }
+            state = children[state][byte];
+        }
+        state_outputs[state].push_back({static_cast<uint32_t>(pattern.tag),
+                                        static_cast<uint32_t>(pattern.bytes.size())});
+    }
+
+    // Breadth-first, each state's failure link is already final when it is
+    // reached, so missing edges can borrow the failure state's transitions
+    size_t state_count = children.size();
+    std::vector<uint32_t> failure(state_count, 0);
+    transitions_.assign(state_count * ALPHABET_SIZE, 0);
+    std::queue<uint32_t> pending;
+    start_bytes_.clear();
+    for (size_t byte = 0; byte < ALPHABET_SIZE; ++byte) {
+        uint32_t child = children[0][byte];
+        transitions_[byte] = child;
+        if (child != 0) {
+            pending.push(child);
+            start_bytes_.push_back(static_cast<Byte>(byte));
+        }
+    }
+    while (!pending.empty()) {
+        uint32_t state = pending.front();
+        pending.pop();
+        // A match ending here also ends every shorter match at the failure state
+        const auto& inherited = state_outputs[failure[state]];
+        state_outputs[state].insert(state_outputs[state].end(), inherited.begin(), inherited.end());
+
+        for (size_t byte = 0; byte < ALPHABET_SIZE; ++byte) {
+            uint32_t child = children[state][byte];
+            uint32_t fallback = transitions_[failure[state] * ALPHABET_SIZE + byte];
+            if (child != 0) {
+                failure[child] = fallback;
+                transitions_[state * ALPHABET_SIZE + byte] = child;
+                pending.push(child);
+            } else {
+                transitions_[state * ALPHABET_SIZE + byte] = fallback;
+            }
+        }
+    }
+
+    outputs_begin_.assign(state_count + 1, 0);
+    outputs_.clear();
+    for (size_t state = 0; state < state_count; ++state) {
+        auto& list = state_outputs[state];
+        std::sort(list.begin(), list.end(), [](const Output& a, const Output& b) {
+            return a.tag != b.tag ? a.tag < b.tag : a.length < b.length;
+        });
+        list.erase(std::unique(list.begin(), list.end(), [](const Output& a, const Output& b) {
+            return a.tag == b.tag && a.length == b.length;
+        }), list.end());
+        outputs_begin_[state] = static_cast<uint32_t>(outputs_.size());
+        outputs_.insert(outputs_.end(), list.begin(), list.end());
+    }
+    outputs_begin_[state_count] = static_cast<uint32_t>(outputs_.size());
+
+    // Transitions hold the target's row offset, flagged if it has outputs
+    for (auto& target : transitions_) {
+        bool has_outputs = outputs_begin_[target + 1] > outputs_begin_[target];
+        target = static_cast<uint32_t>(target * ALPHABET_SIZE) | (has_outputs ? OUTPUT_FLAG : 0);
+    }
+}
+
+void MultiPatternMatcher::findAll(const Byte* data, Size size, std::vector<std::vector<Offset>>& hits) const {
+    hits.resize(tag_count_);
+    for (auto& tag_hits : hits) {
+        tag_hits.clear();
+    }
+    if (patterns_.empty()) {
+        return;
+    }
+
+    const uint32_t* table = transitions_.data();
+    const uint32_t* outputs_begin = outputs_begin_.data();
+    bool unordered = false;
+    // At the root only a pattern's first byte leads anywhere, so the scan
+    // jumps to the next such byte when there are few enough to vectorize
+    bool skip_at_root = start_bytes_.size() <= SimdUtils::MAX_VECTOR_BYTE_SET;
+
+    uint32_t row = 0;
+    for (Size i = 0; i < size; ++i) {
+        if (row == 0 && skip_at_root) {
+            i += SimdUtils::findFirstOf(data + i, size - i, start_bytes_);
+            if (i >= size) {
+                break;
+            }
+        }
+        uint32_t next = table[row + data[i]];
+        row = next & ~OUTPUT_FLAG;
+        if (!(next & OUTPUT_FLAG)) {
+            continue;
+        }
+        uint32_t state = row / ALPHABET_SIZE;
+        for (uint32_t k = outputs_begin[state]; k < outputs_begin[state + 1]; ++k) {
+            const Output& output = outputs_[k];
+            auto& tag_hits = hits[output.tag];
+            Offset start = i + 1 - output.length;
+            // Patterns of different lengths under one tag can report starts
+            // out of order, or the same start twice
+            unordered |= !tag_hits.empty() && tag_hits.back() >= start;
+            tag_hits.push_back(start);
+        }
+    }
+
+    if (unordered) {
+        for (auto& tag_hits : hits) {
+            std::sort(tag_hits.begin(), tag_hits.end());
+            tag_hits.erase(std::unique(tag_hits.begin(), tag_hits.end()), tag_hits.end());
+        }
+    }
+}
+
+void MultiPatternMatcher::findAllAligned(const Byte* data, Size size, Size first, Size stride,
+                                         std::vector<std::vector<Offset>>& hits) const {
+    hits.resize(tag_count_);
+    for (auto& tag_hits : hits) {
+        tag_hits.clear();
+    }
+    if (patterns_.empty()) {
+        return;
+    }
+    stride = std::max<Size>(stride, 1);
+
+    const uint32_t* table = transitions_.data();
+    for (Size start = first; start < size; start += stride) {
+        // Follow the trie from the root; once the automaton falls back to a
+        // shorter state, no pattern starting here can match any more
+        uint32_t row = 0;
+        for (Size i = start; i < size; ++i) {
+            uint32_t next = table[row + data[i]];
+            row = next & ~OUTPUT_FLAG;
+            uint32_t state = row / ALPHABET_SIZE;
+            Size length = i - start + 1;
+            if (depths_[state] != length) {
+                break;
+            }
+            if (!(next & OUTPUT_FLAG)) {
+                continue;
+            }
+            for (uint32_t k = outputs_begin_[state]; k < outputs_begin_[state + 1]; ++k) {
+                const Output& output = outputs_[k];
+                auto& tag_hits = hits[output.tag];
+                if (output.length == length && (tag_hits.empty() || tag_hits.back() != start)) {
+                    tag_hits.push_back(start);
+                }
+            }
+        }
+    }
+}
+
+} // namespace FileRecovery
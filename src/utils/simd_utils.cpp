@@ -0,0 +1,368 @@
+#include "utils/simd_utils.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FILEREC_X86_SIMD 1
+#endif
+
+namespace FileRecovery {
+
+namespace {
+
+// Whether the bytes between a candidate's first and last byte match too
+inline bool middleMatches(const Byte* candidate, const Byte* pattern, Size length) {
+    return length <= 2 || std::memcmp(candidate + 1, pattern + 1, length - 2) == 0;
+}
+
+// Scalar search over the candidate starts [from, last_start]
+void findPatternScalar(const Byte* data, Size from, Size last_start, const Byte* pattern, Size length,
+                       std::vector<Offset>& matches) {
+    const Byte first = pattern[0];
+    const Byte last = pattern[length - 1];
+    for (Size i = from; i <= last_start; ++i) {
+        if (data[i] == first && data[i + length - 1] == last && middleMatches(data + i, pattern, length)) {
+            matches.push_back(i);
+        }
+    }
+}
+
+Size findFirstOfScalar(const Byte* data, Size from, Size size, const std::vector<Byte>& values) {
+    bool wanted[256] = {};
+    for (Byte value : values) {
+        wanted[value] = true;
+    }
+    for (Size i = from; i < size; ++i) {
+        if (wanted[data[i]]) {
+            return i;
+        }
+    }
+    return size;
+}
+
+bool isUniformScalar(const Byte* data, Size size) {
+    Byte first = data[0];
+    for (Size i = 1; i < size; ++i) {
+        if (data[i] != first) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef FILEREC_X86_SIMD
+
+__attribute__((target("sse2")))
+bool isUniformSse2(const Byte* data, Size size) {
+    const __m128i ref = _mm_set1_epi8(static_cast<char>(data[0]));
+    Size i = 0;
+
+    // 64 bytes per iteration, one branch per iteration
+    for (; i + 64 <= size; i += 64) {
+        __m128i a = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), ref);
+        __m128i b = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 16)), ref);
+        __m128i c = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 32)), ref);
+        __m128i d = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 48)), ref);
+        __m128i all = _mm_and_si128(_mm_and_si128(a, b), _mm_and_si128(c, d));
+        if (_mm_movemask_epi8(all) != 0xFFFF) {
+            return false;
+        }
+    }
+    for (; i + 16 <= size; i += 16) {
+        __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), ref);
+        if (_mm_movemask_epi8(eq) != 0xFFFF) {
+            return false;
+        }
+    }
+    for (; i < size; ++i) {
+        if (data[i] != data[0]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+__attribute__((target("avx2")))
+bool isUniformAvx2(const Byte* data, Size size) {
+    const __m256i ref = _mm256_set1_epi8(static_cast<char>(data[0]));
+    Size i = 0;
+
+    // 128 bytes per iteration, one branch per iteration
+    for (; i + 128 <= size; i += 128) {
+        __m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), ref);
+        __m256i b = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32)), ref);
+        __m256i c = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 64)), ref);
+        __m256i d = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 96)), ref);
+        __m256i all = _mm256_and_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, d));
+        if (_mm256_movemask_epi8(all) != -1) {
+            return false;
+        }
+    }
+    for (; i + 32 <= size; i += 32) {
+        __m256i eq = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), ref);
+        if (_mm256_movemask_epi8(eq) != -1) {
+            return false;
+        }
+    }
+    for (; i < size; ++i) {
+        if (data[i] != data[0]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Candidate starts are bits of a 32-bit mask; returns the next start to search
+__attribute__((target("sse2")))
+Size findPatternSse2(const Byte* data, Size last_start, const Byte* pattern, Size length,
+                     std::vector<Offset>& matches) {
+    const __m128i first = _mm_set1_epi8(static_cast<char>(pattern[0]));
+    const __m128i last = _mm_set1_epi8(static_cast<char>(pattern[length - 1]));
+    Size i = 0;
+
+    // 32 candidate starts per iteration as two 16-byte halves
+    for (; i + 31 <= last_start; i += 32) {
+        const Byte* head = data + i;
+        const Byte* tail = data + i + length - 1;
+        __m128i lo = _mm_and_si128(
+            _mm_cmpeq_epi8(first, _mm_loadu_si128(reinterpret_cast<const __m128i*>(head))),
+            _mm_cmpeq_epi8(last, _mm_loadu_si128(reinterpret_cast<const __m128i*>(tail))));
+        __m128i hi = _mm_and_si128(
+            _mm_cmpeq_epi8(first, _mm_loadu_si128(reinterpret_cast<const __m128i*>(head + 16))),
+            _mm_cmpeq_epi8(last, _mm_loadu_si128(reinterpret_cast<const __m128i*>(tail + 16))));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(lo)) |
+                        (static_cast<uint32_t>(_mm_movemask_epi8(hi)) << 16);
+        while (mask != 0) {
+            Size bit = static_cast<Size>(__builtin_ctz(mask));
+            if (middleMatches(head + bit, pattern, length)) {
+                matches.push_back(i + bit);
+            }
+            mask &= mask - 1;
+        }
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+Size findPatternAvx2(const Byte* data, Size last_start, const Byte* pattern, Size length,
+                     std::vector<Offset>& matches) {
+    const __m256i first = _mm256_set1_epi8(static_cast<char>(pattern[0]));
+    const __m256i last = _mm256_set1_epi8(static_cast<char>(pattern[length - 1]));
+    Size i = 0;
+
+    for (; i + 31 <= last_start; i += 32) {
+        const Byte* head = data + i;
+        __m256i eq = _mm256_and_si256(
+            _mm256_cmpeq_epi8(first, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(head))),
+            _mm256_cmpeq_epi8(last, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(head + length - 1))));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(eq));
+        while (mask != 0) {
+            Size bit = static_cast<Size>(__builtin_ctz(mask));
+            if (middleMatches(head + bit, pattern, length)) {
+                matches.push_back(i + bit);
+            }
+            mask &= mask - 1;
+        }
+    }
+    return i;
+}
+
+// Vector versions of findFirstOf return the offset of the first match, or
+// the first offset left for the scalar tail if there is none
+__attribute__((target("sse2")))
+Size findFirstOfSse2(const Byte* data, Size size, const std::vector<Byte>& values, bool& found) {
+    __m128i sets[SimdUtils::MAX_VECTOR_BYTE_SET];
+    Size count = values.size();
+    for (Size k = 0; k < count; ++k) {
+        sets[k] = _mm_set1_epi8(static_cast<char>(values[k]));
+    }
+    for (Size i = 0; i + 16 <= size; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i any = _mm_cmpeq_epi8(block, sets[0]);
+        for (Size k = 1; k < count; ++k) {
+            any = _mm_or_si128(any, _mm_cmpeq_epi8(block, sets[k]));
+        }
+        int mask = _mm_movemask_epi8(any);
+        if (mask != 0) {
+            found = true;
+            return i + static_cast<Size>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+    }
+    return size - size % 16;
+}
+
+__attribute__((target("avx2")))
+Size findFirstOfAvx2(const Byte* data, Size size, const std::vector<Byte>& values, bool& found) {
+    __m256i sets[SimdUtils::MAX_VECTOR_BYTE_SET];
+    Size count = values.size();
+    for (Size k = 0; k < count; ++k) {
+        sets[k] = _mm256_set1_epi8(static_cast<char>(values[k]));
+    }
+    for (Size i = 0; i + 32 <= size; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i any = _mm256_cmpeq_epi8(block, sets[0]);
+        for (Size k = 1; k < count; ++k) {
+            any = _mm256_or_si256(any, _mm256_cmpeq_epi8(block, sets[k]));
+        }
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(any));
+        if (mask != 0) {
+            found = true;
+            return i + static_cast<Size>(__builtin_ctz(mask));
+        }
+    }
+    return size - size % 32;
+}
+
+#endif // FILEREC_X86_SIMD
+
+SimdLevel detectSimdLevel() {
+#ifdef FILEREC_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return SimdLevel::SSE2;
+    }
+#endif
+    return SimdLevel::SCALAR;
+}
+
+} // namespace
+
+SimdLevel SimdUtils::getSimdLevel() {
+    static const SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+const char* SimdUtils::getSimdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::SSE2: return "SSE2";
+        default: return "scalar";
+    }
+}
+
+bool SimdUtils::isUniform(const Byte* data, Size size) {
+    return isUniform(data, size, getSimdLevel());
+}
+
+bool SimdUtils::isUniform(const Byte* data, Size size, SimdLevel level) {
+    if (size == 0) {
+        return true;
+    }
+
+    level = std::min(level, getSimdLevel());
+#ifdef FILEREC_X86_SIMD
+    if (level == SimdLevel::AVX2) {
+        return isUniformAvx2(data, size);
+    }
+    if (level == SimdLevel::SSE2) {
+        return isUniformSse2(data, size);
+    }
+#endif
+    return isUniformScalar(data, size);
+}
+
+std::vector<Offset> SimdUtils::findPattern(const Byte* data, Size size, const std::vector<Byte>& pattern) {
+    return findPattern(data, size, pattern, getSimdLevel());
+}
+
+std::vector<Offset> SimdUtils::findPattern(const Byte* data, Size size, const std::vector<Byte>& pattern,
+                                           SimdLevel level) {
+    std::vector<Offset> matches;
+    if (pattern.empty() || size < pattern.size()) {
+        return matches;
+    }
+
+    // Vector loads read up to 31 bytes past a candidate's first and last
+    // byte, so the vector loops stop where that would leave the buffer
+    Size last_start = size - pattern.size();
+    Size from = 0;
+    level = std::min(level, getSimdLevel());
+#ifdef FILEREC_X86_SIMD
+    if (level == SimdLevel::AVX2) {
+        from = findPatternAvx2(data, last_start, pattern.data(), pattern.size(), matches);
+    } else if (level == SimdLevel::SSE2) {
+        from = findPatternSse2(data, last_start, pattern.data(), pattern.size(), matches);
+    }
+#endif
+    findPatternScalar(data, from, last_start, pattern.data(), pattern.size(), matches);
+    return matches;
+}
+
+Size SimdUtils::findFirstOf(const Byte* data, Size size, const std::vector<Byte>& values) {
+    return findFirstOf(data, size, values, getSimdLevel());
+}
+
+Size SimdUtils::findFirstOf(const Byte* data, Size size, const std::vector<Byte>& values, SimdLevel level) {
+    if (values.empty()) {
+        return size;
+    }
+
+    Size from = 0;
+    level = values.size() <= MAX_VECTOR_BYTE_SET ? std::min(level, getSimdLevel()) : SimdLevel::SCALAR;
+#ifdef FILEREC_X86_SIMD
+    bool found = false;
+    if (level == SimdLevel::AVX2) {
+        from = findFirstOfAvx2(data, size, values, found);
+    } else if (level == SimdLevel::SSE2) {
+        from = findFirstOfSse2(data, size, values, found);
+    }
+    if (found) {
+        return from;
+    }
+#endif
+    return findFirstOfScalar(data, from, size, values);
+}
+
+std::vector<std::pair<Size, Size>> SimdUtils::findNonUniformRuns(
+    const Byte* data,
+    Size size,
+    Size block_size,
+    Size min_uniform_run) {
+
+    std::vector<std::pair<Size, Size>> runs;
+    if (size == 0) {
+        return runs;
+    }
+    block_size = std::max<Size>(block_size, 1);
+
+    Size run_start = 0;      // Start of the current non-uniform run
+    Size uniform_start = 0;  // Start of the trailing uniform blocks
+    bool in_uniform = false;
+
+    auto close_uniform = [&](Size uniform_end) {
+        if (uniform_end - uniform_start >= min_uniform_run) {
+            if (uniform_start > run_start) {
+                runs.emplace_back(run_start, uniform_start - run_start);
+            }
+            run_start = uniform_end;
+        }
+    };
+
+    for (Size pos = 0; pos < size; pos += block_size) {
+        Size length = std::min(block_size, size - pos);
+        if (isUniform(data + pos, length)) {
+            if (!in_uniform) {
+                uniform_start = pos;
+                in_uniform = true;
+            }
+        } else if (in_uniform) {
+            close_uniform(pos);
+            in_uniform = false;
+        }
+    }
+
+    if (in_uniform) {
+        close_uniform(size);
+    }
+    if (run_start < size) {
+        runs.emplace_back(run_start, size - run_start);
+    }
+
+    return runs;
+}
+
+} // namespace FileRecovery
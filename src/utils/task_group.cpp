@@ -0,0 +1,130 @@
+#include "utils/task_group.h"
+#include <algorithm>
+#include <utility>
+
+namespace FileRecovery {
+
+FairTaskQueue::FairTaskQueue(ThreadPool& pool, size_t max_in_flight)
+    : pool_(pool)
+    , max_in_flight_(max_in_flight > 0 ? max_in_flight : pool.getThreadCount())
+    , next_client_(0)
+    , turn_(0)
+    , in_flight_(0) {
+}
+
+size_t FairTaskQueue::addClient() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t client = next_client_++;
+    queues_[client];
+    return client;
+}
+
+void FairTaskQueue::removeClient(size_t client) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queues_.erase(client);
+}
+
+void FairTaskQueue::submit(size_t client, ThreadPool::Task task) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queues_[client].push_back(std::move(task));
+    dispatch();
+}
+
+void FairTaskQueue::dispatch() {
+    while (in_flight_ < max_in_flight_) {
+        // Clients take turns in id order, starting after the one served last
+        auto pick = queues_.end();
+        auto next = queues_.upper_bound(turn_);
+        for (size_t i = 0; i < queues_.size(); ++i, ++next) {
+            if (next == queues_.end()) {
+                next = queues_.begin();
+            }
+            if (!next->second.empty()) {
+                pick = next;
+                break;
+            }
+        }
+        if (pick == queues_.end()) {
+            return;
+        }
+
+        turn_ = pick->first;
+        ThreadPool::Task task = std::move(pick->second.front());
+        pick->second.pop_front();
+        in_flight_++;
+
+        // The task keeps the queue alive until it has handed its slot on,
+        // which happens after the task's owner may already have stopped waiting
+        pool_.submit([self = shared_from_this(), task = std::move(task)]() mutable {
+            // The slot is handed on even if the task throws
+            struct Slot {
+                FairTaskQueue* queue;
+                ~Slot() {
+                    std::lock_guard<std::mutex> lock(queue->mutex_);
+                    queue->in_flight_--;
+                    queue->dispatch();
+                }
+            } slot{self.get()};
+            task();
+        });
+    }
+}
+
+TaskGroup::TaskGroup(ThreadPool& pool, std::shared_ptr<FairTaskQueue> queue)
+    : pool_(pool)
+    , queue_(std::move(queue))
+    , client_(queue_ ? queue_->addClient() : 0)
+    , pending_(0)
+    , executed_(0) {
+}
+
+TaskGroup::~TaskGroup() {
+    wait();
+    if (queue_) {
+        queue_->removeClient(client_);
+    }
+}
+
+void TaskGroup::submit(ThreadPool::Task task, int node) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_++;
+    }
+
+    auto counted = [this, task = std::move(task)]() mutable {
+        struct Done {
+            TaskGroup* group;
+            ~Done() { group->finishTask(); }
+        } done{this};
+        task();
+    };
+
+    if (queue_) {
+        queue_->submit(client_, std::move(counted));
+    } else if (node >= 0) {
+        pool_.submit(std::move(counted), node);
+    } else {
+        pool_.submit(std::move(counted));
+    }
+}
+
+void TaskGroup::wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this]() { return pending_ == 0; });
+}
+
+size_t TaskGroup::getExecutedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return executed_;
+}
+
+void TaskGroup::finishTask() {
+    // Notified under the lock: the group may be destroyed as soon as wait() sees zero
+    std::lock_guard<std::mutex> lock(mutex_);
+    executed_++;
+    if (--pending_ == 0) {
+        idle_cv_.notify_all();
+    }
+}
+
+} // namespace FileRecovery
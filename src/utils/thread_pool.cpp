@@ -0,0 +1,198 @@
+#include "utils/thread_pool.h"
+#include "utils/cpu_topology.h"
+#include "utils/logger.h"
+#include <algorithm>
+#include <exception>
+#include <string>
+
+namespace FileRecovery {
+
+namespace {
+
+// Pool, deque index and NUMA node of the current thread when it is a pool worker
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local size_t current_index = 0;
+thread_local int current_node = -1;
+
+} // namespace
+
+ThreadPool::ThreadPool(size_t num_threads)
+    : pending_(0)
+    , stopping_(false)
+    , queued_(0)
+    , next_queue_(0)
+    , tasks_executed_(0)
+    , tasks_stolen_(0) {
+
+    startWorkers(std::vector<WorkerPlacement>(std::max<size_t>(1, num_threads)));
+}
+
+ThreadPool::ThreadPool(const std::vector<WorkerPlacement>& placement)
+    : pending_(0)
+    , stopping_(false)
+    , queued_(0)
+    , next_queue_(0)
+    , tasks_executed_(0)
+    , tasks_stolen_(0) {
+
+    startWorkers(placement.empty() ? std::vector<WorkerPlacement>(1) : placement);
+}
+
+void ThreadPool::startWorkers(std::vector<WorkerPlacement> placement) {
+    placement_ = std::move(placement);
+    for (size_t i = 0; i < placement_.size(); ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (size_t i = 0; i < placement_.size(); ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void ThreadPool::submit(Task task) {
+    size_t index = current_pool == this ? current_index
+                                        : next_queue_.fetch_add(1) % queues_.size();
+    enqueue(index, std::move(task));
+}
+
+void ThreadPool::submit(Task task, int node) {
+    // Round-robin over the node's workers
+    size_t node_workers = std::count_if(placement_.begin(), placement_.end(),
+                                        [node](const WorkerPlacement& worker) { return worker.node == node; });
+    if (node_workers == 0) {
+        submit(std::move(task));
+        return;
+    }
+
+    size_t pick = next_queue_.fetch_add(1) % node_workers;
+    for (size_t i = 0; i < placement_.size(); ++i) {
+        if (placement_[i].node == node && pick-- == 0) {
+            enqueue(i, std::move(task));
+            return;
+        }
+    }
+}
+
+void ThreadPool::enqueue(size_t index, Task task) {
+    {
+        // Count the task before it becomes visible so queued_ never underflows;
+        // updating under mutex_ means a worker about to sleep cannot miss it
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++pending_;
+        ++queued_;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    work_cv_.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this]() { return pending_ == 0; });
+}
+
+int ThreadPool::currentNode() {
+    return current_node;
+}
+
+ThreadPoolStats ThreadPool::getStats() const {
+    ThreadPoolStats stats;
+    stats.tasks_executed = tasks_executed_;
+    stats.tasks_stolen = tasks_stolen_;
+    return stats;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    current_pool = this;
+    current_index = index;
+    current_node = placement_[index].node;
+    if (!placement_[index].cpus.empty() && !CpuTopology::pinCurrentThread(placement_[index].cpus)) {
+        LOG_WARNING("Could not pin worker " + std::to_string(index) + " to its CPUs");
+    }
+
+    while (true) {
+        Task task;
+        // Work from the same node first; its data is in local memory
+        if (popLocal(index, task) || steal(index, task, true) || steal(index, task, false)) {
+            runTask(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        work_cv_.wait(lock, [this]() { return stopping_ || queued_ > 0; });
+        if (stopping_ && queued_ == 0) {
+            return;
+        }
+    }
+}
+
+bool ThreadPool::popLocal(size_t index, Task& task) {
+    WorkerQueue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    // Newest first: its data is most likely still in this core's cache
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    --queued_;
+    return true;
+}
+
+bool ThreadPool::steal(size_t index, Task& task, bool same_node) {
+    for (size_t i = 1; i < queues_.size(); ++i) {
+        size_t victim_index = (index + i) % queues_.size();
+        if ((placement_[victim_index].node == placement_[index].node) != same_node) {
+            continue;
+        }
+        WorkerQueue& victim = *queues_[victim_index];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty()) {
+            continue;
+        }
+        // Oldest first: the victim works from the other end
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        --queued_;
+        ++tasks_stolen_;
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::runTask(Task& task) {
+    try {
+        task();
+    } catch (const std::exception& e) {
+        LOG_ERROR("Thread pool task failed: " + std::string(e.what()));
+    } catch (...) {
+        LOG_ERROR("Thread pool task failed with an unknown exception");
+    }
+    ++tasks_executed_;
+
+    bool idle;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle = --pending_ == 0;
+    }
+    if (idle) {
+        idle_cv_.notify_all();
+    }
+}
+
+} // namespace FileRecovery
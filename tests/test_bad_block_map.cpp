@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+#include "core/bad_block_map.h"
+#include "core/disk_scanner.h"
+#include "utils/logger.h"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+
+using namespace FileRecovery;
+
+class BadBlockMapTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_data_dir_ = "test_bad_block_data";
+        std::filesystem::create_directories(test_data_dir_);
+        
+        // 1MB image where every byte is non-zero, so zero-fill is visible
+        test_image_path_ = test_data_dir_ + "/failing_disk.img";
+        map_path_ = test_data_dir_ + "/failing_disk.badblocks";
+        image_data_.resize(1024 * 1024);
+        for (size_t i = 0; i < image_data_.size(); ++i) {
+            image_data_[i] = static_cast<Byte>(i % 251 + 1);
+        }
+        std::ofstream img_file(test_image_path_, std::ios::binary);
+        img_file.write(reinterpret_cast<const char*>(image_data_.data()), image_data_.size());
+        img_file.close();
+        
+        Logger::getInstance().initialize("test_bad_block.log", Logger::Level::DEBUG);
+    }
+    
+    void TearDown() override {
+        std::filesystem::remove_all(test_data_dir_);
+        std::filesystem::remove("test_bad_block.log");
+    }
+    
+    ScanConfig degradedConfig() {
+        ScanConfig config;
+        config.degraded_mode = true;
+        config.bad_block_map_path = map_path_;
+        return config;
+    }
+    
+    // Reads fail whenever they touch [bad_start, bad_end)
+    static ReadFaultHook failRange(Offset bad_start, Offset bad_end, std::atomic<int>* hits = nullptr) {
+        return [=](Offset offset, Size size) {
+            bool fails = offset < bad_end && offset + size > bad_start;
+            if (fails && hits) {
+                (*hits)++;
+            }
+            return fails;
+        };
+    }
+    
+    bool isZero(const std::vector<Byte>& buffer, Size from, Size to) {
+        return std::all_of(buffer.begin() + from, buffer.begin() + to, [](Byte b) { return b == 0; });
+    }
+    
+    std::string test_data_dir_;
+    std::string test_image_path_;
+    std::string map_path_;
+    std::vector<Byte> image_data_;
+};
+
+TEST_F(BadBlockMapTest, MergesAndQueriesRanges) {
+    BadBlockMap map;
+    map.add(1000, 100);
+    map.add(2000, 100);
+    map.add(1100, 50);      // Adjacent: extends the first range
+    map.add(1050, 10);      // Already covered
+    
+    auto ranges = map.getRanges();
+    ASSERT_EQ(ranges.size(), 2u);
+    EXPECT_EQ(ranges[0], std::make_pair(Offset(1000), Size(150)));
+    
+    map.add(900, 1200);     // Swallows both
+    ranges = map.getRanges();
+    ASSERT_EQ(ranges.size(), 1u);
+    EXPECT_EQ(ranges[0], std::make_pair(Offset(900), Size(1200)));
+    EXPECT_EQ(map.getTotalBytes(), 1200u);
+    
+    Offset end = 0;
+    EXPECT_TRUE(map.overlaps(2000, 200));
+    EXPECT_FALSE(map.overlaps(2100, 200));
+    EXPECT_FALSE(map.overlaps(800, 100));
+    EXPECT_TRUE(map.findContaining(1500, end));
+    EXPECT_EQ(end, 2100u);
+    EXPECT_FALSE(map.findContaining(2100, end));
+    EXPECT_EQ(map.nextBadStart(0, 5000), 900u);
+    EXPECT_EQ(map.nextBadStart(1000, 5000), 5000u);
+}
+
+TEST_F(BadBlockMapTest, SaveAndLoad) {
+    BadBlockMap map;
+    map.add(4096, 512);
+    map.add(65536, 8192);
+    EXPECT_TRUE(map.isDirty());
+    ASSERT_TRUE(map.save(map_path_, image_data_.size()));
+    EXPECT_FALSE(map.isDirty());
+    
+    BadBlockMap loaded;
+    ASSERT_TRUE(loaded.load(map_path_, image_data_.size()));
+    EXPECT_EQ(loaded.getRanges(), map.getRanges());
+    
+    // A map written for another device is ignored
+    BadBlockMap mismatched;
+    EXPECT_FALSE(mismatched.load(map_path_, image_data_.size() * 2));
+    EXPECT_TRUE(mismatched.getRanges().empty());
+}
+
+TEST_F(BadBlockMapTest, FailedReadLosesOnlyBadSectors) {
+    DiskScanner scanner(test_image_path_, degradedConfig());
+    ASSERT_TRUE(scanner.initialize());
+    
+    // One bad sector inside a 1MB chunk
+    scanner.setReadFaultHook(failRange(300 * 1024, 300 * 1024 + 512));
+    
+    std::vector<Byte> buffer(image_data_.size());
+    ASSERT_EQ(scanner.readChunk(0, buffer.size(), buffer.data()), buffer.size());
+    EXPECT_TRUE(std::equal(buffer.begin(), buffer.begin() + 300 * 1024, image_data_.begin()));
+    EXPECT_TRUE(isZero(buffer, 300 * 1024, 300 * 1024 + 512));
+    EXPECT_TRUE(std::equal(buffer.begin() + 300 * 1024 + 512, buffer.end(),
+                           image_data_.begin() + 300 * 1024 + 512));
+    
+    DegradedReadStats stats = scanner.getDegradedStats();
+    EXPECT_EQ(stats.bad_bytes, 512u);
+    EXPECT_EQ(stats.skipped_bytes, 0u);
+    EXPECT_GT(stats.retry_reads, 0u);
+    EXPECT_TRUE(scanner.getBadBlockMap().overlaps(300 * 1024, 512));
+}
+
+TEST_F(BadBlockMapTest, ClusteredErrorsSkipAhead) {
+    DiskScanner scanner(test_image_path_, degradedConfig());
+    ASSERT_TRUE(scanner.initialize());
+    
+    // A 256KB dead zone: probing each sector would cost 512 failed reads
+    std::atomic<int> failed_reads(0);
+    scanner.setReadFaultHook(failRange(256 * 1024, 512 * 1024, &failed_reads));
+    
+    std::vector<Byte> buffer(image_data_.size());
+    ASSERT_EQ(scanner.readChunk(0, buffer.size(), buffer.data()), buffer.size());
+    EXPECT_TRUE(isZero(buffer, 256 * 1024, 512 * 1024));
+    EXPECT_TRUE(std::equal(buffer.begin() + 512 * 1024, buffer.end(), image_data_.begin() + 512 * 1024));
+    
+    DegradedReadStats stats = scanner.getDegradedStats();
+    EXPECT_GT(stats.skipped_bytes, 0u);
+    EXPECT_EQ(stats.bad_bytes + stats.skipped_bytes, 256u * 1024);
+    EXPECT_LT(failed_reads.load(), 200);
+}
+
+TEST_F(BadBlockMapTest, MapIsReusedOnNextRun) {
+    {
+        DiskScanner scanner(test_image_path_, degradedConfig());
+        ASSERT_TRUE(scanner.initialize());
+        scanner.setReadFaultHook(failRange(8192, 8192 + 1024));
+        
+        std::vector<Byte> buffer(64 * 1024);
+        ASSERT_EQ(scanner.readChunk(0, buffer.size(), buffer.data()), buffer.size());
+        ASSERT_TRUE(scanner.saveBadBlockMap());
+    }
+    ASSERT_TRUE(std::filesystem::exists(map_path_));
+    
+    // The next run never reads the known-bad range, even through a batch
+    DiskScanner scanner(test_image_path_, degradedConfig());
+    ASSERT_TRUE(scanner.initialize());
+    std::atomic<int> touched(0);
+    scanner.setReadFaultHook(failRange(8192, 8192 + 1024, &touched));
+    
+    std::vector<Byte> buffer(64 * 1024);
+    std::vector<ReadRequest> requests(1);
+    requests[0].offset = 0;
+    requests[0].size = buffer.size();
+    requests[0].buffer = buffer.data();
+    scanner.readBatch(requests, nullptr);
+    
+    EXPECT_EQ(requests[0].bytes_read, buffer.size());
+    EXPECT_EQ(touched.load(), 0);
+    EXPECT_TRUE(isZero(buffer, 8192, 8192 + 1024));
+    EXPECT_TRUE(std::equal(buffer.begin(), buffer.begin() + 8192, image_data_.begin()));
+    EXPECT_EQ(scanner.getDegradedStats().known_bad_bytes, 1024u);
+}
+
+TEST_F(BadBlockMapTest, NormalModeUnaffected) {
+    DiskScanner scanner(test_image_path_);
+    ASSERT_TRUE(scanner.initialize());
+    EXPECT_FALSE(scanner.isDegradedMode());
+    scanner.setReadFaultHook(failRange(1024, 2048));
+    
+    // Without degraded mode the read still stops at the error
+    std::vector<Byte> buffer(4096);
+    EXPECT_EQ(scanner.readChunk(0, buffer.size(), buffer.data()), 0u);
+}
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include "core/batch_recovery.h"
+#include "core/recovery_engine.h"
+#include "core/scan_scheduler.h"
+#include "utils/logger.h"
+#include "test_image_utils.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+using namespace FileRecovery;
+
+class BatchRecoveryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_data_dir_ = "test_batch_data";
+        std::filesystem::create_directories(test_data_dir_);
+        Logger::getInstance().initialize("test_batch.log", Logger::Level::DEBUG);
+
+        config_.use_metadata_recovery = false;
+        config_.num_threads = 2;
+        config_.keep_recovered_files = true;
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_data_dir_);
+        std::filesystem::remove("test_batch.log");
+    }
+
+    void writeFile(const std::string& path, const std::string& content) {
+        std::ofstream file(path);
+        file << content;
+    }
+
+    // 1MB image with one JPEG at the given offset
+    std::string createImage(const std::string& name, size_t jpeg_offset) {
+        return writeJpegImage(test_data_dir_ + "/" + name, 1024 * 1024, {jpeg_offset}, 400);
+    }
+
+    std::string test_data_dir_;
+    ScanConfig config_;
+};
+
+TEST_F(BatchRecoveryTest, ManifestSkipsCommentsAndSplitsFields) {
+    std::string path = test_data_dir_ + "/manifest.txt";
+    writeFile(path,
+              "# device  output\n"
+              "\n"
+              "/dev/sdb   out/sdb\n"
+              "  disk one.img\tout/disk one\r\n"
+              "img2.dd out2\n");
+
+    std::vector<BatchJob> jobs;
+    ASSERT_TRUE(BatchRecovery::loadManifest(path, jobs));
+    ASSERT_EQ(jobs.size(), 3u);
+    EXPECT_EQ(jobs[0].device_path, "/dev/sdb");
+    EXPECT_EQ(jobs[0].output_directory, "out/sdb");
+    EXPECT_EQ(jobs[1].device_path, "disk one.img");
+    EXPECT_EQ(jobs[1].output_directory, "out/disk one");
+    EXPECT_EQ(jobs[2].device_path, "img2.dd");
+    EXPECT_EQ(jobs[2].output_directory, "out2");
+}
+
+TEST_F(BatchRecoveryTest, ManifestRejectsMalformedLines) {
+    std::vector<BatchJob> jobs;
+    std::string path = test_data_dir_ + "/manifest.txt";
+
+    writeFile(path, "img1.dd out1\nimg2.dd\n");
+    EXPECT_FALSE(BatchRecovery::loadManifest(path, jobs));
+
+    writeFile(path, "img1.dd out1 extra\n");
+    EXPECT_FALSE(BatchRecovery::loadManifest(path, jobs));
+
+    EXPECT_FALSE(BatchRecovery::loadManifest(test_data_dir_ + "/missing.txt", jobs));
+}
+
+TEST_F(BatchRecoveryTest, IoSchedulerServesInArrivalOrder) {
+    IoScheduler io(1);
+    io.acquire();
+
+    std::mutex order_mutex;
+    std::vector<int> order;
+    auto reader = [&](int id) {
+        io.acquire();
+        {
+            std::lock_guard<std::mutex> lock(order_mutex);
+            order.push_back(id);
+        }
+        io.release();
+    };
+
+    std::thread first(reader, 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    std::thread second(reader, 2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    io.release();
+    first.join();
+    second.join();
+    EXPECT_EQ(order, (std::vector<int>{1, 2}));
+}
+
+TEST_F(BatchRecoveryTest, RunsEveryImageOnSharedWorkers) {
+    std::vector<BatchJob> jobs;
+    for (int i = 0; i < 3; ++i) {
+        BatchJob job;
+        job.device_path = createImage("disk" + std::to_string(i) + ".img", 4096 * (i + 1));
+        job.output_directory = test_data_dir_ + "/out" + std::to_string(i);
+        jobs.push_back(job);
+    }
+
+    BatchRecovery batch(config_, jobs, 2);
+    size_t reported = 0;
+    batch.setProgressCallback([&reported](const BatchResult&, size_t done, size_t total) {
+        EXPECT_EQ(total, 3u);
+        EXPECT_LE(done, total);
+        reported++;
+    });
+    ASSERT_EQ(batch.run(), RecoveryStatus::SUCCESS);
+    EXPECT_EQ(reported, 3u);
+
+    size_t total_saved = 0;
+    for (const auto& result : batch.getResults()) {
+        EXPECT_TRUE(result.started);
+        EXPECT_EQ(result.status, RecoveryStatus::SUCCESS);
+        EXPECT_GE(result.files_saved, 1u);
+        EXPECT_EQ(result.bytes_scanned, 1024u * 1024u);
+        EXPECT_FALSE(std::filesystem::is_empty(result.job.output_directory));
+        total_saved += result.files_saved;
+    }
+
+    std::string summary_path = test_data_dir_ + "/summary.tsv";
+    ASSERT_TRUE(batch.writeSummary(summary_path));
+    std::ifstream summary(summary_path);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(summary, line)) {
+        lines.push_back(line);
+    }
+    ASSERT_EQ(lines.size(), 5u);
+    EXPECT_EQ(lines[0].rfind("device\toutput\tstatus", 0), 0u);
+    EXPECT_NE(lines[1].find(jobs[0].device_path + "\t" + jobs[0].output_directory + "\tSUCCESS"),
+              std::string::npos);
+    EXPECT_EQ(lines[4].rfind("TOTAL\t\t3/3 SUCCESS\t", 0), 0u);
+    EXPECT_NE(lines[4].find("\t" + std::to_string(total_saved) + "\t"), std::string::npos);
+}
+
+TEST_F(BatchRecoveryTest, StopBeforeStartIsNotLost) {
+    // BatchRecovery::stop() can reach an engine after runJob registered it
+    // but before startRecovery() runs; the image must not then be scanned
+    config_.device_path = createImage("disk.img", 4096);
+    config_.output_directory = test_data_dir_ + "/out";
+    config_.checkpoint_path = config_.output_directory + "/.filerec.checkpoint";
+    RecoveryEngine engine(config_);
+    engine.stopRecovery();
+    engine.startRecovery();
+
+    EXPECT_EQ(engine.getRecoveredFileCount(), 0u);
+    EXPECT_EQ(engine.getPipelineStats().bytes_read, 0u);
+    // Nothing was scanned, so --resume starts the image from the beginning
+    EXPECT_TRUE(std::filesystem::exists(config_.checkpoint_path));
+}
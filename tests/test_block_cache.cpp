@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include "core/block_cache.h"
+#include "core/disk_scanner.h"
+#include "utils/logger.h"
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <atomic>
+
+using namespace FileRecovery;
+
+class BlockCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_data_dir_ = "test_block_cache_data";
+        std::filesystem::create_directories(test_data_dir_);
+
+        // 1MB + 100 bytes so the last block is partial
+        test_image_path_ = test_data_dir_ + "/test_disk.img";
+        image_data_.resize(1024 * 1024 + 100);
+        for (size_t i = 0; i < image_data_.size(); ++i) {
+            image_data_[i] = static_cast<Byte>((i * 31 + i / 4096) & 0xFF);
+        }
+        std::ofstream img_file(test_image_path_, std::ios::binary);
+        img_file.write(reinterpret_cast<const char*>(image_data_.data()), image_data_.size());
+        img_file.close();
+
+        Logger::getInstance().initialize("test_block_cache.log", Logger::Level::DEBUG);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_data_dir_);
+        std::filesystem::remove("test_block_cache.log");
+    }
+
+    ScanConfig cacheConfig(Size cache_size, Size block_size) {
+        ScanConfig config;
+        config.cache_size = cache_size;
+        config.cache_block_size = block_size;
+        return config;
+    }
+
+    std::string test_data_dir_;
+    std::string test_image_path_;
+    std::vector<Byte> image_data_;
+};
+
+TEST_F(BlockCacheTest, LookupInsertAndLruEviction) {
+    // One shard holding two 16-byte blocks
+    BlockCache cache(16, 32, 1);
+    std::vector<Byte> block(16);
+    Byte out[16];
+
+    EXPECT_FALSE(cache.lookup(0, 0, 16, out));
+
+    for (uint64_t b = 0; b < 2; ++b) {
+        std::fill(block.begin(), block.end(), static_cast<Byte>(b + 1));
+        cache.insert(b, block.data(), block.size());
+    }
+
+    ASSERT_TRUE(cache.lookup(0, 4, 8, out));
+    EXPECT_EQ(out[0], 1);
+
+    // Block 1 is now least recently used and is evicted by block 2
+    std::fill(block.begin(), block.end(), 3);
+    cache.insert(2, block.data(), block.size());
+    EXPECT_TRUE(cache.contains(0));
+    EXPECT_FALSE(cache.contains(1));
+    EXPECT_TRUE(cache.contains(2));
+
+    BlockCacheStats stats = cache.getStats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.evictions, 1u);
+    EXPECT_EQ(stats.bytes_cached, 32u);
+    EXPECT_DOUBLE_EQ(stats.hitRatio(), 0.5);
+}
+
+TEST_F(BlockCacheTest, CachedReadsMatchDevice) {
+    DiskScanner scanner(test_image_path_, cacheConfig(256 * 1024, 4096));
+    ASSERT_TRUE(scanner.initialize());
+    ASSERT_TRUE(scanner.hasBlockCache());
+
+    // Unaligned reads spanning blocks, and one running past the device end
+    std::vector<std::pair<Offset, Size>> reads = {
+        {0, 100}, {4000, 200}, {10000, 20000}, {image_data_.size() - 50, 200}
+    };
+
+    for (int pass = 0; pass < 2; ++pass) {
+        for (const auto& read : reads) {
+            std::vector<Byte> buffer(read.second, 0);
+            Size expected = std::min<Size>(read.second, image_data_.size() - read.first);
+            ASSERT_EQ(scanner.readCached(read.first, read.second, buffer.data()), expected);
+            EXPECT_TRUE(std::equal(buffer.begin(), buffer.begin() + expected,
+                                   image_data_.begin() + read.first));
+        }
+    }
+
+    // The second pass is served entirely from memory
+    BlockCacheStats stats = scanner.getCacheStats();
+    EXPECT_GT(stats.misses, 0u);
+    EXPECT_GE(stats.hits, stats.misses);
+    EXPECT_FALSE(stats.describe(scanner.getCacheBlockSize()).empty());
+}
+
+TEST_F(BlockCacheTest, LargeReadsBypassCache) {
+    DiskScanner scanner(test_image_path_, cacheConfig(64 * 1024, 4096));
+    ASSERT_TRUE(scanner.initialize());
+
+    std::vector<Byte> buffer(512 * 1024);
+    EXPECT_EQ(scanner.readCached(0, buffer.size(), buffer.data()), buffer.size());
+    EXPECT_EQ(scanner.getCacheStats().misses, 0u);
+    EXPECT_EQ(scanner.getCacheStats().bytes_cached, 0u);
+
+    ScanConfig disabled = cacheConfig(0, 4096);
+    DiskScanner uncached(test_image_path_, disabled);
+    ASSERT_TRUE(uncached.initialize());
+    EXPECT_FALSE(uncached.hasBlockCache());
+    EXPECT_EQ(uncached.readCached(100, 100, buffer.data()), 100u);
+}
+
+TEST_F(BlockCacheTest, ShortReadEndingBeforeOffset) {
+    DiskScanner scanner(test_image_path_, cacheConfig(256 * 1024, 4096));
+    ASSERT_TRUE(scanner.initialize());
+
+    // The image shrinks under the scanner: the block holding the request
+    // now reads back only 100 bytes, all before the requested offset
+    std::filesystem::resize_file(test_image_path_, 2 * 4096 + 100);
+    std::vector<Byte> buffer(100, 0);
+    EXPECT_EQ(scanner.readCached(2 * 4096 + 2000, buffer.size(), buffer.data()), 0u);
+
+    // The bytes that are still there are served as before
+    EXPECT_EQ(scanner.readCached(2 * 4096, buffer.size(), buffer.data()), buffer.size());
+    EXPECT_TRUE(std::equal(buffer.begin(), buffer.end(), image_data_.begin() + 2 * 4096));
+}
+
+TEST_F(BlockCacheTest, ConcurrentCachedReads) {
+    DiskScanner scanner(test_image_path_, cacheConfig(128 * 1024, 4096));
+    ASSERT_TRUE(scanner.initialize());
+
+    std::atomic<int> mismatches(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            std::vector<Byte> buffer(3000);
+            for (int i = 0; i < 200; ++i) {
+                Offset offset = ((i * 7 + t * 13) % 100) * 3001;
+                scanner.readCached(offset, buffer.size(), buffer.data());
+                if (!std::equal(buffer.begin(), buffer.end(), image_data_.begin() + offset)) {
+                    mismatches++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(mismatches, 0);
+    EXPECT_GT(scanner.getCacheStats().hits, 0u);
+}
@@ -3,6 +3,7 @@
 #include "carvers/pdf_carver.h"
 #include "carvers/png_carver.h"
 #include "carvers/zip_carver.h"
+#include "core/carver_registry.h"
 #include "utils/logger.h"
 #include <vector>
 #include <chrono>
@@ -105,4 +106,74 @@ TEST_F(CarverPerformanceTest, PdfCarverPerformance) {
     
     // Performance should be reasonable (adjust based on your hardware)
     EXPECT_LE(duration.count(), 5000); // Should take less than 5 seconds
-}
\ No newline at end of file
+}
+
+TEST_F(CarverPerformanceTest, SharedHeaderSearchVsPerCarverSearch) {
+    std::vector<FileCarver*> carvers = {jpeg_carver_.get(), pdf_carver_.get(), png_carver_.get(), zip_carver_.get()};
+    ScanPlan plan;
+    for (FileCarver* carver : carvers) {
+        plan.addCarver(carver->getSupportedTypes()[0], *carver);
+    }
+    
+    // Per-carver path: every carver searches for each of its own signatures
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::vector<RecoveredFile>> per_carver;
+    for (FileCarver* carver : carvers) {
+        per_carver.push_back(carver->carveFiles(large_data_.data(), large_data_.size(), 0));
+    }
+    auto per_carver_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    
+    // Shared path: one pass finds every header and footer, carvers only visit their hits
+    start = std::chrono::high_resolution_clock::now();
+    std::vector<SignatureHits> hits;
+    plan.findSignatures(large_data_.data(), large_data_.size(), hits);
+    auto search_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    std::vector<std::vector<RecoveredFile>> shared;
+    for (size_t i = 0; i < carvers.size(); ++i) {
+        shared.push_back(carvers[i]->carveFilesAt(large_data_.data(), large_data_.size(), 0, hits[i]));
+    }
+    auto shared_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    
+    std::cout << "Per-carver search took " << per_carver_ms << "ms, shared search " << shared_ms
+              << "ms (signature pass " << search_ms << "ms) for 10MB data" << std::endl;
+    
+    // Both paths recover the same files
+    for (size_t i = 0; i < carvers.size(); ++i) {
+        ASSERT_EQ(shared[i].size(), per_carver[i].size()) << plan.getStages()[i].name;
+        for (size_t j = 0; j < shared[i].size(); ++j) {
+            EXPECT_EQ(shared[i][j].start_offset, per_carver[i][j].start_offset);
+            EXPECT_EQ(shared[i][j].file_size, per_carver[i][j].file_size);
+        }
+    }
+    EXPECT_GE(hits[0].headers.size(), 10u);
+    EXPECT_LE(shared_ms, 5000);
+}
+
+TEST_F(CarverPerformanceTest, ManyHeadersFindTheirEndsByLookup) {
+    // A JPEG header every 4KB of a 16MB buffer and one end marker at the
+    // end: scanning from each header for its end would read 2GB
+    std::vector<uint8_t> data(16 * 1024 * 1024, 0x11);
+    const size_t stride = 4096;
+    for (size_t offset = 0; offset + stride <= data.size(); offset += stride) {
+        std::copy(jpeg_signatures_.begin(), jpeg_signatures_.end(), data.begin() + offset);
+    }
+    data[data.size() - 2] = 0xFF;
+    data[data.size() - 1] = 0xD9;
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    auto results = jpeg_carver_->carveFiles(data.data(), data.size(), 0);
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - start);
+    
+    std::cout << "JPEG carver took " << duration.count() << "ms for " << data.size() / stride
+              << " headers sharing one end marker" << std::endl;
+    
+    // Every JPEG the carver kept ends at the single end marker
+    for (const auto& file : results) {
+        EXPECT_EQ(file.start_offset + file.file_size, data.size());
+    }
+    EXPECT_LE(duration.count(), 2000);
+}
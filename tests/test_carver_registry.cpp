@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+#include "carvers/base_carver.h"
+#include "core/carver_registry.h"
+#include "core/recovery_engine.h"
+#include "utils/logger.h"
+#include "test_image_utils.h"
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <type_traits>
+
+using namespace FileRecovery;
+
+namespace {
+
+// Magic of the made-up format the test carver recovers
+const std::vector<Byte> TEST_MAGIC = {'T', 'S', 'T', 'F', 'M', 'T', '0', '1'};
+
+// Recovers a fixed-size file at every TEST_MAGIC and counts its calls
+class MagicCarver : public FileCarver {
+public:
+    explicit MagicCarver(std::atomic<size_t>* calls = nullptr) : calls_(calls) {}
+
+    std::vector<std::string> getSupportedTypes() const override { return {"tstfmt"}; }
+    std::vector<std::vector<Byte>> getFileSignatures() const override { return {TEST_MAGIC}; }
+    std::vector<std::vector<Byte>> getFileFooters() const override { return {}; }
+    Size getMaxFileSize() const override { return 4096; }
+    double validateFile(const RecoveredFile&, const Byte*) override { return 1.0; }
+
+    std::vector<RecoveredFile> carveFiles(const Byte* data, Size size, Offset base_offset) override {
+        if (calls_) {
+            (*calls_)++;
+        }
+        std::vector<RecoveredFile> files;
+        const Byte* match = data;
+        while ((match = std::search(match, data + size, TEST_MAGIC.begin(), TEST_MAGIC.end())) != data + size) {
+            RecoveredFile file;
+            file.start_offset = base_offset + (match - data);
+            file.file_size = std::min<Size>(512, size - (match - data));
+            file.file_type = "TSTFMT";
+            file.confidence_score = 1.0;
+            file.filename = "recovered_" + std::to_string(file.start_offset) + ".tst";
+            files.push_back(file);
+            ++match;
+        }
+        return files;
+    }
+
+private:
+    std::atomic<size_t>* calls_;
+};
+
+// A BaseCarver that forgets carveFilesAt() must not compile into an
+// instance, since carveFiles() and the FileCarver default call each other
+class IncompleteCarver : public BaseCarver {
+public:
+    std::vector<std::string> getSupportedTypes() const override { return {"none"}; }
+    std::vector<std::vector<Byte>> getFileSignatures() const override { return {}; }
+    std::vector<std::vector<Byte>> getFileFooters() const override { return {}; }
+    Size getMaxFileSize() const override { return 0; }
+    double validateFile(const RecoveredFile&, const Byte*) override { return 0.0; }
+};
+static_assert(std::is_abstract<IncompleteCarver>::value, "BaseCarver requires carveFilesAt()");
+
+} // namespace
+
+class CarverRegistryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_data_dir_ = "test_registry_data";
+        std::filesystem::create_directories(test_data_dir_);
+        Logger::getInstance().initialize("test_registry.log", Logger::Level::DEBUG);
+
+        // 2MB image with one JPEG and one test-format file
+        config_.device_path = test_data_dir_ + "/disk.img";
+        config_.output_directory = test_data_dir_ + "/output";
+        config_.use_metadata_recovery = false;
+        config_.num_threads = 1;
+        config_.keep_recovered_files = true;
+
+        std::vector<Byte> data = makeJpegImage(2 * 1024 * 1024, {4096}, 400);
+        std::copy(TEST_MAGIC.begin(), TEST_MAGIC.end(), data.begin() + 1024 * 1024);
+        writeImage(config_.device_path, data);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_data_dir_);
+        std::filesystem::remove("test_registry.log");
+    }
+
+    std::vector<std::string> recoveredTypes(RecoveryEngine& engine) {
+        std::vector<std::string> types;
+        for (const auto& file : engine.getRecoveredFiles()) {
+            types.push_back(file.file_type);
+        }
+        return types;
+    }
+
+    std::string test_data_dir_;
+    ScanConfig config_;
+};
+
+TEST_F(CarverRegistryTest, PlanHoldsOnlyRequestedCarvers) {
+    CarverRegistry& registry = CarverRegistry::instance();
+    std::vector<std::string> types = registry.getSupportedTypes();
+    EXPECT_NE(std::find(types.begin(), types.end(), "JPG"), types.end());
+    EXPECT_NE(std::find(types.begin(), types.end(), "DOCX"), types.end());
+
+    ScanPlan jpeg = registry.createPlan({"jpg"});
+    ASSERT_EQ(jpeg.getStages().size(), 1u);
+    EXPECT_EQ(jpeg.getStages()[0].name, "jpeg");
+    EXPECT_FALSE(jpeg.getStages()[0].signatures.empty());
+    EXPECT_FALSE(jpeg.getStages()[0].footers.empty());
+
+    // A carver serving several requested types runs once
+    std::vector<std::string> unknown;
+    ScanPlan mixed = registry.createPlan({"JPEG", "jpg", "docx", "bogus"}, &unknown);
+    ASSERT_EQ(mixed.getStages().size(), 2u);
+    EXPECT_EQ(mixed.getStages()[0].name, "jpeg");
+    EXPECT_EQ(mixed.getStages()[1].name, "zip");
+    EXPECT_EQ(unknown, std::vector<std::string>{"bogus"});
+
+    ScanPlan all = registry.createPlan({});
+    EXPECT_GE(all.getStages().size(), 4u);
+    EXPECT_TRUE(registry.createPlan({"bogus"}).empty());
+}
+
+TEST_F(CarverRegistryTest, RegisteredCarverRunsWhenRequested) {
+    static bool registered = CarverRegistry::instance().registerCarver(
+        "tstfmt", []() { return std::make_unique<MagicCarver>(); });
+    ASSERT_TRUE(registered);
+    EXPECT_FALSE(CarverRegistry::instance().registerCarver(
+        "tstfmt", []() { return std::make_unique<MagicCarver>(); }));
+
+    config_.target_file_types = {"TSTFMT"};
+    RecoveryEngine only_test(config_);
+    ASSERT_EQ(only_test.startRecovery(), RecoveryStatus::SUCCESS);
+    EXPECT_EQ(recoveredTypes(only_test), std::vector<std::string>{"TSTFMT"});
+
+    std::filesystem::remove_all(config_.output_directory);
+    config_.target_file_types = {"jpg"};
+    RecoveryEngine only_jpeg(config_);
+    ASSERT_EQ(only_jpeg.startRecovery(), RecoveryStatus::SUCCESS);
+    EXPECT_EQ(recoveredTypes(only_jpeg), std::vector<std::string>{"JPEG"});
+}
+
+TEST_F(CarverRegistryTest, UnrequestedCarversDoNoWork) {
+    std::atomic<size_t> calls(0);
+
+    config_.target_file_types = {"jpg"};
+    RecoveryEngine jpeg_only(config_);
+    jpeg_only.addFileCarver(std::make_unique<MagicCarver>(&calls));
+    ASSERT_EQ(jpeg_only.startRecovery(), RecoveryStatus::SUCCESS);
+    EXPECT_EQ(calls, 0u);
+
+    std::filesystem::remove_all(config_.output_directory);
+    config_.target_file_types = {"tstfmt"};
+    RecoveryEngine custom(config_);
+    custom.addFileCarver(std::make_unique<MagicCarver>(&calls));
+    ASSERT_EQ(custom.startRecovery(), RecoveryStatus::SUCCESS);
+    EXPECT_GT(calls, 0u);
+
+    // Nothing can carve an unknown type
+    config_.target_file_types = {"bogus"};
+    RecoveryEngine bogus(config_);
+    EXPECT_EQ(bogus.startRecovery(), RecoveryStatus::FAILED);
+}
+
+TEST_F(CarverRegistryTest, PlanIndexesFootersInTheSignaturePass) {
+    MagicCarver magic;
+    ScanPlan plan = CarverRegistry::instance().createPlan({"jpg", "pdf"});
+    plan.addCarver("tstfmt", magic);
+    ASSERT_EQ(plan.getStages().size(), 3u);
+
+    // JPEG 100..302, PDF from 1000 with two of its footer variants ending
+    // at 1506 and a third ending at 2005, test format at 3000
+    std::vector<Byte> data(4096, 0);
+    auto put = [&data](Offset offset, const std::string& text) {
+        std::copy(text.begin(), text.end(), data.begin() + offset);
+    };
+    put(100, "\xFF\xD8\xFF\xE0");
+    put(300, "\xFF\xD9");
+    put(1000, "%PDF-1.4");
+    put(1500, "\n%%EOF");
+    put(2000, "%%EOF");
+    std::copy(TEST_MAGIC.begin(), TEST_MAGIC.end(), data.begin() + 3000);
+
+    std::vector<SignatureHits> hits;
+    plan.findSignatures(data.data(), data.size(), hits);
+    ASSERT_EQ(hits.size(), 3u);
+    EXPECT_EQ(hits[0].headers, std::vector<Offset>{100});
+    EXPECT_EQ(hits[0].footer_ends, std::vector<Offset>{302});
+    EXPECT_EQ(hits[1].headers, std::vector<Offset>{1000});
+    EXPECT_EQ(hits[1].footer_ends, (std::vector<Offset>{1506, 2005}));
+    EXPECT_EQ(hits[2].headers, std::vector<Offset>{3000});
+    EXPECT_TRUE(hits[2].footer_ends.empty());
+
+    // Aligned scans find the same footers, which may end anywhere
+    std::vector<SignatureHits> aligned;
+    plan.findAlignedSignatures(data.data(), data.size(), 0, 100, aligned);
+    ASSERT_EQ(aligned.size(), 3u);
+    for (size_t i = 0; i < hits.size(); ++i) {
+        EXPECT_EQ(aligned[i].headers, hits[i].headers) << i;
+        EXPECT_EQ(aligned[i].footer_ends, hits[i].footer_ends) << i;
+    }
+
+    // No aligned header, so the footer pass is skipped
+    plan.findAlignedSignatures(data.data(), data.size(), 0, 64, aligned);
+    for (const auto& stage_hits : aligned) {
+        EXPECT_TRUE(stage_hits.headers.empty());
+        EXPECT_TRUE(stage_hits.footer_ends.empty());
+    }
+}
@@ -1,9 +1,17 @@
 #include <gtest/gtest.h>
 #include "core/disk_scanner.h"
+#include "core/read_ahead_pipeline.h"
 #include "utils/logger.h"
 #include <fstream>
 #include <filesystem>
 #include <thread>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <fcntl.h>
+#include <unistd.h>
 
 using namespace FileRecovery;
 
@@ -233,3 +241,362 @@ TEST_F(DiskScannerTest, ReinitializeScanner) {
     EXPECT_TRUE(scanner_->initialize());
     EXPECT_TRUE(scanner_->isReady());
 }
+
+TEST_F(DiskScannerTest, ConcurrentReadThroughputScaling) {
+    // Build a larger image with a position-dependent pattern so every
+    // concurrent read can be verified independently
+    const Size image_size = 32 * 1024 * 1024;
+    const Size chunk_size = 256 * 1024;
+    std::string image_path = test_data_dir_ + "/throughput.img";
+    {
+        std::vector<uint8_t> data(image_size);
+        for (Size i = 0; i < image_size; ++i) {
+            data[i] = static_cast<uint8_t>((i * 131) ^ (i >> 12));
+        }
+        std::ofstream img(image_path, std::ios::binary);
+        img.write(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+    
+    DiskScanner scanner(image_path);
+    ASSERT_TRUE(scanner.initialize());
+    
+    const size_t num_chunks = image_size / chunk_size;
+    const int passes = 4;
+    double single_thread_mbps = 0.0;
+    
+    for (int num_threads : {1, 2, 4, 8}) {
+        std::atomic<size_t> next_chunk(0);
+        std::atomic<size_t> corrupted(0);
+        std::atomic<Size> total_bytes(0);
+        
+        auto start = std::chrono::high_resolution_clock::now();
+        
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; ++t) {
+            threads.emplace_back([&]() {
+                std::vector<uint8_t> buffer(chunk_size);
+                size_t i;
+                while ((i = next_chunk++) < num_chunks * passes) {
+                    Offset offset = (i % num_chunks) * chunk_size;
+                    Size bytes_read = scanner.readChunk(offset, chunk_size, buffer.data());
+                    total_bytes += bytes_read;
+                    
+                    for (Size j = 0; j < bytes_read; j += 4096) {
+                        Size pos = offset + j;
+                        if (buffer[j] != static_cast<uint8_t>((pos * 131) ^ (pos >> 12))) {
+                            corrupted++;
+                            break;
+                        }
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        
+        auto end = std::chrono::high_resolution_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+        double mbps = (total_bytes.load() / (1024.0 * 1024.0)) / std::max(seconds, 1e-9);
+        if (num_threads == 1) {
+            single_thread_mbps = mbps;
+        }
+        
+        std::cout << "readChunk with " << num_threads << " thread(s): " << mbps << " MB/s ("
+                  << (mbps / std::max(single_thread_mbps, 1e-9)) << "x single-thread)" << std::endl;
+        
+        EXPECT_EQ(total_bytes.load(), image_size * passes);
+        EXPECT_EQ(corrupted.load(), 0u);
+    }
+}
+
+TEST_F(DiskScannerTest, BatchReadBackends) {
+    for (IoBackendType backend : {IoBackendType::SYNC, IoBackendType::IO_URING}) {
+        ScanConfig config;
+        config.io_backend = backend;
+        config.io_queue_depth = 4;
+        
+        DiskScanner scanner(test_image_path_, config);
+        ASSERT_TRUE(scanner.initialize());
+        
+        // 12 requests through a depth-4 ring, the last one running past the end
+        const Size chunk_size = 96 * 1024;
+        std::vector<std::vector<Byte>> buffers(12, std::vector<Byte>(chunk_size, 0xAA));
+        std::vector<ReadRequest> requests(buffers.size());
+        for (size_t i = 0; i < requests.size(); ++i) {
+            requests[i].offset = i * chunk_size;
+            requests[i].size = chunk_size;
+            requests[i].buffer = buffers[i].data();
+            requests[i].tag = i;
+        }
+        
+        std::vector<int> completions(requests.size(), 0);
+        scanner.readBatch(requests, [&completions](ReadRequest& request) {
+            completions[request.tag]++;
+        });
+        
+        Size total = 0;
+        for (size_t i = 0; i < requests.size(); ++i) {
+            EXPECT_EQ(completions[i], 1) << scanner.getIoBackendName() << " request " << i;
+            EXPECT_EQ(requests[i].error, 0);
+            total += requests[i].bytes_read;
+        }
+        EXPECT_EQ(total, scanner.getDeviceSize()) << scanner.getIoBackendName();
+        
+        // Signatures written by the fixture must land in the right buffers
+        EXPECT_EQ(buffers[1000 / chunk_size][1000 % chunk_size], 0xFF);
+        EXPECT_EQ(buffers[5000 / chunk_size][5000 % chunk_size], 0x25);
+        EXPECT_EQ(buffers[10000 / chunk_size][10000 % chunk_size], 0x89);
+    }
+}
+
+TEST_F(DiskScannerTest, DirectIoReads) {
+    // Odd-sized image so the device tail is not block aligned
+    const Size image_size = 3 * 1024 * 1024 + 777;
+    std::string image_path = test_data_dir_ + "/direct.img";
+    std::vector<uint8_t> expected(image_size);
+    for (Size i = 0; i < image_size; ++i) {
+        expected[i] = static_cast<uint8_t>((i * 7) ^ (i >> 9));
+    }
+    {
+        std::ofstream img(image_path, std::ios::binary);
+        img.write(reinterpret_cast<const char*>(expected.data()), expected.size());
+    }
+    
+    ScanConfig config;
+    config.direct_io = true;
+    DiskScanner scanner(image_path, config);
+    ASSERT_TRUE(scanner.initialize());
+    std::cout << "Direct I/O " << (scanner.isDirectIo() ? "active" : "unsupported here, buffered fallback") << std::endl;
+    
+    // Aligned read into a pooled buffer, unaligned edges, and the device tail
+    const std::vector<std::pair<Offset, Size>> reads = {
+        {0, 1024 * 1024},
+        {4096, 64 * 1024},
+        {1000, 5000},
+        {4095, 2},
+        {1024 * 1024 - 10, 2 * 1024 * 1024 + 20},
+        {image_size - 5000, 8192},
+    };
+    
+    for (const auto& read : reads) {
+        auto buffer = scanner.acquireBuffer(read.second);
+        ASSERT_TRUE(buffer);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer.data()) % BLOCK_SIZE_4K, 0u);
+        
+        Size expected_size = std::min(read.second, image_size - read.first);
+        Size bytes_read = scanner.readChunk(read.first, read.second, buffer.data());
+        ASSERT_EQ(bytes_read, expected_size) << "offset " << read.first;
+        EXPECT_TRUE(std::equal(buffer.data(), buffer.data() + bytes_read, expected.begin() + read.first))
+            << "offset " << read.first;
+    }
+    
+    // Released buffers are handed out again rather than reallocated
+    AlignedBufferPool pool;
+    Byte* first = nullptr;
+    {
+        auto buffer = pool.acquire(64 * 1024);
+        first = buffer.data();
+    }
+    auto again = pool.acquire(32 * 1024);
+    EXPECT_EQ(again.data(), first);
+    EXPECT_EQ(pool.getReuseCount(), 1u);
+}
+
+TEST_F(DiskScannerTest, MappedView) {
+    ScanConfig config;
+    config.use_mmap = true;
+    DiskScanner scanner(test_image_path_, config);
+    ASSERT_TRUE(scanner.initialize());
+    ASSERT_TRUE(scanner.hasMappedView());
+    
+    // Views are zero-copy pointers into one mapping
+    const Byte* jpeg = scanner.getMappedView(1000, 4);
+    ASSERT_NE(jpeg, nullptr);
+    EXPECT_EQ(jpeg[0], 0xFF);
+    EXPECT_EQ(jpeg[1], 0xD8);
+    EXPECT_EQ(scanner.getMappedView(5000, 5) - jpeg, 4000);
+    EXPECT_EQ(scanner.getMappedView(scanner.getDeviceSize() - 10, 11), nullptr);
+    
+    // mapRegion reuses the whole-device mapping; unmapRegion leaves it alone
+    const Byte* region = scanner.mapRegion(10000, 8);
+    EXPECT_EQ(region, scanner.getMappedView(10000, 8));
+    scanner.unmapRegion(region, 8);
+    EXPECT_EQ(region[0], 0x89);
+    
+    // Sliding the advice window must not invalidate the mapping
+    scanner.adviseMappedWindow(512 * 1024, 768 * 1024);
+    scanner.adviseMappedWindow(scanner.getDeviceSize(), scanner.getDeviceSize());
+    EXPECT_EQ(scanner.getMappedView(1000, 4)[0], 0xFF);
+}
+
+TEST_F(DiskScannerTest, ReadAheadPipeline) {
+    ASSERT_TRUE(scanner_->initialize());
+    
+    const Size chunk_size = 64 * 1024;
+    std::vector<std::pair<Offset, Size>> ranges;
+    for (Offset offset = 0; offset < scanner_->getDeviceSize(); offset += chunk_size) {
+        ranges.emplace_back(offset, chunk_size);
+    }
+    
+    // A small ring forces the reader to wait for slots to be released
+    ReadAheadPipeline pipeline(*scanner_, 3, 2);
+    ASSERT_TRUE(pipeline.start(ranges, chunk_size, 2));
+    
+    std::mutex seen_mutex;
+    std::set<Offset> seen;
+    std::atomic<bool> jpeg_found(false);
+    
+    auto consumer = [&]() {
+        ReadAheadPipeline::Chunk chunk;
+        while (pipeline.next(chunk)) {
+            EXPECT_EQ(chunk.error, 0);
+            EXPECT_EQ(chunk.size, chunk_size);
+            if (chunk.offset == 0 && chunk.data[1000] == 0xFF && chunk.data[1001] == 0xD8) {
+                jpeg_found = true;
+            }
+            {
+                std::lock_guard<std::mutex> lock(seen_mutex);
+                EXPECT_TRUE(seen.insert(chunk.offset).second);
+            }
+            pipeline.release(chunk);
+        }
+    };
+    
+    std::thread first(consumer);
+    std::thread second(consumer);
+    first.join();
+    second.join();
+    pipeline.join();
+    
+    EXPECT_EQ(seen.size(), ranges.size());
+    EXPECT_TRUE(jpeg_found);
+    
+    PipelineStats stats = pipeline.getStats();
+    EXPECT_EQ(stats.chunks_read, ranges.size());
+    EXPECT_EQ(stats.bytes_read, scanner_->getDeviceSize());
+    EXPECT_EQ(stats.ring_slots, 3u);
+    EXPECT_FALSE(stats.describe().empty());
+}
+
+TEST_F(DiskScannerTest, ReadAheadPipelineLanes) {
+    ASSERT_TRUE(scanner_->initialize());
+    
+    const Size chunk_size = 64 * 1024;
+    std::vector<std::pair<Offset, Size>> ranges;
+    for (Offset offset = 0; offset < scanner_->getDeviceSize(); offset += chunk_size) {
+        ranges.emplace_back(offset, chunk_size);
+    }
+    
+    // Two contiguous lanes, as a NUMA-aware scan on two nodes would use
+    std::vector<PipelineLane> lanes(2);
+    lanes[0].range_count = 5;
+    lanes[0].slots = 2;
+    lanes[0].numa_node = 0;
+    lanes[1].first_range = 5;
+    lanes[1].range_count = ranges.size() - 5;
+    lanes[1].slots = 2;
+    
+    ReadAheadPipeline pipeline(*scanner_, 1, 2);
+    ASSERT_TRUE(pipeline.start(ranges, chunk_size, 2, lanes));
+    
+    std::vector<std::vector<Offset>> seen(2);
+    auto consumer = [&](size_t lane) {
+        ReadAheadPipeline::Chunk chunk;
+        while (pipeline.next(chunk, lane)) {
+            EXPECT_EQ(chunk.error, 0);
+            seen[lane].push_back(chunk.offset);
+            pipeline.release(chunk);
+        }
+    };
+    
+    std::thread first(consumer, 0);
+    std::thread second(consumer, 1);
+    first.join();
+    second.join();
+    pipeline.join();
+    
+    // Each lane got exactly its own ranges, in order
+    ASSERT_EQ(seen[0].size(), 5u);
+    ASSERT_EQ(seen[1].size(), ranges.size() - 5);
+    for (size_t i = 0; i < seen[0].size(); ++i) {
+        EXPECT_EQ(seen[0][i], ranges[i].first);
+    }
+    for (size_t i = 0; i < seen[1].size(); ++i) {
+        EXPECT_EQ(seen[1][i], ranges[5 + i].first);
+    }
+    EXPECT_EQ(pipeline.getStats().ring_slots, 4u);
+}
+
+TEST_F(DiskScannerTest, SparseDataExtents) {
+    // 8MB sparse file with data only at 1MB and 6MB
+    std::string sparse_path = test_data_dir_ + "/sparse.img";
+    int fd = open(sparse_path.c_str(), O_CREAT | O_WRONLY | O_TRUNC, 0644);
+    ASSERT_GE(fd, 0);
+    std::vector<Byte> data(64 * 1024, 0xAB);
+    ASSERT_EQ(pwrite(fd, data.data(), data.size(), 1024 * 1024), static_cast<ssize_t>(data.size()));
+    ASSERT_EQ(pwrite(fd, data.data(), data.size(), 6 * 1024 * 1024), static_cast<ssize_t>(data.size()));
+    ASSERT_EQ(ftruncate(fd, 8 * 1024 * 1024), 0);
+    close(fd);
+    
+    DiskScanner scanner(sparse_path);
+    ASSERT_TRUE(scanner.initialize());
+    auto extents = scanner.getDataExtents();
+    ASSERT_FALSE(extents.empty());
+    
+    // Extents are ordered, inside the device, and cover every written byte
+    Size covered = 0;
+    Offset previous_end = 0;
+    for (const auto& extent : extents) {
+        EXPECT_GE(extent.first, previous_end);
+        previous_end = extent.first + extent.second;
+        EXPECT_LE(previous_end, scanner.getDeviceSize());
+        covered += extent.second;
+    }
+    auto covers = [&extents](Offset offset) {
+        for (const auto& extent : extents) {
+            if (offset >= extent.first && offset < extent.first + extent.second) {
+                return true;
+            }
+        }
+        return false;
+    };
+    EXPECT_TRUE(covers(1024 * 1024));
+    EXPECT_TRUE(covers(6 * 1024 * 1024 + data.size() - 1));
+    
+    // Filesystems without hole reporting return the whole file instead
+    if (extents.size() > 1) {
+        EXPECT_LT(covered, scanner.getDeviceSize());
+    } else {
+        std::cout << "Filesystem does not report holes; sparse skipping not exercised" << std::endl;
+    }
+}
+
+TEST_F(DiskScannerTest, CopyToFd) {
+    ASSERT_TRUE(scanner_->initialize());
+    
+    std::vector<Byte> expected(300 * 1024);
+    ASSERT_EQ(scanner_->readChunk(1000, expected.size(), expected.data()), expected.size());
+    
+    std::string out_path = test_data_dir_ + "/copy.bin";
+    int out_fd = open(out_path.c_str(), O_CREAT | O_WRONLY | O_TRUNC, 0644);
+    ASSERT_GE(out_fd, 0);
+    EXPECT_EQ(scanner_->copyToFd(1000, expected.size(), out_fd), expected.size());
+    close(out_fd);
+    
+    std::ifstream in(out_path, std::ios::binary);
+    std::vector<Byte> copied((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(copied, expected);
+    
+    // Every byte is accounted to exactly one copy method
+    CopyStats stats = scanner_->getCopyStats();
+    EXPECT_EQ(stats.copy_file_range_bytes + stats.sendfile_bytes + stats.buffered_bytes, expected.size());
+    
+    // Fault injection forces the buffered path
+    scanner_->setReadFaultHook([](Offset, Size) { return false; });
+    out_fd = open(out_path.c_str(), O_CREAT | O_WRONLY | O_TRUNC, 0644);
+    ASSERT_GE(out_fd, 0);
+    EXPECT_EQ(scanner_->copyToFd(1000, 4096, out_fd), 4096u);
+    close(out_fd);
+    EXPECT_EQ(scanner_->getCopyStats().buffered_bytes, stats.buffered_bytes + 4096);
+}
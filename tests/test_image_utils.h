@@ -0,0 +1,55 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "utils/types.h"
+
+// Disk images with small JPEGs at known offsets, shared by the engine tests
+
+/**
+ * @brief Build an image of zeros with a JFIF JPEG at each offset
+ * @param size Image size
+ * @param offsets Where the JPEGs start
+ * @param payload Bytes between each JPEG's header and its end marker
+ * @return Image data
+ *
+ * The payload bytes are never 0x00 or 0xFF and depend on the offset, so
+ * no two JPEGs are the same and none ends early.
+ */
+inline std::vector<FileRecovery::Byte> makeJpegImage(FileRecovery::Size size,
+                                                     const std::vector<FileRecovery::Offset>& offsets,
+                                                     FileRecovery::Size payload) {
+    using FileRecovery::Byte;
+    std::vector<Byte> data(size, 0);
+    for (FileRecovery::Offset offset : offsets) {
+        std::vector<Byte> jpeg = {0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x10, 'J', 'F', 'I', 'F', 0x00};
+        for (FileRecovery::Size i = 0; i < payload; ++i) {
+            jpeg.push_back(static_cast<Byte>((offset / 4096 + i) % 200 + 1));
+        }
+        jpeg.push_back(0xFF);
+        jpeg.push_back(0xD9);
+        std::copy(jpeg.begin(), jpeg.end(), data.begin() + offset);
+    }
+    return data;
+}
+
+/**
+ * @brief Write image data to a file
+ * @param path File to create or replace
+ * @param data Image data
+ */
+inline void writeImage(const std::string& path, const std::vector<FileRecovery::Byte>& data) {
+    std::ofstream image(path, std::ios::binary | std::ios::trunc);
+    image.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+/**
+ * @brief Write an image built by makeJpegImage()
+ * @return path
+ */
+inline std::string writeJpegImage(const std::string& path, FileRecovery::Size size,
+                                  const std::vector<FileRecovery::Offset>& offsets, FileRecovery::Size payload) {
+    writeImage(path, makeJpegImage(size, offsets, payload));
+    return path;
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include "utils/pattern_matcher.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace FileRecovery;
+
+class PatternMatcherTest : public ::testing::Test {
+protected:
+    // Naive search for one pattern, the reference the matcher must agree with
+    std::vector<Offset> naiveFind(const std::vector<Byte>& data, const std::vector<Byte>& pattern) {
+        std::vector<Offset> offsets;
+        for (Size i = 0; i + pattern.size() <= data.size(); ++i) {
+            if (std::equal(pattern.begin(), pattern.end(), data.begin() + i)) {
+                offsets.push_back(i);
+            }
+        }
+        return offsets;
+    }
+
+    std::vector<Byte> bytes(const std::string& text) { return std::vector<Byte>(text.begin(), text.end()); }
+};
+
+TEST_F(PatternMatcherTest, ReportsOverlappingAndNestedMatches) {
+    MultiPatternMatcher matcher;
+    matcher.addPattern(bytes("he"), 0);
+    matcher.addPattern(bytes("she"), 1);
+    matcher.addPattern(bytes("his"), 2);
+    matcher.addPattern(bytes("hers"), 3);
+    matcher.addPattern(bytes("aaa"), 4);
+    matcher.build();
+    EXPECT_EQ(matcher.getTagCount(), 5u);
+
+    std::vector<Byte> data = bytes("ushers his aaaa");
+    std::vector<std::vector<Offset>> hits;
+    matcher.findAll(data.data(), data.size(), hits);
+    ASSERT_EQ(hits.size(), 5u);
+    EXPECT_EQ(hits[0], (std::vector<Offset>{2}));
+    EXPECT_EQ(hits[1], (std::vector<Offset>{1}));
+    EXPECT_EQ(hits[2], (std::vector<Offset>{7}));
+    EXPECT_EQ(hits[3], (std::vector<Offset>{2}));
+    EXPECT_EQ(hits[4], (std::vector<Offset>{11, 12}));
+}
+
+TEST_F(PatternMatcherTest, TagsGroupPatternsInOffsetOrder) {
+    // One tag with a long and a short pattern, where the short one ends first
+    MultiPatternMatcher matcher;
+    matcher.addPattern(bytes("abcdef"), 0);
+    matcher.addPattern(bytes("cd"), 0);
+    matcher.addPattern(bytes("cd"), 0);
+    matcher.addPattern(bytes("abc"), 1);
+    matcher.addPattern({}, 2);
+    matcher.build();
+    EXPECT_EQ(matcher.getTagCount(), 2u);
+
+    std::vector<Byte> data = bytes("xabcdefcd");
+    std::vector<std::vector<Offset>> hits;
+    matcher.findAll(data.data(), data.size(), hits);
+    ASSERT_EQ(hits.size(), 2u);
+    EXPECT_EQ(hits[0], (std::vector<Offset>{1, 3, 7}));
+    EXPECT_EQ(hits[1], (std::vector<Offset>{1}));
+
+    // Results from an earlier scan are replaced
+    matcher.findAll(data.data(), 2, hits);
+    EXPECT_TRUE(hits[0].empty());
+    EXPECT_TRUE(hits[1].empty());
+}
+
+TEST_F(PatternMatcherTest, AgreesWithNaiveSearchOnRandomData) {
+    const std::vector<std::vector<Byte>> patterns = {
+        {0xFF, 0xD8, 0xFF, 0xE0}, {0xFF, 0xD8, 0xFF, 0xE1}, {0xFF, 0xD8, 0xFF, 0xDB},
+        {0x25, 0x50, 0x44, 0x46, 0x2D},
+        {0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A},
+        {0x50, 0x4B, 0x03, 0x04}, {0x50, 0x4B, 0x05, 0x06}, {0x50, 0x4B, 0x07, 0x08},
+        {0xFF, 0xD8}, {0xD8, 0xFF}
+    };
+
+    // Few distinct byte values so partial matches and overlaps are frequent
+    std::mt19937 gen(42);
+    std::vector<Byte> alphabet = {0xFF, 0xD8, 0xE0, 0x50, 0x4B, 0x03, 0x25};
+    std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+    std::vector<Byte> data(64 * 1024);
+    for (auto& byte : data) {
+        byte = alphabet[pick(gen)];
+    }
+
+    MultiPatternMatcher matcher;
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        matcher.addPattern(patterns[i], i);
+    }
+    matcher.build();
+    std::vector<std::vector<Offset>> hits;
+    matcher.findAll(data.data(), data.size(), hits);
+
+    ASSERT_EQ(hits.size(), patterns.size());
+    size_t total = 0;
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        EXPECT_EQ(hits[i], naiveFind(data, patterns[i])) << "pattern " << i;
+        total += hits[i].size();
+    }
+    EXPECT_GT(total, 0u);
+}
+
+TEST_F(PatternMatcherTest, AlignedSearchChecksOnlyGivenOffsets) {
+    MultiPatternMatcher matcher;
+    matcher.addPattern(bytes("abcd"), 0);
+    matcher.addPattern(bytes("ab"), 0);
+    matcher.addPattern(bytes("bcd"), 1);
+    matcher.build();
+
+    // "ab" at 0, 8 and 13; "abcd" at 8; "bcd" at 9
+    std::vector<Byte> data = bytes("abxxxxxxabcdxabxx");
+    std::vector<std::vector<Offset>> hits;
+    matcher.findAllAligned(data.data(), data.size(), 0, 4, hits);
+    ASSERT_EQ(hits.size(), 2u);
+    EXPECT_EQ(hits[0], (std::vector<Offset>{0, 8}));
+    EXPECT_TRUE(hits[1].empty());
+
+    matcher.findAllAligned(data.data(), data.size(), 1, 4, hits);
+    EXPECT_EQ(hits[0], (std::vector<Offset>{13}));
+    EXPECT_EQ(hits[1], (std::vector<Offset>{9}));
+
+    // Stride 1 agrees with the full search
+    std::vector<std::vector<Offset>> all;
+    matcher.findAll(data.data(), data.size(), all);
+    matcher.findAllAligned(data.data(), data.size(), 0, 1, hits);
+    EXPECT_EQ(hits, all);
+
+    // A match may not run past the end of the data
+    matcher.findAllAligned(data.data(), 10, 8, 4, hits);
+    EXPECT_EQ(hits[0], (std::vector<Offset>{8}));
+    EXPECT_TRUE(hits[1].empty());
+}
+
+TEST_F(PatternMatcherTest, EmptyMatcherFindsNothing) {
+    MultiPatternMatcher matcher;
+    EXPECT_TRUE(matcher.empty());
+    EXPECT_EQ(matcher.getStateCount(), 1u);
+
+    std::vector<Byte> data(100, 0xFF);
+    std::vector<std::vector<Offset>> hits(3, std::vector<Offset>{1});
+    matcher.findAll(data.data(), data.size(), hits);
+    EXPECT_TRUE(hits.empty());
+}
@@ -6,6 +6,8 @@
 #include <thread>
 #include <chrono>
 #include <numeric>
+#include <mutex>
+#include <set>
 
 using namespace FileRecovery;
 
@@ -309,3 +311,365 @@ TEST_F(RecoveryEngineTest, ProgressTracking) {
 }
 
 // Add more test cases as needed
+
+TEST_F(RecoveryEngineTest, MappedViewRecovery) {
+    config_.use_mmap = true;
+    engine_ = std::make_unique<RecoveryEngine>(config_);
+    
+    ASSERT_EQ(engine_->startRecovery(), RecoveryStatus::SUCCESS);
+    EXPECT_GT(engine_->getRecoveredFileCount(), 0u);
+    EXPECT_TRUE(findFileWithExtensions(output_dir_, {".jpg", ".pdf", ".png"}));
+}
+
+TEST_F(RecoveryEngineTest, NumaAwareRecovery) {
+    config_.numa_aware = true;
+    config_.threads_per_node = 2;
+    config_.keep_recovered_files = true;
+    RecoveryEngine engine(config_);
+    
+    ASSERT_EQ(engine.startRecovery(), RecoveryStatus::SUCCESS);
+    std::set<Offset> offsets;
+    for (const auto& file : engine.getRecoveredFiles()) {
+        offsets.insert(file.start_offset);
+    }
+    EXPECT_TRUE(offsets.count(1000));
+    EXPECT_TRUE(offsets.count(50000));
+    EXPECT_TRUE(offsets.count(100000));
+}
+
+TEST_F(RecoveryEngineTest, SparseImageRecovery) {
+    // Grow the image with a large trailing hole
+    std::filesystem::resize_file(test_image_path_, 256 * 1024 * 1024);
+    
+    double last_progress = 0.0;
+    engine_->setProgressCallback([&last_progress](double progress, const std::string&) {
+        last_progress = progress;
+    });
+    
+    ASSERT_EQ(engine_->startRecovery(), RecoveryStatus::SUCCESS);
+    EXPECT_GT(engine_->getRecoveredFileCount(), 0u);
+    EXPECT_TRUE(findFileWithExtensions(output_dir_, {".jpg", ".pdf", ".png"}));
+    EXPECT_DOUBLE_EQ(last_progress, 100.0);
+}
+
+TEST_F(RecoveryEngineTest, UniformBlocksSkipped) {
+    // Most of the 2MB image is zero filler after the test files
+    ASSERT_EQ(engine_->startRecovery(), RecoveryStatus::SUCCESS);
+    EXPECT_GT(engine_->getUniformBytesSkipped(), 1024u * 1024u);
+    EXPECT_TRUE(findFileWithExtensions(output_dir_, {".jpg", ".pdf", ".png"}));
+    size_t with_skip = engine_->getRecoveredFileCount();
+    
+    // Carving the filler as well finds nothing more
+    std::filesystem::remove_all(output_dir_);
+    config_.skip_uniform_blocks = false;
+    engine_ = std::make_unique<RecoveryEngine>(config_);
+    ASSERT_EQ(engine_->startRecovery(), RecoveryStatus::SUCCESS);
+    EXPECT_EQ(engine_->getUniformBytesSkipped(), 0u);
+    EXPECT_EQ(engine_->getRecoveredFileCount(), with_skip);
+}
+
+TEST_F(RecoveryEngineTest, AlignedHeaderScan) {
+    // The test files start at 1000, 50000 and 100000
+    auto recovered_offsets = [this](Size alignment) {
+        std::filesystem::remove_all(output_dir_);
+        ScanConfig config = config_;
+        config.header_alignment = alignment;
+        config.keep_recovered_files = true;
+        RecoveryEngine engine(config);
+        EXPECT_EQ(engine.startRecovery(), RecoveryStatus::SUCCESS);
+        EXPECT_EQ(engine.getHeaderAlignment(), std::max<Size>(alignment, 1));
+        std::set<Offset> offsets;
+        for (const auto& file : engine.getRecoveredFiles()) {
+            offsets.insert(file.start_offset);
+        }
+        return offsets;
+    };
+    
+    EXPECT_EQ(recovered_offsets(0), (std::set<Offset>{1000, 50000, 100000}));
+    EXPECT_EQ(recovered_offsets(8), (std::set<Offset>{1000, 50000, 100000}));
+    EXPECT_EQ(recovered_offsets(16), (std::set<Offset>{50000, 100000}));
+    EXPECT_TRUE(recovered_offsets(512).empty());
+    
+    // No filesystem on the image, so cluster alignment falls back to sectors
+    config_.align_headers_to_clusters = true;
+    RecoveryEngine engine(config_);
+    ASSERT_EQ(engine.startRecovery(), RecoveryStatus::SUCCESS);
+    EXPECT_EQ(engine.getHeaderAlignment(), SECTOR_SIZE);
+}
+
+TEST_F(RecoveryEngineTest, SegmentedImageRecovery) {
+    // Split the 2MB image into .001/.002/.003 with a boundary inside the PDF
+    std::ifstream whole(test_image_path_, std::ios::binary);
+    std::vector<char> data((std::istreambuf_iterator<char>(whole)), std::istreambuf_iterator<char>());
+    std::vector<size_t> boundaries = {0, 50100, 1024 * 1024, data.size()};
+    for (size_t i = 0; i + 1 < boundaries.size(); ++i) {
+        std::ofstream segment(test_data_dir_ + "/split.00" + std::to_string(i + 1), std::ios::binary);
+        segment.write(data.data() + boundaries[i], boundaries[i + 1] - boundaries[i]);
+    }
+    
+    config_.device_path = test_data_dir_ + "/split.001";
+    engine_ = std::make_unique<RecoveryEngine>(config_);
+    ASSERT_EQ(engine_->startRecovery(), RecoveryStatus::SUCCESS);
+    
+    // Same results as the unsplit image
+    std::filesystem::remove_all(output_dir_);
+    ScanConfig reference_config = config_;
+    reference_config.device_path = test_image_path_;
+    RecoveryEngine unsplit(reference_config);
+    ASSERT_EQ(unsplit.startRecovery(), RecoveryStatus::SUCCESS);
+    EXPECT_EQ(engine_->getRecoveredFileCount(), unsplit.getRecoveredFileCount());
+    EXPECT_GT(engine_->getRecoveredFileCount(), 0u);
+}
+
+TEST_F(RecoveryEngineTest, FilesAcrossChunkBoundaries) {
+    // 512KB chunks: a JPEG spanning three chunk edges and a small PDF
+    // crossing the 2MB edge inside the overlap
+    std::vector<uint8_t> disk_data(4 * 1024 * 1024, 0x00);
+    
+    auto place_jpeg = [&disk_data](size_t offset, size_t size) {
+        std::vector<uint8_t> header = {
+            0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x10, 'J', 'F', 'I', 'F', 0x00,
+            0x01, 0x01, 0x01, 0x00, 0x48, 0x00, 0x48, 0x00, 0x00
+        };
+        std::copy(header.begin(), header.end(), disk_data.begin() + offset);
+        for (size_t i = header.size(); i < size - 2; ++i) {
+            disk_data[offset + i] = static_cast<uint8_t>(i % 251);  // Never 0xFF
+        }
+        disk_data[offset + size - 2] = 0xFF;
+        disk_data[offset + size - 1] = 0xD9;
+    };
+    
+    const size_t jpeg_offset = 400 * 1024;
+    const size_t jpeg_size = 1200 * 1024 + 77;
+    place_jpeg(jpeg_offset, jpeg_size);
+    
+    const size_t pdf_offset = 2 * 1024 * 1024 - 300;
+    std::string pdf = "%PDF-1.4\n"
+        "1 0 obj\n<< /Type /Catalog /Pages 2 0 R >>\nendobj\n"
+        "2 0 obj\n<< /Type /Pages /Kids [3 0 R] /Count 1 >>\nendobj\n"
+        "3 0 obj\n<< /Type /Page /MediaBox [0 0 612 792] /Parent 2 0 R >>\nendobj\n"
+        "trailer\n<< /Root 1 0 R /Size 4 >>\n%%EOF";
+    std::copy(pdf.begin(), pdf.end(), disk_data.begin() + pdf_offset);
+    
+    std::ofstream img_file(test_image_path_, std::ios::binary | std::ios::trunc);
+    img_file.write(reinterpret_cast<const char*>(disk_data.data()), disk_data.size());
+    img_file.close();
+    
+    config_.target_file_types = {"JPEG", "PDF"};
+    config_.keep_recovered_files = true;
+    engine_ = std::make_unique<RecoveryEngine>(config_);
+    ASSERT_EQ(engine_->startRecovery(), RecoveryStatus::SUCCESS);
+    
+    const RecoveredFile* jpeg = nullptr;
+    const RecoveredFile* pdf_file = nullptr;
+    for (const auto& file : engine_->getRecoveredFiles()) {
+        if (file.start_offset == jpeg_offset) jpeg = &file;
+        if (file.start_offset == pdf_offset) pdf_file = &file;
+    }
+    ASSERT_NE(jpeg, nullptr);
+    EXPECT_EQ(jpeg->file_size, jpeg_size);
+    ASSERT_NE(pdf_file, nullptr);
+    EXPECT_EQ(pdf_file->file_size, pdf.size());
+    
+    // Without overlap the files are still carved whole, through extension reads
+    std::filesystem::remove_all(output_dir_);
+    config_.chunk_overlap = 0;
+    engine_ = std::make_unique<RecoveryEngine>(config_);
+    ASSERT_EQ(engine_->startRecovery(), RecoveryStatus::SUCCESS);
+    size_t whole = 0;
+    for (const auto& file : engine_->getRecoveredFiles()) {
+        if ((file.start_offset == jpeg_offset && file.file_size == jpeg_size) ||
+            (file.start_offset == pdf_offset && file.file_size == pdf.size())) {
+            whole++;
+        }
+    }
+    EXPECT_EQ(whole, 2u);
+}
+
+TEST_F(RecoveryEngineTest, SpanningFileWithEmbeddedFileInOverlap) {
+    // A PNG crossing the 1MB chunk edge and running past the overlap, with
+    // a small PNG embedded in one of its chunks inside the overlap
+    std::vector<uint8_t> disk_data(4 * 1024 * 1024, 0x00);
+    
+    auto put_chunk = [](std::vector<uint8_t>& png, const char* type, const std::vector<uint8_t>& data) {
+        uint32_t length = static_cast<uint32_t>(data.size());
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            png.push_back(static_cast<uint8_t>(length >> shift));
+        }
+        png.insert(png.end(), type, type + 4);
+        png.insert(png.end(), data.begin(), data.end());
+        png.insert(png.end(), {0x00, 0x00, 0x00, 0x00});  // CRC is not checked
+    };
+    auto make_png = [&put_chunk](const std::vector<uint8_t>& payload) {
+        std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+        put_chunk(png, "IHDR", {0, 0, 1, 0, 0, 0, 1, 0, 8, 2, 0, 0, 0});
+        if (!payload.empty()) {
+            put_chunk(png, "tEXt", payload);
+        }
+        put_chunk(png, "IEND", {});
+        return png;
+    };
+    
+    const size_t outer_offset = 1024 * 1024 - 4096;
+    const size_t inner_offset = 1024 * 1024 + 1024;
+    std::vector<uint8_t> inner = make_png({});
+    
+    std::vector<uint8_t> payload(300 * 1024);
+    for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<uint8_t>(i % 251);
+    }
+    std::vector<uint8_t> outer = make_png(payload);
+    const size_t payload_start = outer_offset + 8 + 25 + 8;
+    std::copy(inner.begin(), inner.end(), outer.begin() + (inner_offset - outer_offset));
+    ASSERT_GT(inner_offset, payload_start);
+    std::copy(outer.begin(), outer.end(), disk_data.begin() + outer_offset);
+    
+    std::ofstream img_file(test_image_path_, std::ios::binary | std::ios::trunc);
+    img_file.write(reinterpret_cast<const char*>(disk_data.data()), disk_data.size());
+    img_file.close();
+    
+    config_.target_file_types = {"PNG"};
+    config_.keep_recovered_files = true;
+    ASSERT_GT(outer_offset + outer.size(), 1024 * 1024 + config_.chunk_overlap);
+    engine_ = std::make_unique<RecoveryEngine>(config_);
+    ASSERT_EQ(engine_->startRecovery(), RecoveryStatus::SUCCESS);
+    
+    const RecoveredFile* outer_file = nullptr;
+    const RecoveredFile* inner_file = nullptr;
+    for (const auto& file : engine_->getRecoveredFiles()) {
+        if (file.start_offset == outer_offset) outer_file = &file;
+        if (file.start_offset == inner_offset) inner_file = &file;
+    }
+    ASSERT_NE(outer_file, nullptr);
+    EXPECT_EQ(outer_file->file_size, outer.size());
+    ASSERT_NE(inner_file, nullptr);
+    EXPECT_EQ(inner_file->file_size, inner.size());
+}
+
+TEST_F(RecoveryEngineTest, UnterminatedHeaderExtensionIsBounded) {
+    // A PDF header near the end of the first chunk with no %%EOF anywhere
+    // after it: the footer search stops at max_span_extension, not at the
+    // PDF carver's 1GB limit or the end of the 16MB image
+    std::vector<uint8_t> disk_data(16 * 1024 * 1024);
+    for (size_t i = 0; i < disk_data.size(); ++i) {
+        disk_data[i] = static_cast<uint8_t>(i % 251);  // Never "%%"
+    }
+    const std::string header = "%PDF-1.4\n";
+    std::copy(header.begin(), header.end(), disk_data.begin() + 500 * 1024);
+    
+    std::ofstream img_file(test_image_path_, std::ios::binary | std::ios::trunc);
+    img_file.write(reinterpret_cast<const char*>(disk_data.data()), disk_data.size());
+    img_file.close();
+    
+    config_.target_file_types = {"PDF"};
+    config_.num_threads = 1;
+    config_.max_span_extension = 2 * 1024 * 1024;
+    engine_ = std::make_unique<RecoveryEngine>(config_);
+    ASSERT_EQ(engine_->startRecovery(), RecoveryStatus::SUCCESS);
+    EXPECT_GT(engine_->getSpanBytesRead(), 0u);
+    EXPECT_LE(engine_->getSpanBytesRead(), config_.max_span_extension);
+    
+    // A zero limit keeps files to their chunk's window
+    std::filesystem::remove_all(output_dir_);
+    config_.max_span_extension = 0;
+    engine_ = std::make_unique<RecoveryEngine>(config_);
+    ASSERT_EQ(engine_->startRecovery(), RecoveryStatus::SUCCESS);
+    EXPECT_EQ(engine_->getSpanBytesRead(), 0u);
+}
+
+TEST_F(RecoveryEngineTest, StreamingResultSink) {
+    class CollectingSink : public ResultSink {
+    public:
+        void onFileRecovered(const RecoveredFile& file, bool saved) override {
+            std::lock_guard<std::mutex> lock(mutex);
+            files.push_back(file);
+            saved_count += saved ? 1 : 0;
+            // The file is already on disk when the sink hears about it
+            if (saved && !std::filesystem::exists(output_dir + "/" + file.filename)) {
+                missing_on_disk++;
+            }
+        }
+        void onRecoveryFinished(size_t file_count) override {
+            finished_count = file_count;
+        }
+        
+        std::string output_dir;
+        std::mutex mutex;
+        std::vector<RecoveredFile> files;
+        size_t saved_count = 0;
+        size_t missing_on_disk = 0;
+        size_t finished_count = 0;
+    };
+    
+    auto sink = std::make_unique<CollectingSink>();
+    CollectingSink* collected = sink.get();
+    collected->output_dir = output_dir_;
+    engine_->addResultSink(std::move(sink));
+    
+    ASSERT_EQ(engine_->startRecovery(), RecoveryStatus::SUCCESS);
+    EXPECT_GT(engine_->getRecoveredFileCount(), 0u);
+    EXPECT_EQ(collected->files.size(), engine_->getRecoveredFileCount());
+    EXPECT_EQ(collected->finished_count, engine_->getRecoveredFileCount());
+    EXPECT_EQ(collected->saved_count, collected->files.size());
+    EXPECT_EQ(collected->missing_on_disk, 0u);
+    
+    // Results are not retained unless asked for
+    EXPECT_TRUE(engine_->getRecoveredFiles().empty());
+    
+    // No file is delivered twice
+    std::set<std::pair<Offset, Size>> keys;
+    for (const auto& file : collected->files) {
+        EXPECT_TRUE(keys.emplace(file.start_offset, file.file_size).second);
+    }
+    
+    // Opt-in retention returns the same files in offset order
+    std::filesystem::remove_all(output_dir_);
+    config_.keep_recovered_files = true;
+    engine_ = std::make_unique<RecoveryEngine>(config_);
+    ASSERT_EQ(engine_->startRecovery(), RecoveryStatus::SUCCESS);
+    const auto& retained = engine_->getRecoveredFiles();
+    ASSERT_EQ(retained.size(), keys.size());
+    for (size_t i = 0; i < retained.size(); ++i) {
+        EXPECT_TRUE(keys.count({retained[i].start_offset, retained[i].file_size}));
+        if (i > 0) {
+            EXPECT_LE(retained[i - 1].start_offset, retained[i].start_offset);
+        }
+    }
+}
+
+TEST_F(RecoveryEngineTest, ExtractionOverlapsScan) {
+    class CountingSink : public ResultSink {
+    public:
+        void onFileRecovered(const RecoveredFile&, bool saved) override {
+            if (saved) {
+                delivered++;
+            }
+        }
+        std::atomic<size_t> delivered{0};
+    };
+    
+    // Hold the scan on its last chunk until a file has been written; if
+    // extraction only started after the scan this would time out
+    config_.num_threads = 1;
+    config_.extraction_threads = 1;
+    engine_ = std::make_unique<RecoveryEngine>(config_);
+    auto sink = std::make_unique<CountingSink>();
+    CountingSink* counting = sink.get();
+    engine_->addResultSink(std::move(sink));
+    
+    bool written_during_scan = false;
+    engine_->setProgressCallback([&](double, const std::string& message) {
+        if (message == "Scanning chunk 4/4") {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (counting->delivered == 0 && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            written_during_scan = counting->delivered > 0;
+        }
+    });
+    
+    ASSERT_EQ(engine_->startRecovery(), RecoveryStatus::SUCCESS);
+    EXPECT_TRUE(written_during_scan);
+    EXPECT_EQ(counting->delivered.load(), engine_->getRecoveredFileCount());
+    EXPECT_GT(engine_->getBytesExtracted(), 0u);
+}
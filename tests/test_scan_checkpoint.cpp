@@ -0,0 +1,291 @@
+#include <gtest/gtest.h>
+#include "core/scan_checkpoint.h"
+#include "core/recovery_engine.h"
+#include "utils/logger.h"
+#include "test_image_utils.h"
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace FileRecovery;
+
+namespace {
+
+// Collects (offset, size) of every file delivered by the engine
+class KeySink : public ResultSink {
+public:
+    explicit KeySink(std::multiset<std::pair<Offset, Size>>& keys) : keys_(keys) {}
+
+    void onFileRecovered(const RecoveredFile& file, bool saved) override {
+        if (saved) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            keys_.emplace(file.start_offset, file.file_size);
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::multiset<std::pair<Offset, Size>>& keys_;
+};
+
+RecoveredFile makeFile(Offset offset, Size size) {
+    RecoveredFile file;
+    file.start_offset = offset;
+    file.file_size = size;
+    file.file_type = "JPEG";
+    file.confidence_score = 1.0;
+    file.filename = "recovered_" + std::to_string(offset) + ".jpg";
+    return file;
+}
+
+} // namespace
+
+class ScanCheckpointTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_data_dir_ = "test_checkpoint_data";
+        std::filesystem::create_directories(test_data_dir_);
+        checkpoint_path_ = test_data_dir_ + "/scan.checkpoint";
+        Logger::getInstance().initialize("test_checkpoint.log", Logger::Level::DEBUG);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_data_dir_);
+        std::filesystem::remove("test_checkpoint.log");
+    }
+
+    // 4MB image with a small JPEG every 256KB
+    std::string createImage() {
+        std::vector<Offset> offsets;
+        for (Offset offset = 4096; offset < 4 * 1024 * 1024; offset += 256 * 1024) {
+            offsets.push_back(offset);
+        }
+        return writeJpegImage(test_data_dir_ + "/photos.img", 4 * 1024 * 1024, offsets, 300);
+    }
+
+    std::string test_data_dir_;
+    std::string checkpoint_path_;
+};
+
+TEST_F(ScanCheckpointTest, CompletedRangesMerge) {
+    ScanCheckpoint checkpoint(checkpoint_path_, 42);
+    ASSERT_TRUE(checkpoint.create());
+
+    checkpoint.markCompleted(0, 100);
+    checkpoint.markCompleted(200, 100);
+    EXPECT_TRUE(checkpoint.isCompleted(0, 100));
+    EXPECT_FALSE(checkpoint.isCompleted(50, 200));
+    EXPECT_EQ(checkpoint.getCompletedBytes(), 200u);
+
+    checkpoint.markCompleted(100, 100);
+    EXPECT_TRUE(checkpoint.isCompleted(50, 200));
+    EXPECT_EQ(checkpoint.getCompletedBytes(), 300u);
+}
+
+TEST_F(ScanCheckpointTest, LoadKeepsOnlyCommittedResultsOfCompletedWork) {
+    {
+        ScanCheckpoint checkpoint(checkpoint_path_, 42);
+        ASSERT_TRUE(checkpoint.create());
+        checkpoint.recordResult(makeFile(10, 500), true, false);      // Chunk [0, 1000) completes
+        checkpoint.recordResult(makeFile(1500, 500), true, false);    // Chunk [1000, 2000) does not
+        checkpoint.recordResult(makeFile(5000, 100), false, true);    // Metadata, not finished
+        checkpoint.markCompleted(0, 1000);
+        ASSERT_TRUE(checkpoint.save());
+        // Written after the last save, so not committed
+        checkpoint.recordResult(makeFile(20, 10), true, false);
+    }
+
+    ScanCheckpoint checkpoint(checkpoint_path_, 42);
+    ASSERT_TRUE(checkpoint.load());
+    EXPECT_TRUE(checkpoint.isCompleted(0, 1000));
+    EXPECT_FALSE(checkpoint.isMetadataDone());
+    EXPECT_EQ(checkpoint.getResultCount(), 1u);
+    EXPECT_EQ(checkpoint.getSavedCount(), 1u);
+
+    std::vector<RecoveredFile> results;
+    EXPECT_TRUE(checkpoint.forEachResult([&results](const RecoveredFile& file, bool saved, bool from_metadata) {
+        EXPECT_TRUE(saved);
+        EXPECT_FALSE(from_metadata);
+        results.push_back(file);
+    }));
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_EQ(results[0].start_offset, 10u);
+    EXPECT_EQ(results[0].file_size, 500u);
+    EXPECT_EQ(results[0].file_type, "JPEG");
+    EXPECT_EQ(results[0].filename, "recovered_10.jpg");
+
+    // New results append after the compacted journal
+    checkpoint.recordResult(makeFile(1500, 500), true, false);
+    EXPECT_EQ(checkpoint.getResultCount(), 2u);
+}
+
+TEST_F(ScanCheckpointTest, RejectsDifferentConfig) {
+    ScanConfig config;
+    config.device_path = "disk.img";
+    uint64_t hash = ScanCheckpoint::hashConfig(config, 1024 * 1024, 1);
+    EXPECT_EQ(hash, ScanCheckpoint::hashConfig(config, 1024 * 1024, 1));
+    EXPECT_NE(hash, ScanCheckpoint::hashConfig(config, 2 * 1024 * 1024, 1));
+
+    // Thread counts do not change what a chunk yields
+    ScanConfig threads = config;
+    threads.num_threads = 7;
+    EXPECT_EQ(hash, ScanCheckpoint::hashConfig(threads, 1024 * 1024, 1));
+
+    ScanConfig chunks = config;
+    chunks.chunk_size *= 2;
+    EXPECT_NE(hash, ScanCheckpoint::hashConfig(chunks, 1024 * 1024, 1));
+
+    // Headers searched at other offsets yield other files
+    EXPECT_NE(hash, ScanCheckpoint::hashConfig(config, 1024 * 1024, 4096));
+
+    {
+        ScanCheckpoint checkpoint(checkpoint_path_, hash);
+        ASSERT_TRUE(checkpoint.create());
+    }
+    ScanCheckpoint other(checkpoint_path_, hash + 1);
+    EXPECT_FALSE(other.load());
+}
+
+TEST_F(ScanCheckpointTest, ResumeAfterInterruptSkipsNothingTwice) {
+    ScanConfig config;
+    config.device_path = createImage();
+    config.use_metadata_recovery = false;
+    config.num_threads = 1;
+    config.extraction_threads = 1;
+    config.chunk_size = 512 * 1024;
+    config.checkpoint_path = checkpoint_path_;
+
+    // Reference run without interruption
+    std::multiset<std::pair<Offset, Size>> expected;
+    {
+        config.output_directory = test_data_dir_ + "/reference";
+        RecoveryEngine engine(config);
+        engine.addResultSink(std::make_unique<KeySink>(expected));
+        ASSERT_EQ(engine.startRecovery(), RecoveryStatus::SUCCESS);
+        EXPECT_FALSE(std::filesystem::exists(checkpoint_path_));
+    }
+    ASSERT_EQ(expected.size(), 16u);
+
+    // Interrupted run: stop while the third of eight chunks is reported,
+    // once the files of the chunks before it have had time to be saved
+    std::multiset<std::pair<Offset, Size>> first_part;
+    config.output_directory = test_data_dir_ + "/resumed";
+    {
+        RecoveryEngine engine(config);
+        engine.addResultSink(std::make_unique<KeySink>(first_part));
+        engine.setProgressCallback([&engine](double, const std::string& message) {
+            if (message.find("Scanning chunk 3/") == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                engine.stopRecovery();
+            }
+        });
+        engine.startRecovery();
+    }
+    ASSERT_TRUE(std::filesystem::exists(checkpoint_path_));
+
+    std::multiset<std::pair<Offset, Size>> second_part;
+    config.resume = true;
+    config.keep_recovered_files = true;
+    {
+        RecoveryEngine engine(config);
+        engine.addResultSink(std::make_unique<KeySink>(second_part));
+        ASSERT_EQ(engine.startRecovery(), RecoveryStatus::SUCCESS);
+        EXPECT_EQ(engine.getRecoveredFileCount(), expected.size());
+        EXPECT_EQ(engine.getRecoveredFiles().size(), expected.size());
+    }
+    EXPECT_FALSE(std::filesystem::exists(checkpoint_path_));
+
+    // The resumed run did not repeat the chunks the checkpoint recorded
+    EXPECT_LT(second_part.size(), expected.size());
+
+    // Together the two runs found everything; each file in the result
+    // index of the resumed run is there exactly once
+    std::set<std::pair<Offset, Size>> combined(first_part.begin(), first_part.end());
+    combined.insert(second_part.begin(), second_part.end());
+    std::set<std::pair<Offset, Size>> distinct(expected.begin(), expected.end());
+    EXPECT_EQ(combined, distinct);
+}
+
+TEST_F(ScanCheckpointTest, UnreadableChunkIsCarvedOnResume) {
+    ScanConfig config;
+    config.device_path = createImage();
+    config.use_metadata_recovery = false;
+    config.num_threads = 1;
+    config.extraction_threads = 1;
+    config.chunk_size = 512 * 1024;
+    config.checkpoint_path = checkpoint_path_;
+    config.output_directory = test_data_dir_ + "/output";
+
+    // The read of the chunk at 1MB fails, losing its two JPEGs
+    const Offset bad_chunk = 1024 * 1024;
+    std::multiset<std::pair<Offset, Size>> first_part;
+    {
+        RecoveryEngine engine(config);
+        engine.addResultSink(std::make_unique<KeySink>(first_part));
+        engine.setReadFaultHook([bad_chunk](Offset offset, Size) { return offset == bad_chunk; });
+        ASSERT_EQ(engine.startRecovery(), RecoveryStatus::SUCCESS);
+        EXPECT_EQ(engine.getFailedChunkCount(), 1u);
+    }
+    EXPECT_EQ(first_part.size(), 14u);
+    for (const auto& key : first_part) {
+        EXPECT_FALSE(key.first >= bad_chunk && key.first < bad_chunk + config.chunk_size) << key.first;
+    }
+    // The checkpoint is kept although the run finished
+    ASSERT_TRUE(std::filesystem::exists(checkpoint_path_));
+
+    // Resuming reads only the failed chunk and recovers what it held
+    std::multiset<std::pair<Offset, Size>> second_part;
+    config.resume = true;
+    config.keep_recovered_files = true;
+    {
+        RecoveryEngine engine(config);
+        engine.addResultSink(std::make_unique<KeySink>(second_part));
+        ASSERT_EQ(engine.startRecovery(), RecoveryStatus::SUCCESS);
+        EXPECT_EQ(engine.getFailedChunkCount(), 0u);
+        EXPECT_EQ(engine.getRecoveredFileCount(), 16u);
+    }
+    ASSERT_EQ(second_part.size(), 2u);
+    for (const auto& key : second_part) {
+        EXPECT_GE(key.first, bad_chunk);
+        EXPECT_LT(key.first, bad_chunk + config.chunk_size);
+    }
+    EXPECT_FALSE(std::filesystem::exists(checkpoint_path_));
+}
+
+TEST_F(ScanCheckpointTest, ResumeRejectsChangedAlignment) {
+    ScanConfig config;
+    config.device_path = createImage();
+    config.use_metadata_recovery = false;
+    config.num_threads = 1;
+    config.extraction_threads = 1;
+    config.chunk_size = 512 * 1024;
+    config.checkpoint_path = checkpoint_path_;
+    config.output_directory = test_data_dir_ + "/output";
+
+    // A failed chunk leaves the checkpoint of a byte-granular scan behind
+    {
+        RecoveryEngine engine(config);
+        engine.setReadFaultHook([](Offset offset, Size) { return offset == 1024 * 1024; });
+        ASSERT_EQ(engine.startRecovery(), RecoveryStatus::SUCCESS);
+    }
+    ASSERT_TRUE(std::filesystem::exists(checkpoint_path_));
+
+    // Its completed chunks say nothing about a 4K-aligned scan
+    config.resume = true;
+    config.header_alignment = 4096;
+    {
+        RecoveryEngine engine(config);
+        EXPECT_EQ(engine.startRecovery(), RecoveryStatus::FAILED);
+    }
+    EXPECT_TRUE(std::filesystem::exists(checkpoint_path_));
+
+    // The same alignment as before still resumes
+    config.header_alignment = 0;
+    {
+        RecoveryEngine engine(config);
+        EXPECT_EQ(engine.startRecovery(), RecoveryStatus::SUCCESS);
+        EXPECT_EQ(engine.getRecoveredFileCount(), 16u);
+    }
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include "core/scan_tuner.h"
+#include "core/disk_scanner.h"
+#include "core/recovery_engine.h"
+#include "utils/logger.h"
+#include "test_image_utils.h"
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+using namespace FileRecovery;
+
+class ScanTunerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_data_dir_ = "test_tuner_data";
+        std::filesystem::create_directories(test_data_dir_);
+        Logger::getInstance().initialize("test_tuner.log", Logger::Level::DEBUG);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_data_dir_);
+        std::filesystem::remove("test_tuner.log");
+    }
+
+    // Image of the given size with a small JPEG every 2MB
+    std::string createImage(Size size) {
+        std::vector<Offset> offsets;
+        for (Offset offset = 8192; offset + 4096 < size; offset += 2 * 1024 * 1024) {
+            offsets.push_back(offset);
+        }
+        return writeJpegImage(test_data_dir_ + "/disk.img", size, offsets, 500);
+    }
+
+    std::string test_data_dir_;
+};
+
+TEST_F(ScanTunerTest, CalibrationMeasuresDeviceAndCarvers) {
+    DiskScanner scanner(createImage(32 * 1024 * 1024));
+    ASSERT_TRUE(scanner.initialize());
+
+    ScanTuner tuner(scanner, 4);
+    size_t carve_calls = 0;
+    Size carved = 0;
+    TuningResult result = tuner.calibrate([&](const Byte*, Size size, Offset) {
+        carve_calls++;
+        carved += size;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    });
+
+    EXPECT_TRUE(result.calibrated);
+    EXPECT_TRUE(result.chunk_size == 256 * 1024 || result.chunk_size == 1024 * 1024);
+    EXPECT_EQ(carve_calls, 1u);
+    EXPECT_EQ(carved, result.chunk_size);
+    EXPECT_GT(result.read_mbps, 0.0);
+    EXPECT_GT(result.carve_ns_per_byte, 0.0);
+    EXPECT_GE(result.workers, 1u);
+    EXPECT_LE(result.workers, 4u);
+    EXPECT_GE(result.io_depth, result.workers + 1);
+    EXPECT_NE(result.describe().find("workers"), std::string::npos);
+}
+
+TEST_F(ScanTunerTest, FixedChunkSizeAndSmallDevices) {
+    {
+        DiskScanner scanner(createImage(32 * 1024 * 1024));
+        ASSERT_TRUE(scanner.initialize());
+        ScanTuner tuner(scanner, 2);
+        TuningResult result = tuner.calibrate([](const Byte*, Size, Offset) {}, 512 * 1024);
+        EXPECT_TRUE(result.calibrated);
+        EXPECT_EQ(result.chunk_size, 512u * 1024);
+    }
+
+    // Too small to sample without reading most of it: every worker, default chunks
+    DiskScanner scanner(createImage(512 * 1024));
+    ASSERT_TRUE(scanner.initialize());
+    ScanTuner tuner(scanner, 3);
+    TuningResult result = tuner.calibrate([](const Byte*, Size, Offset) { FAIL() << "Nothing to carve"; });
+    EXPECT_FALSE(result.calibrated);
+    EXPECT_EQ(result.chunk_size, DEFAULT_CHUNK_SIZE);
+    EXPECT_EQ(result.workers, 3u);
+    EXPECT_EQ(result.io_depth, 4u);
+}
+
+TEST_F(ScanTunerTest, CarveSlotsFollowActiveWorkers) {
+    DiskScanner scanner(createImage(1024 * 1024));
+    ScanTuner tuner(scanner, 4);
+    tuner.startRun(1, 2);
+
+    // A parked worker is refused a slot rather than made to wait
+    EXPECT_TRUE(tuner.tryBeginCarve());
+    EXPECT_FALSE(tuner.tryBeginCarve());
+    tuner.endCarve();
+    EXPECT_TRUE(tuner.tryBeginCarve());
+    tuner.endCarve();
+}
+
+TEST_F(ScanTunerTest, AdjustFollowsTheBottleneck) {
+    DiskScanner scanner(createImage(1024 * 1024));
+    ScanTuner tuner(scanner, 4);
+    tuner.startRun(2, 4);
+
+    // Too soon after the start of the run
+    PipelineStats stats;
+    stats.reader_stall = std::chrono::seconds(10);
+    EXPECT_FALSE(tuner.adjust(stats));
+
+    // The reader spent the whole interval waiting on a full ring
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    stats.reader_stall = std::chrono::seconds(2);
+    EXPECT_TRUE(tuner.adjust(stats));
+    EXPECT_EQ(tuner.getActiveWorkers(), 3u);
+    EXPECT_EQ(tuner.getIoDepth(), 4u);
+
+    // Then every carver spent it waiting for data
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    stats.consumer_stall = std::chrono::seconds(10);
+    EXPECT_TRUE(tuner.adjust(stats));
+    EXPECT_EQ(tuner.getActiveWorkers(), 2u);
+    EXPECT_EQ(tuner.getIoDepth(), 8u);
+    EXPECT_EQ(tuner.getAdjustmentCount(), 2u);
+}
+
+TEST_F(ScanTunerTest, AutoTunedRecoveryFindsTheSameFiles) {
+    ScanConfig config;
+    config.device_path = createImage(32 * 1024 * 1024);
+    config.use_metadata_recovery = false;
+    config.num_threads = 2;
+    config.keep_recovered_files = true;
+
+    config.output_directory = test_data_dir_ + "/fixed";
+    RecoveryEngine fixed(config);
+    ASSERT_EQ(fixed.startRecovery(), RecoveryStatus::SUCCESS);
+
+    config.output_directory = test_data_dir_ + "/tuned";
+    config.auto_tune = true;
+    RecoveryEngine tuned(config);
+    ASSERT_EQ(tuned.startRecovery(), RecoveryStatus::SUCCESS);
+
+    ASSERT_EQ(fixed.getRecoveredFiles().size(), 16u);
+    ASSERT_EQ(tuned.getRecoveredFiles().size(), fixed.getRecoveredFiles().size());
+    for (size_t i = 0; i < fixed.getRecoveredFiles().size(); ++i) {
+        EXPECT_EQ(tuned.getRecoveredFiles()[i].start_offset, fixed.getRecoveredFiles()[i].start_offset);
+        EXPECT_EQ(tuned.getRecoveredFiles()[i].file_size, fixed.getRecoveredFiles()[i].file_size);
+    }
+}
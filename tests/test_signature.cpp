@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include "utils/signature.h"
+#include <string>
+
+using namespace FileRecovery;
+
+namespace {
+
+constexpr SignatureTable<2, 4> HEADERS = {{
+    {'a', 'b', 'c', 'd'},
+    {'a', 'b', 'x', 'y'}
+}};
+
+constexpr Signature<3> FOOTER = {'E', 'O', 'F'};
+
+// Tables are usable in constant expressions, so nothing is built at run time
+static_assert(HEADERS.size() == 2 && HEADERS[1][2] == 'x', "signature tables are constexpr");
+static_assert(FOOTER.size() == 3, "signature length is a compile-time constant");
+
+} // namespace
+
+class SignatureTest : public ::testing::Test {
+protected:
+    std::vector<Byte> bytes(const std::string& text) { return std::vector<Byte>(text.begin(), text.end()); }
+};
+
+TEST_F(SignatureTest, StartsWithChecksLengthAndEveryByte) {
+    auto data = bytes("abxyz");
+    EXPECT_TRUE(SignatureUtils::startsWithAny(data.data(), data.size(), HEADERS));
+    EXPECT_FALSE(SignatureUtils::startsWithAny(data.data(), 3, HEADERS));
+    EXPECT_TRUE(SignatureUtils::startsWith(data.data(), data.size(), HEADERS[1]));
+    EXPECT_FALSE(SignatureUtils::startsWith(data.data(), data.size(), HEADERS[0]));
+
+    auto other = bytes("abcz");
+    EXPECT_FALSE(SignatureUtils::startsWithAny(other.data(), other.size(), HEADERS));
+}
+
+TEST_F(SignatureTest, FindReturnsFirstMatchOrSize) {
+    auto data = bytes("EOxEOEOFabcEOF");
+    EXPECT_EQ(SignatureUtils::find(data.data(), data.size(), FOOTER), 5u);
+    EXPECT_EQ(SignatureUtils::find(data.data() + 6, data.size() - 6, FOOTER), 5u);
+
+    // A match must fit entirely in the data
+    EXPECT_EQ(SignatureUtils::find(data.data(), 7, FOOTER), 7u);
+    EXPECT_EQ(SignatureUtils::find(data.data(), 2, FOOTER), 2u);
+
+    auto tail = bytes("xxEOF");
+    EXPECT_EQ(SignatureUtils::find(tail.data(), tail.size(), FOOTER), 2u);
+}
+
+TEST_F(SignatureTest, ConvertsToInterfaceVectors) {
+    auto patterns = SignatureUtils::toBytes(HEADERS);
+    ASSERT_EQ(patterns.size(), 2u);
+    EXPECT_EQ(patterns[0], bytes("abcd"));
+    EXPECT_EQ(patterns[1], bytes("abxy"));
+    EXPECT_EQ(SignatureUtils::toBytes(FOOTER), bytes("EOF"));
+}
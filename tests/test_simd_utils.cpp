@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+#include "utils/simd_utils.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace FileRecovery;
+
+class SimdUtilsTest : public ::testing::Test {
+protected:
+    const std::vector<SimdLevel> levels_ = {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2};
+};
+
+TEST_F(SimdUtilsTest, UniformDetectionAllLevels) {
+    for (SimdLevel level : levels_) {
+        SCOPED_TRACE(SimdUtils::getSimdLevelName(level));
+        
+        for (Byte value : {Byte(0x00), Byte(0xFF), Byte(0x5A)}) {
+            std::vector<Byte> block(4096, value);
+            EXPECT_TRUE(SimdUtils::isUniform(block.data(), block.size(), level));
+            
+            // A single differing byte anywhere, including the unrolled tail
+            for (Size pos : {Size(1), Size(31), Size(100), Size(4000), Size(4095)}) {
+                block[pos] ^= 0x01;
+                EXPECT_FALSE(SimdUtils::isUniform(block.data(), block.size(), level)) << "pos " << pos;
+                block[pos] ^= 0x01;
+            }
+        }
+        
+        // Sizes that do not fill a vector register
+        std::vector<Byte> small(7, 0x11);
+        EXPECT_TRUE(SimdUtils::isUniform(small.data(), small.size(), level));
+        small[6] = 0x12;
+        EXPECT_FALSE(SimdUtils::isUniform(small.data(), small.size(), level));
+        EXPECT_TRUE(SimdUtils::isUniform(small.data(), 0, level));
+    }
+}
+
+TEST_F(SimdUtilsTest, NonUniformRuns) {
+    // Layout in 4K blocks: data, zeros x4, data, 0xFF x1, data
+    const Size block = 4096;
+    std::vector<Byte> data(8 * block, 0x00);
+    auto fill_data = [&](Size index) {
+        for (Size i = 0; i < block; ++i) {
+            data[index * block + i] = static_cast<Byte>(i * 7 + 1);
+        }
+    };
+    fill_data(0);
+    fill_data(5);
+    std::fill(data.begin() + 6 * block, data.begin() + 7 * block, 0xFF);
+    fill_data(7);
+    
+    // Every uniform block is dropped
+    auto runs = SimdUtils::findNonUniformRuns(data.data(), data.size(), block, block);
+    ASSERT_EQ(runs.size(), 3u);
+    EXPECT_EQ(runs[0], std::make_pair(Size(0), block));
+    EXPECT_EQ(runs[1], std::make_pair(5 * block, block));
+    EXPECT_EQ(runs[2], std::make_pair(7 * block, block));
+    
+    // Short uniform runs stay attached to their neighbours
+    runs = SimdUtils::findNonUniformRuns(data.data(), data.size(), block, 2 * block);
+    ASSERT_EQ(runs.size(), 2u);
+    EXPECT_EQ(runs[0], std::make_pair(Size(0), block));
+    EXPECT_EQ(runs[1], std::make_pair(5 * block, 3 * block));
+    
+    // Entirely uniform and partial trailing block
+    std::vector<Byte> zeros(3 * block + 100, 0x00);
+    EXPECT_TRUE(SimdUtils::findNonUniformRuns(zeros.data(), zeros.size(), block, block).empty());
+    zeros.back() = 0x01;
+    runs = SimdUtils::findNonUniformRuns(zeros.data(), zeros.size(), block, block);
+    ASSERT_EQ(runs.size(), 1u);
+    EXPECT_EQ(runs[0], std::make_pair(3 * block, Size(100)));
+}
+
+TEST_F(SimdUtilsTest, UniformDetectionThroughput) {
+    std::vector<Byte> zeros(64 * 1024 * 1024, 0x00);
+    std::cout << "Detected SIMD level: " << SimdUtils::getSimdLevelName(SimdUtils::getSimdLevel()) << std::endl;
+    
+    for (SimdLevel level : levels_) {
+        auto start = std::chrono::high_resolution_clock::now();
+        Size uniform = 0;
+        for (Size pos = 0; pos < zeros.size(); pos += 4096) {
+            uniform += SimdUtils::isUniform(zeros.data() + pos, 4096, level) ? 4096 : 0;
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+        
+        EXPECT_EQ(uniform, zeros.size());
+        std::cout << SimdUtils::getSimdLevelName(level) << ": "
+                  << (zeros.size() / (1024.0 * 1024.0 * 1024.0)) / seconds << " GB/s" << std::endl;
+    }
+}
+
+TEST_F(SimdUtilsTest, PatternSearchAllLevels) {
+    // Few distinct byte values so candidates and overlaps are frequent
+    std::vector<Byte> data(1000);
+    for (Size i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<Byte>((i * 7) % 3 == 0 ? 0xFF : (i % 5 == 0 ? 0xD8 : 0x00));
+    }
+    const std::vector<std::vector<Byte>> patterns = {
+        {0xFF}, {0xFF, 0xD8}, {0xFF, 0x00, 0x00}, {0xD8, 0x00, 0xFF, 0x00},
+        {0xFF, 0xD8, 0xFF, 0xE0}, std::vector<Byte>(40, 0x00), {}
+    };
+    
+    for (const auto& pattern : patterns) {
+        std::vector<Offset> expected;
+        for (Size i = 0; !pattern.empty() && i + pattern.size() <= data.size(); ++i) {
+            if (std::equal(pattern.begin(), pattern.end(), data.begin() + i)) {
+                expected.push_back(i);
+            }
+        }
+        // Every buffer length, so matches land in the vector loop and the tail
+        for (SimdLevel level : levels_) {
+            SCOPED_TRACE(SimdUtils::getSimdLevelName(level));
+            EXPECT_EQ(SimdUtils::findPattern(data.data(), data.size(), pattern, level), expected);
+            for (Size size = 0; size < 80; ++size) {
+                std::vector<Offset> prefix;
+                for (Offset offset : expected) {
+                    if (offset + pattern.size() <= size) {
+                        prefix.push_back(offset);
+                    }
+                }
+                EXPECT_EQ(SimdUtils::findPattern(data.data(), size, pattern, level), prefix) << "size " << size;
+            }
+        }
+    }
+    
+    // Match in the last possible position
+    std::vector<Byte> tail(100, 0x11);
+    tail[96] = 0x25;
+    tail[99] = 0x2D;
+    for (SimdLevel level : levels_) {
+        EXPECT_EQ(SimdUtils::findPattern(tail.data(), tail.size(), {0x25, 0x11, 0x11, 0x2D}, level),
+                  std::vector<Offset>{96});
+    }
+}
+
+TEST_F(SimdUtilsTest, FirstOfAllLevels) {
+    std::vector<Byte> data(200, 0x00);
+    data[37] = 0x50;
+    data[150] = 0xFF;
+    const std::vector<Byte> few = {0xFF, 0x25, 0x89, 0x50};
+    std::vector<Byte> many;
+    for (int value = 0x40; value <= 0x50; ++value) {
+        many.push_back(static_cast<Byte>(value));
+    }
+    
+    for (SimdLevel level : levels_) {
+        SCOPED_TRACE(SimdUtils::getSimdLevelName(level));
+        EXPECT_EQ(SimdUtils::findFirstOf(data.data(), data.size(), few, level), 37u);
+        EXPECT_EQ(SimdUtils::findFirstOf(data.data() + 38, data.size() - 38, few, level), 112u);
+        EXPECT_EQ(SimdUtils::findFirstOf(data.data() + 151, data.size() - 151, few, level), 49u);
+        EXPECT_EQ(SimdUtils::findFirstOf(data.data(), data.size(), many, level), 37u);
+        EXPECT_EQ(SimdUtils::findFirstOf(data.data(), data.size(), {}, level), data.size());
+        // Matches in the scalar tail after the last full vector
+        for (Size size = 0; size < 40; ++size) {
+            EXPECT_EQ(SimdUtils::findFirstOf(data.data(), size, {0x00}, level), size > 0 ? 0u : size);
+            EXPECT_EQ(SimdUtils::findFirstOf(data.data() + 38 - size, size, {0x50}, level),
+                      size > 0 ? size - 1 : size);
+        }
+    }
+}
+
+TEST_F(SimdUtilsTest, PatternSearchThroughput) {
+    // Random data with a few planted JPEG signatures
+    std::vector<Byte> data(64 * 1024 * 1024);
+    uint32_t state = 12345;
+    for (auto& byte : data) {
+        state = state * 1103515245 + 12345;
+        byte = static_cast<Byte>(state >> 24);
+    }
+    const std::vector<Byte> signature = {0xFF, 0xD8, 0xFF, 0xE0};
+    for (Size pos = 1000; pos < data.size(); pos += 8 * 1024 * 1024) {
+        std::copy(signature.begin(), signature.end(), data.begin() + pos);
+    }
+    
+    std::vector<Offset> reference;
+    for (SimdLevel level : levels_) {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto matches = SimdUtils::findPattern(data.data(), data.size(), signature, level);
+        auto end = std::chrono::high_resolution_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+        
+        if (level == SimdLevel::SCALAR) {
+            reference = matches;
+            EXPECT_GE(reference.size(), 8u);
+        }
+        EXPECT_EQ(matches, reference);
+        std::cout << "findPattern " << SimdUtils::getSimdLevelName(level) << ": "
+                  << (data.size() / (1024.0 * 1024.0 * 1024.0)) / seconds << " GB/s" << std::endl;
+    }
+}
@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+#include "utils/thread_pool.h"
+#include "utils/task_group.h"
+#include "utils/cpu_topology.h"
+#include "utils/logger.h"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <algorithm>
+#include <sched.h>
+
+using namespace FileRecovery;
+
+class ThreadPoolTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Logger::getInstance().initialize("test_thread_pool.log", Logger::Level::DEBUG);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove("test_thread_pool.log");
+    }
+};
+
+TEST_F(ThreadPoolTest, RunsEverySubmittedTask) {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.getThreadCount(), 4u);
+
+    std::atomic<int> sum(0);
+    for (int i = 1; i <= 1000; ++i) {
+        pool.submit([&sum, i]() { sum += i; });
+    }
+    pool.wait();
+
+    EXPECT_EQ(sum.load(), 500500);
+    EXPECT_EQ(pool.getStats().tasks_executed, 1000u);
+
+    // The pool is reusable after wait()
+    pool.submit([&sum]() { sum = 0; });
+    pool.wait();
+    EXPECT_EQ(sum.load(), 0);
+}
+
+TEST_F(ThreadPoolTest, TasksCanSubmitSubtasks) {
+    ThreadPool pool(3);
+    std::atomic<int> leaves(0);
+
+    for (int i = 0; i < 10; ++i) {
+        pool.submit([&pool, &leaves]() {
+            for (int j = 0; j < 10; ++j) {
+                pool.submit([&leaves]() { leaves++; });
+            }
+        });
+    }
+    pool.wait();
+
+    EXPECT_EQ(leaves.load(), 100);
+    EXPECT_EQ(pool.getStats().tasks_executed, 110u);
+}
+
+TEST_F(ThreadPoolTest, IdleWorkersStealFromBlockedWorker) {
+    ThreadPool pool(4);
+    std::atomic<bool> release(false);
+    std::atomic<int> done(0);
+
+    // One task blocks its worker; the tasks queued behind it on the same
+    // deque must still run
+    pool.submit([&release]() {
+        while (!release) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    for (int i = 0; i < 200; ++i) {
+        pool.submit([&done]() { done++; });
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (done < 200 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(done.load(), 200);
+    EXPECT_GT(pool.getStats().tasks_stolen, 0u);
+
+    release = true;
+    pool.wait();
+}
+
+TEST_F(ThreadPoolTest, ThrowingTaskDoesNotKillWorker) {
+    ThreadPool pool(1);
+    std::atomic<int> ran(0);
+
+    pool.submit([]() { throw std::runtime_error("task failure"); });
+    pool.submit([&ran]() { ran++; });
+    pool.wait();
+
+    EXPECT_EQ(ran.load(), 1);
+    EXPECT_EQ(pool.getStats().tasks_executed, 2u);
+}
+
+TEST_F(ThreadPoolTest, UnevenTaskCostThroughput) {
+    // Every 16th task is 50x more expensive, like a chunk dense with signatures
+    const size_t num_threads = 4;
+    const int num_tasks = 256;
+    auto work = [](int units) {
+        volatile uint64_t x = 0;
+        for (int i = 0; i < units * 20000; ++i) {
+            x = x + i;
+        }
+    };
+
+    ThreadPool pool(num_threads);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_tasks; ++i) {
+        int units = (i % 16 == 0) ? 50 : 1;
+        pool.submit([&work, units]() { work(units); });
+    }
+    pool.wait();
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    ThreadPoolStats stats = pool.getStats();
+    std::cout << "Uneven tasks: " << num_tasks << " in " << elapsed << " ms on " << num_threads
+              << " workers, " << stats.tasks_stolen << " stolen" << std::endl;
+    EXPECT_EQ(stats.tasks_executed, static_cast<size_t>(num_tasks));
+}
+
+TEST_F(ThreadPoolTest, PinnedWorkersRunTheirNodesTasks) {
+    std::vector<NumaNode> nodes = CpuTopology::detectNodes();
+    ASSERT_FALSE(nodes.empty());
+    ASSERT_FALSE(nodes[0].cpus.empty());
+    
+    // Two workers per node, each pinned to one core of it
+    std::vector<WorkerPlacement> placement;
+    for (const auto& node : nodes) {
+        for (size_t i = 0; i < 2; ++i) {
+            WorkerPlacement worker;
+            worker.node = node.id;
+            worker.cpus.push_back(node.cpus[i % node.cpus.size()]);
+            placement.push_back(worker);
+        }
+    }
+    ThreadPool pool(placement);
+    EXPECT_EQ(pool.getThreadCount(), placement.size());
+    EXPECT_EQ(ThreadPool::currentNode(), -1);
+    
+    std::atomic<int> on_node(0);
+    std::atomic<int> pinned(0);
+    int node = nodes[0].id;
+    for (int i = 0; i < 100; ++i) {
+        pool.submit([&on_node, &pinned, node, &nodes]() {
+            if (ThreadPool::currentNode() == node) {
+                on_node++;
+            }
+            int cpu = sched_getcpu();
+            if (std::find(nodes[0].cpus.begin(), nodes[0].cpus.end(), cpu) != nodes[0].cpus.end()) {
+                pinned++;
+            }
+        }, node);
+    }
+    pool.wait();
+    
+    // Same-node workers are preferred when stealing; with a single node
+    // nothing else exists to run them
+    if (nodes.size() == 1) {
+        EXPECT_EQ(on_node.load(), 100);
+        EXPECT_EQ(pinned.load(), 100);
+    } else {
+        EXPECT_GT(on_node.load(), 0);
+    }
+}
+
+TEST_F(ThreadPoolTest, ParseCpuList) {
+    EXPECT_EQ(CpuTopology::parseCpuList("0-3,8,10-11\n"), (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_EQ(CpuTopology::parseCpuList("5"), (std::vector<int>{5}));
+    EXPECT_EQ(CpuTopology::parseCpuList("2,1,1-2"), (std::vector<int>{1, 2}));
+    EXPECT_TRUE(CpuTopology::parseCpuList("").empty());
+}
+
+TEST_F(ThreadPoolTest, TaskGroupWaitsOnlyForItsOwnTasks) {
+    ThreadPool pool(2);
+    TaskGroup slow(pool);
+    TaskGroup fast(pool);
+
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    slow.submit([released]() { released.wait(); });
+
+    std::atomic<int> done(0);
+    for (int i = 0; i < 10; ++i) {
+        fast.submit([&done]() { done++; });
+    }
+    fast.wait();
+    EXPECT_EQ(done.load(), 10);
+    EXPECT_EQ(fast.getExecutedCount(), 10u);
+    EXPECT_EQ(slow.getExecutedCount(), 0u);
+
+    release.set_value();
+    slow.wait();
+    EXPECT_EQ(slow.getExecutedCount(), 1u);
+}
+
+TEST_F(ThreadPoolTest, FairQueueAlternatesBetweenClients) {
+    ThreadPool pool(1);
+    auto queue = std::make_shared<FairTaskQueue>(pool, 1);
+    TaskGroup first(pool, queue);
+    TaskGroup second(pool, queue);
+
+    // Hold the only worker until both clients have queued everything
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    first.submit([released]() { released.wait(); });
+
+    std::mutex order_mutex;
+    std::vector<int> order;
+    for (int i = 0; i < 5; ++i) {
+        first.submit([&]() { std::lock_guard<std::mutex> lock(order_mutex); order.push_back(1); });
+    }
+    for (int i = 0; i < 5; ++i) {
+        second.submit([&]() { std::lock_guard<std::mutex> lock(order_mutex); order.push_back(2); });
+    }
+    release.set_value();
+    first.wait();
+    second.wait();
+
+    // The client that queued all its tasks first does not get to run them back to back
+    EXPECT_EQ(order, std::vector<int>({2, 1, 2, 1, 2, 1, 2, 1, 2, 1}));
+}